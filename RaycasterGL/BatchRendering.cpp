@@ -0,0 +1,191 @@
+// BatchRendering.cpp
+// RenderRaycastBatch: many camera poses rendered headless in one call, a view per worker.
+#include "RendererContext.h"
+#include <algorithm>
+#include <math.h>
+
+// --- Batch Rendering ---
+
+// Depth and cell of every pixel of one view, from its hits. Columns go a tile at a time, so either
+// layout is written in its own order.
+static void WriteBatchDepth(RendererContext& ctx, const RaycastBatchOutput& output, const RaycastHit* hits, int mapWidth, size_t viewOffset) {
+    const int width = output.width;
+    const int height = output.height;
+    const float* planeDepth = ctx.batchPlaneDepth.data();
+    for (int tileBegin = 0; tileBegin < width; tileBegin += kRaycastTileColumns) {
+        const int tileEnd = std::min(tileBegin + kRaycastTileColumns, width);
+        int top[kRaycastTileColumns], bottom[kRaycastTileColumns];
+        float wallDepth[kRaycastTileColumns];
+        int32_t wallCell[kRaycastTileColumns];
+        for (int x = tileBegin; x < tileEnd; ++x) {
+            const RaycastHit& hit = hits[x];
+            const int i = x - tileBegin;
+            top[i] = (hit.cell != 0) ? hit.drawStart : height;
+            bottom[i] = (hit.cell != 0) ? hit.drawEnd : -1;
+            wallDepth[i] = hit.perpDist;
+            wallCell[i] = (int32_t)((int64_t)hit.mapY * mapWidth + hit.mapX); // Only output if the IDs fit
+        }
+        // Pixel (x, y) shows the wall of its column on rows top..bottom, the floor or ceiling elsewhere
+        auto writePlane = [&](auto* out, const auto* wallValue, auto planeValue) {
+            if (out == nullptr) {
+                return;
+            }
+            if (output.layout == RAYCAST_BATCH_ROW_MAJOR) {
+                for (int y = 0; y < height; ++y) {
+                    auto* row = out + viewOffset + (size_t)y * width;
+                    for (int x = tileBegin; x < tileEnd; ++x) {
+                        const int i = x - tileBegin;
+                        row[x] = (y >= top[i] && y <= bottom[i]) ? wallValue[i] : planeValue(y);
+                    }
+                }
+                return;
+            }
+            for (int x = tileBegin; x < tileEnd; ++x) {
+                const int i = x - tileBegin;
+                auto* column = out + viewOffset + (size_t)x * height;
+                const int wallBegin = std::min(top[i], height);
+                const int wallEnd = std::max(bottom[i] + 1, wallBegin);
+                for (int y = 0; y < wallBegin; ++y) column[y] = planeValue(y);
+                std::fill(column + wallBegin, column + wallEnd, wallValue[i]);
+                for (int y = wallEnd; y < height; ++y) column[y] = planeValue(y);
+            }
+        };
+        writePlane(output.depth, wallDepth, [planeDepth](int y) { return planeDepth[y]; });
+        writePlane(output.cells, wallCell, [](int) { return (int32_t)-1; });
+    }
+}
+
+template <typename MapView>
+static int RenderBatchViews(RendererContext& ctx, const MapView& view, const RaycastCamera* cameras, int viewCount, const RaycastPalette* palette,
+    const RaycastBatchOutput* output) {
+    if (cameras == nullptr || viewCount <= 0 || output == nullptr) {
+        return 0;
+    }
+    const int width = output->width;
+    const int height = output->height;
+    if (width <= 0 || height <= 0 || (output->rgba == nullptr && output->depth == nullptr && output->cells == nullptr)) {
+        TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastBatch called without a resolution or any output");
+        return 0;
+    }
+    if (output->cells != nullptr && !HasInt32CellIds(view.width, view.height)) {
+        TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastBatch cannot output cell IDs of a %dx%d map, they exceed int32", view.width, view.height);
+        return 0;
+    }
+    for (int i = 0; i < viewCount; ++i) {
+        if (!IsUsableCameraPose(cameras[i])) {
+            TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastBatch camera %d has a non-finite or out-of-range pose", i);
+            return 0;
+        }
+    }
+    if (palette == nullptr) {
+        palette = &g_defaultPalette;
+    }
+
+    const auto start = FrameProfiler::Clock::now();
+    const Lightmap* lightmap = nullptr;
+    if (output->rgba != nullptr && ctx.lightmap.IsEnabled()) {
+        UpdateLightmap(ctx, view);
+        lightmap = &ctx.lightmap;
+    }
+    const TextureSlot* ceilingTexture = FindTexture(ctx, palette->ceilingTexture);
+    const TextureSlot* floorTexture = FindTexture(ctx, palette->floorTexture);
+    const bool castCeiling = ceilingTexture != nullptr || lightmap != nullptr;
+    const bool castFloor = floorTexture != nullptr || lightmap != nullptr;
+    const bool opaque = IsOpaqueRaycastPalette(*palette, !castCeiling, !castFloor);
+    if (opaque) BuildWallColorTable(*palette, ctx.wallColorTable);
+    const Color* wallColors = opaque ? ctx.wallColorTable.data() : nullptr;
+
+    // Same rows as CastPlaneRows: a pixel centre p rows from the horizon sees the plane at 0.5 * height / p
+    const int halfHeight = height / 2;
+    ctx.batchPlaneDepth.resize(height);
+    for (int y = 0; y < height; ++y) {
+        const float p = (y >= halfHeight) ? (float)(y - halfHeight) + 0.5f : (float)(halfHeight - y) - 0.5f;
+        ctx.batchPlaneDepth[y] = 0.5f * (float)height / p;
+    }
+    const bool rowMajor = output->layout == RAYCAST_BATCH_ROW_MAJOR;
+    if ((int)ctx.batchScratch.size() < ctx.workerPool.GetWorkerCount()) {
+        ctx.batchScratch.resize(ctx.workerPool.GetWorkerCount());
+    }
+    for (BatchScratch& scratch : ctx.batchScratch) {
+        if ((int)scratch.hits.size() < width) scratch.hits.resize(width);
+        if (output->rgba != nullptr && !rowMajor) scratch.pixels.resize((size_t)width * height);
+        scratch.ddaSteps = 0;
+    }
+
+    // One view per worker at a time; each view is drawn serially, start to finish
+    const size_t pixelCount = (size_t)width * height;
+    auto renderViews = [&](int begin, int end, int worker) {
+        BatchScratch& scratch = ctx.batchScratch[worker];
+        RaycastHit* hits = scratch.hits.data();
+        for (int i = begin; i < end; ++i) {
+            UpdateCameraRayTable(scratch.rays, width, cameras[i].fov);
+            const CameraRaySetup setup = MakeCameraRaySetup(cameras[i], scratch.rays, height);
+            CastCameraColumns(view, setup, 0, width, hits);
+            for (int x = 0; x < width; ++x) scratch.ddaSteps += hits[x].steps;
+
+            if (output->rgba != nullptr) {
+                uint8_t* rgba = output->rgba + (size_t)i * pixelCount * 4;
+                SoftwareTarget target;
+                target.pixels = rowMajor ? (Color*)rgba : scratch.pixels.data();
+                target.width = width;
+                target.height = height;
+                // Translucent colors blend over black, as over a cleared frame
+                if (wallColors == nullptr) SwClear(target, BLACK);
+                CastPlaneRows(setup, *palette, ceilingTexture, floorTexture, lightmap, target.pixels,
+                    castCeiling ? 0 : halfHeight, castFloor ? height : halfHeight);
+                RasterizeRaycastColumns(target, setup, *palette, wallColors, hits, lightmap, castCeiling, castFloor, 0, width);
+                if (!rowMajor) SwReadPlanar(target, rgba);
+            }
+            WriteBatchDepth(ctx, *output, hits, view.width, (size_t)i * pixelCount);
+        }
+    };
+    ctx.workerPool.ParallelFor(viewCount, 1, renderViews);
+
+    RaycastBatchStats stats = {};
+    stats.viewCount = viewCount;
+    stats.width = width;
+    stats.height = height;
+    stats.batchMs = std::chrono::duration<float, std::milli>(FrameProfiler::Clock::now() - start).count();
+    stats.viewsPerSecond = (stats.batchMs > 0.0f) ? 1000.0f * (float)viewCount / stats.batchMs : 0.0f;
+    for (const BatchScratch& scratch : ctx.batchScratch) stats.ddaSteps += scratch.ddaSteps;
+    ctx.batchStats = stats;
+    return viewCount;
+}
+
+int RenderRaycastBatch(const uint8_t* map, int mapW, int mapH, const RaycastCamera* cameras, int viewCount,
+    const RaycastPalette* palette, const RaycastBatchOutput* output) {
+    RendererContext& ctx = CurrentContext();
+    if (map == nullptr || mapW <= 0 || mapH <= 0) {
+        TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastBatch called with an empty map");
+        return 0;
+    }
+    // The pool and the lightmap belong to the thread that renders
+    int rendered = 0;
+    auto render = [&] {
+        RaycastMapView view;
+        view.cells = map;
+        view.width = mapW;
+        view.height = mapH;
+        rendered = RenderBatchViews(ctx, view, cameras, viewCount, palette, output);
+    };
+    ctx.renderThread.RunOnThread(render);
+    return rendered;
+}
+
+int RenderRaycastBatch(const RaycastCamera* cameras, int viewCount, const RaycastPalette* palette, const RaycastBatchOutput* output) {
+    RendererContext& ctx = CurrentContext();
+    if (!ctx.loadedMap.IsLoaded()) {
+        TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastBatch called without a loaded map");
+        return 0;
+    }
+    int rendered = 0;
+    auto render = [&] { rendered = RenderBatchViews(ctx, ctx.loadedMap.GetView(), cameras, viewCount, palette, output); };
+    ctx.renderThread.RunOnThread(render);
+    return rendered;
+}
+
+RaycastBatchStats GetRaycastBatchStats() {
+    RendererContext& ctx = CurrentContext();
+    ctx.renderThread.WaitIdle();
+    return ctx.batchStats;
+}
@@ -0,0 +1,84 @@
+// CommandRecording.cpp
+// Render thread side of pipelined submission: replays the frames the caller recorded.
+#include "RendererContext.h"
+
+// --- Pipelined Submission ---
+
+// Render thread: runs a recorded frame through the same entry points the caller used. The render
+// thread is bound to its context, so those act on it.
+void ReplayFrame(const CommandBuffer& buffer, void* context) {
+    RendererContext& ctx = *(RendererContext*)context;
+    for (const RecordedCommand& command : buffer.commands) {
+        switch (command.opcode) {
+        case REC_BEGIN_FRAME: {
+            const RecBeginFrame& begin = *(const RecBeginFrame*)command.payload;
+            BeginFrameAtScale(ctx, begin.renderScale);
+            ctx.frameStats.waitMs = begin.waitMs;
+            break;
+        }
+        case REC_END_FRAME:
+            PresentFrame(ctx, ((const RecEndFrame*)command.payload)->inputTime);
+            PublishInputState(ctx);
+            break;
+        case REC_WALL_SLICE: {
+            const RecShape& slice = *(const RecShape*)command.payload;
+            DrawWallSlice(slice.a, slice.b, slice.c, slice.color);
+            break;
+        }
+        case REC_TEXTURED_SLICE: {
+            const RecTexturedSlice& slice = *(const RecTexturedSlice*)command.payload;
+            DrawTexturedWallSlice(slice.screenX, slice.drawStartY, slice.drawEndY, slice.drawWidth, slice.textureId, slice.texCoordX, slice.tint);
+            break;
+        }
+        case REC_SPRITE: {
+            const RecSprite& sprite = *(const RecSprite*)command.payload;
+            DrawSprite(sprite.textureId, sprite.sourceRec, sprite.destRec, sprite.origin, sprite.rotation, sprite.tint);
+            break;
+        }
+        case REC_RECT: {
+            const RecShape& rect = *(const RecShape*)command.payload;
+            DrawScreenRectangle(rect.a, rect.b, rect.c, rect.d, rect.color);
+            break;
+        }
+        case REC_LINE: {
+            const RecShape& line = *(const RecShape*)command.payload;
+            DrawScreenLine(line.a, line.b, line.c, line.d, line.color);
+            break;
+        }
+        case REC_TEXT: {
+            const RecText& text = *(const RecText*)command.payload;
+            DrawScreenText(text.text, text.posX, text.posY, text.fontSize, text.color);
+            break;
+        }
+        case REC_DRAW_COMMANDS: {
+            const RecDrawCommands& table = *(const RecDrawCommands*)command.payload;
+            SubmitDrawCommands(table.data, table.commandCount, table.fieldCount, (size_t)table.fieldCount, 1);
+            break;
+        }
+        case REC_RAYCAST: {
+            const RecRaycast& raycast = *(const RecRaycast*)command.payload;
+            const RaycastPalette* palette = raycast.hasPalette ? &raycast.palette : nullptr;
+            if (raycast.map != nullptr) RenderRaycastFrame(raycast.map, raycast.mapW, raycast.mapH, raycast.camera, palette);
+            else RenderRaycastFrame(raycast.camera, palette);
+            break;
+        }
+        case REC_RAYCAST_SPRITES: {
+            const RecRaycastSprites& sprites = *(const RecRaycastSprites*)command.payload;
+            DrawRaycastSprites(sprites.sprites, sprites.spriteCount);
+            break;
+        }
+        case REC_LIGHTING: {
+            const RecLighting& lighting = *(const RecLighting*)command.payload;
+            SetRaycastLighting(lighting.enabled, lighting.ambient);
+            break;
+        }
+        case REC_LIGHTS: {
+            const RecLights& lights = *(const RecLights*)command.payload;
+            SetRaycastLights(lights.lights, lights.count);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
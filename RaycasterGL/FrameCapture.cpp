@@ -0,0 +1,190 @@
+// FrameCapture.cpp
+#define _CRT_SECURE_NO_WARNINGS // fopen: SDL checks reject it otherwise, and fopen_s is MSVC only
+#include "FrameCapture.h"
+#include <algorithm>
+#include <chrono>
+
+FrameCapture::~FrameCapture() {
+    Stop();
+}
+
+bool FrameCapture::Start(const char* filePath, FrameCaptureFormat format, int width, int height, int ringFrames, int fps) {
+    Stop();
+    if (filePath == nullptr || width <= 0 || height <= 0 || ringFrames <= 0 || fps <= 0) {
+        return false;
+    }
+    FILE* file = fopen(filePath, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    if (format == FRAME_CAPTURE_Y4M) {
+        // 4:2:0 with chroma sited between the luma samples it averages
+        if (fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps) < 0) {
+            fclose(file);
+            return false;
+        }
+    }
+
+    m_file = file;
+    m_format = format;
+    m_width = width;
+    m_height = height;
+    m_frameBytes = (size_t)width * height * 4;
+    m_ring.resize(m_frameBytes * ringFrames);
+    if (format == FRAME_CAPTURE_Y4M) {
+        const size_t chroma = (size_t)((width + 1) / 2) * ((height + 1) / 2);
+        m_planes.resize((size_t)width * height + 2 * chroma);
+    }
+    else {
+        m_planes.clear();
+    }
+    m_slotCount = ringFrames;
+    m_head = 0;
+    m_tail = 0;
+    m_queued = 0;
+    m_stopping = false;
+    m_failed = false;
+    m_written = 0;
+    m_dropped = 0;
+    m_bytesWritten = 0;
+    m_writeMs = 0.0f;
+    m_thread = std::thread(&FrameCapture::ThreadMain, this);
+    return true;
+}
+
+void FrameCapture::Stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+    fclose(m_file);
+    m_file = nullptr;
+    m_ring.clear();
+    m_ring.shrink_to_fit();
+    m_planes.clear();
+    m_planes.shrink_to_fit();
+}
+
+uint8_t* FrameCapture::BeginFrame() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_failed || m_queued == m_slotCount) {
+        ++m_dropped;
+        return nullptr;
+    }
+    // Slots [m_tail, m_tail + m_queued) belong to the writer, so m_head is free
+    return m_ring.data() + (size_t)m_head * m_frameBytes;
+}
+
+void FrameCapture::CommitFrame() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_head = (m_head + 1) % m_slotCount;
+        ++m_queued;
+    }
+    m_wake.notify_one();
+}
+
+FrameCaptureStats FrameCapture::GetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FrameCaptureStats stats = {};
+    stats.active = m_thread.joinable() && !m_stopping;
+    stats.format = m_format;
+    stats.width = m_width;
+    stats.height = m_height;
+    stats.ringFrames = m_slotCount;
+    stats.queuedFrames = m_queued;
+    stats.framesWritten = m_written;
+    stats.framesDropped = m_dropped;
+    stats.bytesWritten = m_bytesWritten;
+    stats.writeMs = m_writeMs;
+    stats.writeFailed = m_failed;
+    return stats;
+}
+
+void FrameCapture::ThreadMain() {
+    for (;;) {
+        const uint8_t* slot;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || m_queued > 0; });
+            if (m_queued == 0) {
+                return; // Stopping, and every frame is on disk
+            }
+            slot = m_ring.data() + (size_t)m_tail * m_frameBytes;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool ok = !m_failed && WriteFrame(slot);
+        const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tail = (m_tail + 1) % m_slotCount;
+        --m_queued;
+        if (ok) {
+            ++m_written;
+            m_bytesWritten += (m_format == FRAME_CAPTURE_Y4M) ? 6 + m_planes.size() : m_frameBytes;
+            m_writeMs = ms;
+        }
+        else {
+            if (!m_failed) TraceLog(LOG_WARNING, "RENDER DLL: Frame capture stopped writing: the file cannot be written");
+            m_failed = true;
+            ++m_dropped;
+        }
+    }
+}
+
+bool FrameCapture::WriteFrame(const uint8_t* rgba) {
+    if (m_format == FRAME_CAPTURE_RAW) {
+        return fwrite(rgba, 1, m_frameBytes, m_file) == m_frameBytes;
+    }
+    ConvertToYuv420(rgba);
+    return fwrite("FRAME\n", 1, 6, m_file) == 6 && fwrite(m_planes.data(), 1, m_planes.size(), m_file) == m_planes.size();
+}
+
+// BT.601 studio range in 8-bit fixed point: Y in [16, 235], Cb and Cr in [16, 240]
+static inline uint8_t LumaOf(int r, int g, int b) {
+    return (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+void FrameCapture::ConvertToYuv420(const uint8_t* rgba) {
+    const int width = m_width;
+    const int height = m_height;
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+    uint8_t* lumaPlane = m_planes.data();
+    uint8_t* cbPlane = lumaPlane + (size_t)width * height;
+    uint8_t* crPlane = cbPlane + (size_t)chromaWidth * chromaHeight;
+
+    for (int cy = 0; cy < chromaHeight; ++cy) {
+        // An odd last row or column pairs with itself
+        const int y0 = 2 * cy;
+        const int y1 = std::min(y0 + 1, height - 1);
+        const uint8_t* row0 = rgba + (size_t)y0 * width * 4;
+        const uint8_t* row1 = rgba + (size_t)y1 * width * 4;
+        uint8_t* luma0 = lumaPlane + (size_t)y0 * width;
+        uint8_t* luma1 = lumaPlane + (size_t)y1 * width;
+        for (int cx = 0; cx < chromaWidth; ++cx) {
+            const int x0 = 2 * cx;
+            const int x1 = std::min(x0 + 1, width - 1);
+            const uint8_t* p00 = row0 + x0 * 4;
+            const uint8_t* p01 = row0 + x1 * 4;
+            const uint8_t* p10 = row1 + x0 * 4;
+            const uint8_t* p11 = row1 + x1 * 4;
+            luma0[x0] = LumaOf(p00[0], p00[1], p00[2]);
+            luma0[x1] = LumaOf(p01[0], p01[1], p01[2]);
+            luma1[x0] = LumaOf(p10[0], p10[1], p10[2]);
+            luma1[x1] = LumaOf(p11[0], p11[1], p11[2]);
+            // Chroma of the 2 x 2 block's average color (the sums are 4x, hence >> 10)
+            const int r = p00[0] + p01[0] + p10[0] + p11[0];
+            const int g = p00[1] + p01[1] + p10[1] + p11[1];
+            const int b = p00[2] + p01[2] + p10[2] + p11[2];
+            cbPlane[(size_t)cy * chromaWidth + cx] = (uint8_t)(((-38 * r - 74 * g + 112 * b + 512) >> 10) + 128);
+            crPlane[(size_t)cy * chromaWidth + cx] = (uint8_t)(((112 * r - 94 * g - 18 * b + 512) >> 10) + 128);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+// FrameCapture.h
+// Internal recorder behind StartFrameCapture. The thread that presents frames copies each one into a
+// ring of slots allocated when the capture starts; a writer thread converts and streams the slots to
+// disk in order. A frame that finds every slot still waiting to be written is dropped, so a slow disk
+// costs frames but never blocks rendering, and memory stays at ringFrames frames whatever happens.
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include "RaycasterEngine.h"
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+class FrameCapture {
+public:
+    FrameCapture() = default;
+    ~FrameCapture();
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Creates filePath, writes the stream header and starts the writer thread, stopping any previous
+    // capture first. Frames are width x height RGBA8, top row first.
+    bool Start(const char* filePath, FrameCaptureFormat format, int width, int height, int ringFrames, int fps);
+    // Writes the frames still in the ring, then closes the file. The counters are kept until the next Start.
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Producer side, one thread only: a free slot of width * height * 4 bytes to copy the frame into,
+    // or null if the ring is full (the frame is counted as dropped). CommitFrame queues the slot.
+    uint8_t* BeginFrame();
+    void CommitFrame();
+
+    FrameCaptureStats GetStats();
+
+private:
+    void ThreadMain();
+    // Converts and writes one slot; false once the file cannot be written
+    bool WriteFrame(const uint8_t* rgba);
+    // Full-range RGBA to 4:2:0 studio-range BT.601 planes in m_planes
+    void ConvertToYuv420(const uint8_t* rgba);
+
+    std::thread m_thread;
+    FILE* m_file = nullptr;
+    FrameCaptureFormat m_format = FRAME_CAPTURE_Y4M;
+    int m_width = 0;
+    int m_height = 0;
+    size_t m_frameBytes = 0;           // One slot
+    std::vector<uint8_t> m_ring;       // ringFrames slots of m_frameBytes
+    std::vector<uint8_t> m_planes;     // Writer thread: Y, Cb and Cr planes of the frame being written
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;    // Writer thread: a frame was queued or stopping
+    int m_slotCount = 0;
+    int m_head = 0;                    // Next slot the producer fills
+    int m_tail = 0;                    // Next slot the writer writes
+    int m_queued = 0;                  // Committed slots not written yet
+    bool m_stopping = false;
+    bool m_failed = false;             // A write failed; later frames are dropped
+    uint64_t m_written = 0;
+    uint64_t m_dropped = 0;
+    uint64_t m_bytesWritten = 0;
+    float m_writeMs = 0.0f;
+};
+
+#endif
@@ -0,0 +1,75 @@
+// FramePacer.cpp
+#include "FramePacer.h"
+#include <math.h>
+
+static const float kJitterSmoothing = 0.1f;  // Weight of the newest interval in presentJitterMs
+static const float kPredictionDecay = 0.05f; // Per frame, how fast the prediction follows shorter work
+
+void FramePacer::SetTarget(float targetFps, float pollMs) {
+    const bool on = targetFps > 0.0f && isfinite(targetFps);
+    m_targetFps = on ? targetFps : 0.0f;
+    m_period = on ? 1.0 / targetFps : 0.0;
+    m_pollMs = (pollMs > 0.0f && isfinite(pollMs)) ? pollMs : 0.0f;
+    m_scheduled = false;
+    m_jitterMs = 0.0f;
+}
+
+void FramePacer::Reset() {
+    *this = FramePacer();
+}
+
+double FramePacer::Presented(double now, double inputTime) {
+    if (m_lastPresent >= 0.0) {
+        m_intervalMs = (float)((now - m_lastPresent) * 1000.0);
+        if (m_period > 0.0) {
+            const float stray = fabsf(m_intervalMs - (float)(m_period * 1000.0));
+            m_jitterMs += (stray - m_jitterMs) * kJitterSmoothing;
+        }
+    }
+    m_lastPresent = now;
+    ++m_presented;
+    if (inputTime >= 0.0) {
+        m_inputLatencyMs = (float)((now - inputTime) * 1000.0);
+    }
+    // Longer work is believed at once, shorter work slowly, so one fast frame does not cost the next its slot
+    if (m_resumed >= 0.0) {
+        const float workMs = (float)((now - m_resumed) * 1000.0);
+        m_predictedMs = (workMs > m_predictedMs) ? workMs : m_predictedMs + (workMs - m_predictedMs) * kPredictionDecay;
+        m_resumed = -1.0;
+    }
+    if (m_period <= 0.0) {
+        return now;
+    }
+
+    if (m_scheduled) {
+        if (now > m_slot + 0.5 * m_period) ++m_missed;
+        m_slot += m_period;
+        if (m_slot <= now) {
+            m_slot = now + m_period; // Too far behind to catch up: start the schedule over
+        }
+    }
+    else {
+        m_slot = now + m_period;
+        m_scheduled = true;
+    }
+    const double start = m_slot - m_predictedMs / 1000.0;
+    return (start > now) ? start : now;
+}
+
+void FramePacer::Resumed(double now, float waitMs) {
+    m_resumed = now;
+    m_waitMs = waitMs;
+}
+
+void FramePacer::GetStats(FramePacingStats& stats) const {
+    stats.targetFps = m_targetFps;
+    stats.pollMs = m_pollMs;
+    stats.framesPresented = m_presented;
+    stats.lastPresentTime = m_lastPresent;
+    stats.presentIntervalMs = m_intervalMs;
+    stats.presentJitterMs = m_jitterMs;
+    stats.missedSlots = m_missed;
+    stats.predictedWorkMs = m_predictedMs;
+    stats.waitMs = m_waitMs;
+    stats.inputLatencyMs = m_inputLatencyMs;
+}
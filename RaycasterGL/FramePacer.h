@@ -0,0 +1,46 @@
+// FramePacer.h
+// Internal scheduler behind SetFramePacing. Fed the time every present finishes, it books the next
+// present one period later and says when the caller should get control back: early enough for the
+// next frame's work, as predicted from the frames before, to finish on that slot. It also keeps the
+// present timing for FramePacingStats. Not thread-safe: the engine guards it.
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "RaycasterEngine.h"
+#include <stdint.h>
+
+class FramePacer {
+public:
+    // targetFps <= 0 turns pacing off. Either way the schedule starts over at the next present.
+    void SetTarget(float targetFps, float pollMs);
+    float GetPollMs() const { return m_pollMs; }
+    // Forgets the schedule, the prediction and the counters, and turns pacing off.
+    void Reset();
+
+    // A present finished at 'now' (seconds). inputTime is the time of the oldest input event the
+    // frame was built from, or < 0. Returns when the next frame should start: 'now' with pacing off.
+    double Presented(double now, double inputTime);
+    // The caller got control back at 'now' after waiting waitMs.
+    void Resumed(double now, float waitMs);
+
+    // Everything but the input ring counters.
+    void GetStats(FramePacingStats& stats) const;
+
+private:
+    float m_targetFps = 0.0f;
+    float m_pollMs = 0.0f;
+    double m_period = 0.0;        // Seconds, 0 while pacing is off
+    double m_slot = 0.0;          // When the next present is due, valid while m_scheduled
+    bool m_scheduled = false;
+    double m_lastPresent = -1.0;  // < 0 before the first present
+    double m_resumed = -1.0;      // When the work of the frame being built began, < 0 if unknown
+    float m_predictedMs = 0.0f;
+    uint64_t m_presented = 0;
+    uint64_t m_missed = 0;
+    float m_intervalMs = 0.0f;
+    float m_jitterMs = 0.0f;
+    float m_waitMs = 0.0f;
+    float m_inputLatencyMs = -1.0f;
+};
+
+#endif
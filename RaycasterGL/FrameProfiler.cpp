@@ -0,0 +1,156 @@
+// FrameProfiler.cpp
+#define _CRT_SECURE_NO_WARNINGS // fopen: SDL checks reject it otherwise, and fopen_s is MSVC only
+#include "FrameProfiler.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* const kStageNames[PROFILE_STAGE_COUNT] = {
+    "begin", "lighting", "floor", "raycast", "walls", "sprites", "text", "commands", "upscale", "present"
+};
+
+static float* StageField(RendererStats& stats, int stage) {
+    switch (stage) {
+    case PROFILE_STAGE_BEGIN: return &stats.beginMs;
+    case PROFILE_STAGE_LIGHTING: return &stats.lightingMs;
+    case PROFILE_STAGE_FLOOR: return &stats.floorMs;
+    case PROFILE_STAGE_RAYCAST: return &stats.raycastMs;
+    case PROFILE_STAGE_WALLS: return &stats.wallMs;
+    case PROFILE_STAGE_SPRITES: return &stats.spritesMs;
+    case PROFILE_STAGE_TEXT: return &stats.textMs;
+    case PROFILE_STAGE_COMMANDS: return &stats.commandsMs;
+    case PROFILE_STAGE_UPSCALE: return &stats.upscaleMs;
+    default: return &stats.presentMs;
+    }
+}
+
+void FrameProfiler::Reset() {
+    for (Slot& slot : m_slots) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+    m_publishedFrames.store(0, std::memory_order_release);
+    m_epoch = Clock::now();
+    m_current = FrameRecord{};
+}
+
+void FrameProfiler::BeginFrame() {
+    m_frameStart = Clock::now();
+    m_current.startUs = std::chrono::duration<double, std::micro>(m_frameStart - m_epoch).count();
+    m_current.spanCount = 0;
+    for (float& ms : m_stageMs) ms = 0.0f;
+}
+
+void FrameProfiler::EndStage(ProfileStage stage, Clock::time_point start) {
+    const Clock::time_point end = Clock::now();
+    m_stageMs[stage] += std::chrono::duration<float, std::milli>(end - start).count();
+
+    const float startUs = std::chrono::duration<float, std::micro>(start - m_frameStart).count();
+    const float endUs = std::chrono::duration<float, std::micro>(end - m_frameStart).count();
+    if (m_current.spanCount > 0 && m_current.spans[m_current.spanCount - 1].stage == stage) {
+        Span& last = m_current.spans[m_current.spanCount - 1];
+        last.durationUs = endUs - last.startUs;
+    }
+    else if (m_current.spanCount < kMaxFrameSpans) {
+        m_current.spans[m_current.spanCount++] = Span{ startUs, endUs - startUs, stage };
+    }
+}
+
+void FrameProfiler::EndFrame(RendererStats& stats) {
+    const uint64_t frameIndex = m_publishedFrames.load(std::memory_order_relaxed) + 1;
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; ++stage) {
+        *StageField(stats, stage) = m_stageMs[stage];
+    }
+    stats.frameIndex = frameIndex;
+    stats.frameMs = std::chrono::duration<float, std::milli>(Clock::now() - m_frameStart).count();
+    m_current.stats = stats;
+
+    Slot& slot = m_slots[(frameIndex - 1) % RENDERER_STATS_HISTORY];
+    const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    uint32_t words[kRecordWords] = {};
+    memcpy(words, &m_current, sizeof(FrameRecord));
+    for (int i = 0; i < kRecordWords; ++i) {
+        std::atomic_ref<uint32_t>(slot.words[i]).store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    m_publishedFrames.store(frameIndex, std::memory_order_release);
+}
+
+bool FrameProfiler::ReadFrame(uint64_t frameIndex, FrameRecord& out) const {
+    const Slot& slot = m_slots[(frameIndex - 1) % RENDERER_STATS_HISTORY];
+    const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+    uint32_t words[kRecordWords];
+    for (int i = 0; i < kRecordWords; ++i) {
+        words[i] = std::atomic_ref<uint32_t>(const_cast<uint32_t&>(slot.words[i])).load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    memcpy(&out, words, sizeof(FrameRecord));
+    const uint32_t after = slot.sequence.load(std::memory_order_relaxed);
+    return before == after && out.stats.frameIndex == frameIndex;
+}
+
+bool FrameProfiler::GetLatest(RendererStats& out) const {
+    const uint64_t published = m_publishedFrames.load(std::memory_order_acquire);
+    FrameRecord record;
+    if (published == 0 || !ReadFrame(published, record)) {
+        return false;
+    }
+    out = record.stats;
+    return true;
+}
+
+int FrameProfiler::GetHistory(RendererStats* out, int maxFrames) const {
+    if (out == nullptr || maxFrames <= 0) {
+        return 0;
+    }
+    const uint64_t published = m_publishedFrames.load(std::memory_order_acquire);
+    const uint64_t available = (published < RENDERER_STATS_HISTORY) ? published : RENDERER_STATS_HISTORY;
+    const uint64_t count = ((uint64_t)maxFrames < available) ? (uint64_t)maxFrames : available;
+    // Frames the render thread overwrites while we copy are skipped
+    int written = 0;
+    FrameRecord record;
+    for (uint64_t frame = published - count + 1; frame <= published; ++frame) {
+        if (ReadFrame(frame, record)) {
+            out[written++] = record.stats;
+        }
+    }
+    return written;
+}
+
+bool FrameProfiler::WriteChromeTrace(const char* filePath) const {
+    FILE* file = (filePath != nullptr) ? fopen(filePath, "w") : nullptr;
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"RaycasterGL\"}}");
+
+    const uint64_t published = m_publishedFrames.load(std::memory_order_acquire);
+    const uint64_t first = (published > RENDERER_STATS_HISTORY) ? published - RENDERER_STATS_HISTORY + 1 : 1;
+    FrameRecord record;
+    for (uint64_t frame = first; frame <= published; ++frame) {
+        if (!ReadFrame(frame, record)) {
+            continue;
+        }
+        const RendererStats& stats = record.stats;
+        fprintf(file, ",\n{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frameIndex\":%llu}}",
+            record.startUs, stats.frameMs * 1000.0, (unsigned long long)stats.frameIndex);
+        for (int i = 0; i < record.spanCount; ++i) {
+            const Span& span = record.spans[i];
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"stage\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                kStageNames[span.stage], record.startUs + span.startUs, (double)span.durationUs);
+        }
+        fprintf(file, ",\n{\"name\":\"draws\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"drawCalls\":%d,\"textureBinds\":%d,\"batchedQuads\":%d}}",
+            record.startUs, stats.drawCalls, stats.textureBinds, stats.batchedQuads);
+        fprintf(file, ",\n{\"name\":\"work\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"ddaSteps\":%lld,\"raysCast\":%d,\"raysReused\":%d,\"textureLookups\":%lld,\"spritesDrawn\":%d,\"lightChunksRelit\":%d}}",
+            record.startUs, stats.ddaSteps, stats.raysCast, stats.raysReused, stats.textureLookups, stats.spritesDrawn, stats.lightChunksRelit);
+        fprintf(file, ",\n{\"name\":\"resolution\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"renderScale\":%.3f,\"viewWidth\":%d,\"viewHeight\":%d}}",
+            record.startUs, (double)stats.renderScale, stats.viewWidth, stats.viewHeight);
+    }
+    fprintf(file, "\n]}\n");
+    const bool ok = ferror(file) == 0;
+    return (fclose(file) == 0) && ok;
+}
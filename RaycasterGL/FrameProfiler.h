@@ -0,0 +1,82 @@
+// FrameProfiler.h
+// Internal stage timers for the frame being rendered and the lock-free history of completed frames.
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include "RaycasterEngine.h"
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+enum ProfileStage {
+    PROFILE_STAGE_BEGIN,
+    PROFILE_STAGE_LIGHTING,
+    PROFILE_STAGE_FLOOR,
+    PROFILE_STAGE_RAYCAST,
+    PROFILE_STAGE_WALLS,
+    PROFILE_STAGE_SPRITES,
+    PROFILE_STAGE_TEXT,
+    PROFILE_STAGE_COMMANDS,
+    PROFILE_STAGE_UPSCALE,
+    PROFILE_STAGE_PRESENT,
+    PROFILE_STAGE_COUNT
+};
+
+class FrameProfiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Forgets the history and restarts the trace clock.
+    void Reset();
+
+    // Called by the render thread only.
+    void BeginFrame();
+    // Adds [start, now) to 'stage' of the current frame.
+    void EndStage(ProfileStage stage, Clock::time_point start);
+    // Fills the timing fields of 'stats' and publishes it as the next completed frame.
+    void EndFrame(RendererStats& stats);
+
+    // Safe from any thread.
+    bool GetLatest(RendererStats& out) const;
+    int GetHistory(RendererStats* out, int maxFrames) const;
+    bool WriteChromeTrace(const char* filePath) const;
+
+private:
+    static const int kMaxFrameSpans = 48;
+
+    // One stage run, in microseconds from the frame start. Back-to-back runs of a stage share a span.
+    struct Span {
+        float startUs;
+        float durationUs;
+        int stage;
+    };
+
+    struct FrameRecord {
+        RendererStats stats;
+        double startUs; // Frame start since Reset
+        int spanCount;
+        Span spans[kMaxFrameSpans];
+    };
+
+    // Ring slot guarded by a sequence lock: odd while the render thread is rewriting it. The record
+    // is copied in and out as relaxed atomic words, so a reader racing the writer only ever sees a
+    // torn copy, which the sequence check then discards.
+    static const int kRecordWords = (int)((sizeof(FrameRecord) + 3) / 4);
+    struct Slot {
+        std::atomic<uint32_t> sequence{ 0 };
+        alignas(8) uint32_t words[kRecordWords];
+    };
+
+    // Copies the record of frame 'frameIndex' (1-based); false if it was overwritten or is being written
+    bool ReadFrame(uint64_t frameIndex, FrameRecord& out) const;
+
+    Slot m_slots[RENDERER_STATS_HISTORY];
+    std::atomic<uint64_t> m_publishedFrames{ 0 };
+
+    Clock::time_point m_epoch = Clock::now();
+    Clock::time_point m_frameStart;
+    FrameRecord m_current = {};
+    float m_stageMs[PROFILE_STAGE_COUNT] = {};
+};
+
+#endif
@@ -0,0 +1,44 @@
+// InputEventRing.cpp
+#include "InputEventRing.h"
+#include <algorithm>
+
+void InputEventRing::Push(const InputEvent* events, int count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int i = 0; i < count; ++i) {
+        if (m_count == RENDERER_INPUT_EVENT_CAPACITY) {
+            m_head = (m_head + 1) % RENDERER_INPUT_EVENT_CAPACITY;
+            --m_count;
+            ++m_dropped;
+        }
+        m_events[(m_head + m_count) % RENDERER_INPUT_EVENT_CAPACITY] = events[i];
+        ++m_count;
+    }
+}
+
+int InputEventRing::Read(InputEvent* out, int maxEvents) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const int count = std::min(m_count, std::max(maxEvents, 0));
+    for (int i = 0; i < count; ++i) {
+        out[i] = m_events[(m_head + i) % RENDERER_INPUT_EVENT_CAPACITY];
+    }
+    m_head = (m_head + count) % RENDERER_INPUT_EVENT_CAPACITY;
+    m_count -= count;
+    return count;
+}
+
+void InputEventRing::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_head = 0;
+    m_count = 0;
+    m_dropped = 0;
+}
+
+int InputEventRing::GetQueued() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count;
+}
+
+uint64_t InputEventRing::GetDropped() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
@@ -0,0 +1,35 @@
+// InputEventRing.h
+// Internal queue behind ReadInputEvents. The thread that polls input pushes the events of every poll
+// and any thread reads them, oldest first. The ring holds RENDERER_INPUT_EVENT_CAPACITY events and
+// never allocates; when it is full a push overwrites the oldest events, so the newest input survives.
+#ifndef INPUT_EVENT_RING_H
+#define INPUT_EVENT_RING_H
+
+#include "RaycasterEngine.h"
+#include <mutex>
+#include <stdint.h>
+
+class InputEventRing {
+public:
+    InputEventRing() = default;
+    InputEventRing(const InputEventRing&) = delete;
+    InputEventRing& operator=(const InputEventRing&) = delete;
+
+    void Push(const InputEvent* events, int count);
+    // Moves up to maxEvents of the oldest events into out and returns how many
+    int Read(InputEvent* out, int maxEvents);
+    // Forgets the events and the dropped count
+    void Clear();
+
+    int GetQueued();
+    uint64_t GetDropped();
+
+private:
+    std::mutex m_mutex;
+    InputEvent m_events[RENDERER_INPUT_EVENT_CAPACITY];
+    int m_head = 0;          // Oldest event
+    int m_count = 0;
+    uint64_t m_dropped = 0;  // Overwritten before they were read
+};
+
+#endif
@@ -0,0 +1,456 @@
+// Lightmap.cpp
+#include "Lightmap.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Face luxels sit this far in front of their face, so the shadow test starts in the open cell
+static const float kFaceOffset = 1.0e-3f;
+// Lights hang this far above the floor and below the ceiling
+static const float kLightHeight = 0.5f;
+// More changed cells than this in one dense map relight every chunk instead
+static const int kMaxMarkedCells = 1024;
+
+// -1 outside the map
+static inline int MapCell(const RaycastMapView& map, int x, int y) {
+    if (x < 0 || y < 0 || x >= map.width || y >= map.height) {
+        return -1;
+    }
+    return map.cells[(size_t)y * map.width + x];
+}
+
+static inline int MapCell(const TiledMapView& map, int x, int y) {
+    if (x < 0 || y < 0 || x >= map.width || y >= map.height) {
+        return -1;
+    }
+    const uint8_t* tile = map.tiles[(size_t)(y >> map.tileShift) * map.tilesX + (x >> map.tileShift)];
+    const int mask = (1 << map.tileShift) - 1;
+    const size_t index = ((size_t)(y & mask) << map.tileShift) | (size_t)(x & mask);
+    return (map.cellBytes == 1) ? tile[index] : ((const uint16_t*)tile)[index];
+}
+
+// Radius the light is evaluated with; 0 if it gives no light
+static float EffectiveRadius(const RaycastLight& light) {
+    if (!isfinite(light.x) || !isfinite(light.y) || !isfinite(light.intensity) || light.intensity <= 0.0f ||
+        !(light.radius > 0.0f)) {
+        return 0.0f;
+    }
+    return std::min(light.radius, RAYCAST_LIGHT_MAX_RADIUS);
+}
+
+static bool SameLight(const RaycastLight& a, const RaycastLight& b) {
+    return a.x == b.x && a.y == b.y && a.radius == b.radius && a.intensity == b.intensity &&
+        a.color.r == b.color.r && a.color.g == b.color.g && a.color.b == b.color.b;
+}
+
+// Whether the segment from the light at (fromX, fromY) to (toX, toY) crosses no wall. The cell of
+// (toX, toY) itself is not tested; a light inside a wall sees nothing.
+template <typename MapView>
+static bool LineOfSight(const MapView& map, float fromX, float fromY, float toX, float toY) {
+    int x = (int)floorf(fromX);
+    int y = (int)floorf(fromY);
+    if (MapCell(map, x, y) > 0) {
+        return false;
+    }
+    const int targetX = (int)floorf(toX);
+    const int targetY = (int)floorf(toY);
+    const float dirX = toX - fromX;
+    const float dirY = toY - fromY;
+    const float deltaX = (dirX == 0.0f) ? 1.0e30f : fabsf(1.0f / dirX);
+    const float deltaY = (dirY == 0.0f) ? 1.0e30f : fabsf(1.0f / dirY);
+    const int stepX = (dirX < 0.0f) ? -1 : 1;
+    const int stepY = (dirY < 0.0f) ? -1 : 1;
+    float sideX = (dirX < 0.0f) ? (fromX - (float)x) * deltaX : ((float)x + 1.0f - fromX) * deltaX;
+    float sideY = (dirY < 0.0f) ? (fromY - (float)y) * deltaY : ((float)y + 1.0f - fromY) * deltaY;
+    // Rounding may wander off the exact cell sequence; never take more steps than the cells between
+    for (int steps = abs(targetX - x) + abs(targetY - y); steps > 0; --steps) {
+        if (sideX < sideY) {
+            sideX += deltaX;
+            x += stepX;
+        }
+        else {
+            sideY += deltaY;
+            y += stepY;
+        }
+        if (x == targetX && y == targetY) {
+            break;
+        }
+        if (MapCell(map, x, y) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ambient plus every light reaching point (x, y), 'height' below or above the lights, on a surface
+// with normal (normalX, normalY) or, for floors and ceilings (height > 0), facing the lights' plane
+template <typename MapView>
+static Color GatherLight(const MapView& map, const RaycastLight* const* lights, int lightCount, Color ambient,
+    float x, float y, float normalX, float normalY, float height) {
+    float r = (float)ambient.r / 255.0f;
+    float g = (float)ambient.g / 255.0f;
+    float b = (float)ambient.b / 255.0f;
+    for (int i = 0; i < lightCount; ++i) {
+        const RaycastLight& light = *lights[i];
+        const float radius = EffectiveRadius(light);
+        const float dx = light.x - x;
+        const float dy = light.y - y;
+        const float distanceSq = dx * dx + dy * dy + height * height;
+        if (distanceSq >= radius * radius) {
+            continue;
+        }
+        const float distance = sqrtf(distanceSq);
+        float cosine = 1.0f;
+        if (height > 0.0f) cosine = height / distance;
+        else if (distance > 0.0f) cosine = (normalX * dx + normalY * dy) / distance;
+        if (cosine <= 0.0f || !LineOfSight(map, light.x, light.y, x, y)) {
+            continue;
+        }
+        const float falloff = 1.0f - distance / radius;
+        const float weight = light.intensity * cosine * falloff * falloff / 255.0f;
+        r += (float)light.color.r * weight;
+        g += (float)light.color.g * weight;
+        b += (float)light.color.b * weight;
+    }
+    return Color{
+        (unsigned char)(std::min(r, 1.0f) * 255.0f + 0.5f),
+        (unsigned char)(std::min(g, 1.0f) * 255.0f + 0.5f),
+        (unsigned char)(std::min(b, 1.0f) * 255.0f + 0.5f),
+        255
+    };
+}
+
+void Lightmap::SetLighting(bool enabled, Color ambient) {
+    ambient.a = 255;
+    if (ambient.r != m_ambient.r || ambient.g != m_ambient.g || ambient.b != m_ambient.b) {
+        m_relightAll = true;
+    }
+    m_ambient = ambient;
+    m_enabled = enabled;
+}
+
+void Lightmap::SetLights(const RaycastLight* lights, int count) {
+    if (lights == nullptr || count < 0) {
+        count = 0;
+    }
+    const int previousCount = (int)m_lights.size();
+    bool changed = false;
+    for (int i = 0; i < std::max(count, previousCount); ++i) {
+        if (i < count && i < previousCount && SameLight(lights[i], m_lights[i])) {
+            continue;
+        }
+        if (i < previousCount) m_dirtyRects.push_back(ReachOf(m_lights[i]));
+        if (i < count) m_dirtyRects.push_back(ReachOf(lights[i]));
+        changed = true;
+    }
+    m_lights.assign(lights, lights + count);
+    m_relightLights.resize(m_lights.size() * m_relightWorkers);
+    m_layoutChanged = m_layoutChanged || changed;
+}
+
+void Lightmap::SetRelightWorkers(int workerCount) {
+    m_relightWorkers = std::max(workerCount, 1);
+    m_relightLights.resize(m_lights.size() * m_relightWorkers);
+}
+
+void Lightmap::Clear() {
+    m_enabled = false;
+    m_ambient = WHITE;
+    m_lights.clear();
+    m_mapTiled = false;
+    m_mapVersion = 0;
+    m_mapCells.clear();
+    ResetMap(0, 0);
+    m_layoutChanged = false;
+}
+
+void Lightmap::ResetMap(int width, int height) {
+    m_mapWidth = width;
+    m_mapHeight = height;
+    m_box = ChunkRect{};
+    m_directory.clear();
+    m_chunks.clear();
+    m_luxels.clear();
+    m_freeChunks.clear();
+    m_dirtyRects.clear();
+    // Every chunk is new, and new chunks are relit anyway
+    m_layoutChanged = true;
+    m_relightAll = false;
+}
+
+void Lightmap::TrackMap(const RaycastMapView& map) {
+    const size_t cells = (size_t)map.width * map.height;
+    if (m_mapTiled || map.width != m_mapWidth || map.height != m_mapHeight) {
+        ResetMap(map.width, map.height);
+        m_mapTiled = false;
+        m_mapCells.assign(map.cells, map.cells + cells);
+        return;
+    }
+    if (memcmp(map.cells, m_mapCells.data(), cells) == 0) {
+        return;
+    }
+    int changed = 0;
+    for (size_t i = 0; i < cells && !m_relightAll; ++i) {
+        if (map.cells[i] == m_mapCells[i]) {
+            continue;
+        }
+        if (++changed > kMaxMarkedCells) m_relightAll = true;
+        else MarkCell((int)(i % map.width), (int)(i / map.width));
+    }
+    m_mapCells.assign(map.cells, map.cells + cells);
+}
+
+void Lightmap::TrackMap(const TiledMapView& map, uint64_t version) {
+    if (!m_mapTiled || map.width != m_mapWidth || map.height != m_mapHeight || version != m_mapVersion) {
+        ResetMap(map.width, map.height);
+        m_mapTiled = true;
+        m_mapVersion = version;
+        m_mapCells.clear();
+    }
+}
+
+void Lightmap::CellEdited(int x, int y, uint64_t before, uint64_t after) {
+    if (m_mapTiled && m_mapVersion == before) {
+        MarkCell(x, y);
+        m_mapVersion = after;
+    }
+}
+
+Lightmap::ChunkRect Lightmap::ReachOf(const RaycastLight& light) const {
+    const float radius = EffectiveRadius(light);
+    if (radius <= 0.0f || m_mapWidth <= 0 || m_mapHeight <= 0) {
+        return ChunkRect{};
+    }
+    // Wall cells one past the lit area still show it a face
+    const float x0 = std::max(floorf(light.x - radius) - 1.0f, 0.0f);
+    const float y0 = std::max(floorf(light.y - radius) - 1.0f, 0.0f);
+    const float x1 = std::min(floorf(light.x + radius) + 1.0f, (float)(m_mapWidth - 1));
+    const float y1 = std::min(floorf(light.y + radius) + 1.0f, (float)(m_mapHeight - 1));
+    if (x0 > x1 || y0 > y1) {
+        return ChunkRect{};
+    }
+    return ChunkRect{ (int)x0 >> kLightChunkShift, (int)y0 >> kLightChunkShift,
+        ((int)x1 >> kLightChunkShift) + 1, ((int)y1 >> kLightChunkShift) + 1 };
+}
+
+// A cell can shadow anything its lights reach, and opens or closes the faces of its neighbours
+void Lightmap::MarkCell(int x, int y) {
+    const int chunkX0 = (x - 1) >> kLightChunkShift;
+    const int chunkY0 = (y - 1) >> kLightChunkShift;
+    const int chunkX1 = ((x + 1) >> kLightChunkShift) + 1;
+    const int chunkY1 = ((y + 1) >> kLightChunkShift) + 1;
+    for (const RaycastLight& light : m_lights) {
+        const ChunkRect reach = ReachOf(light);
+        if (reach.x0 < chunkX1 && chunkX0 < reach.x1 && reach.y0 < chunkY1 && chunkY0 < reach.y1) {
+            m_dirtyRects.push_back(reach);
+        }
+    }
+}
+
+void Lightmap::CollectDirtyChunks(std::vector<int>& chunks) {
+    chunks.clear();
+    auto chunkAt = [this](int chunkX, int chunkY) {
+        const int boxX = chunkX - m_box.x0;
+        const int boxY = chunkY - m_box.y0;
+        const int boxWidth = m_box.x1 - m_box.x0;
+        if (boxX < 0 || boxY < 0 || boxX >= boxWidth || chunkY >= m_box.y1) {
+            return -1;
+        }
+        return m_directory[(size_t)boxY * boxWidth + boxX];
+    };
+    auto markDirty = [&](int chunk) {
+        if (chunk >= 0 && !m_chunks[chunk].dirty) {
+            m_chunks[chunk].dirty = true;
+            chunks.push_back(chunk);
+        }
+    };
+
+    if (m_layoutChanged) {
+        // The directory now spans the chunks any light reaches
+        ChunkRect box = {};
+        for (const RaycastLight& light : m_lights) {
+            const ChunkRect reach = ReachOf(light);
+            if (reach.x0 >= reach.x1) continue;
+            if (box.x0 >= box.x1) {
+                box = reach;
+                continue;
+            }
+            box = ChunkRect{ std::min(box.x0, reach.x0), std::min(box.y0, reach.y0), std::max(box.x1, reach.x1), std::max(box.y1, reach.y1) };
+        }
+        const int boxWidth = box.x1 - box.x0;
+        std::vector<int>& directory = m_nextDirectory; // Swapped with m_directory, so both keep their capacity
+        directory.assign((size_t)boxWidth * (box.y1 - box.y0), -1);
+        // Chunks still in reach keep their luxels, new ones are marked -2 until allocated
+        for (const RaycastLight& light : m_lights) {
+            const ChunkRect reach = ReachOf(light);
+            for (int chunkY = reach.y0; chunkY < reach.y1; ++chunkY) {
+                for (int chunkX = reach.x0; chunkX < reach.x1; ++chunkX) {
+                    int& slot = directory[(size_t)(chunkY - box.y0) * boxWidth + (chunkX - box.x0)];
+                    if (slot == -1) {
+                        const int kept = chunkAt(chunkX, chunkY);
+                        slot = (kept >= 0) ? kept : -2;
+                    }
+                }
+            }
+        }
+        for (int chunk = 0; chunk < (int)m_chunks.size(); ++chunk) {
+            Chunk& info = m_chunks[chunk];
+            if (info.chunkX < 0) continue;
+            const int boxX = info.chunkX - box.x0;
+            const int boxY = info.chunkY - box.y0;
+            if (boxX < 0 || boxY < 0 || boxX >= boxWidth || info.chunkY >= box.y1 ||
+                directory[(size_t)boxY * boxWidth + boxX] != chunk) {
+                info.chunkX = -1;
+                m_freeChunks.push_back(chunk);
+            }
+        }
+        for (size_t i = 0; i < directory.size(); ++i) {
+            if (directory[i] != -2) continue;
+            int chunk;
+            if (!m_freeChunks.empty()) {
+                chunk = m_freeChunks.back();
+                m_freeChunks.pop_back();
+            }
+            else {
+                chunk = (int)m_chunks.size();
+                m_chunks.push_back(Chunk{});
+                m_luxels.resize(m_luxels.size() + kLightChunkLuxels);
+            }
+            m_chunks[chunk] = Chunk{ box.x0 + (int)(i % boxWidth), box.y0 + (int)(i / boxWidth), false };
+            directory[i] = chunk;
+            markDirty(chunk);
+        }
+        m_box = box;
+        m_directory.swap(directory);
+        m_layoutChanged = false;
+    }
+
+    if (m_relightAll) {
+        for (int chunk = 0; chunk < (int)m_chunks.size(); ++chunk) {
+            if (m_chunks[chunk].chunkX >= 0) markDirty(chunk);
+        }
+        m_relightAll = false;
+    }
+    for (const ChunkRect& rect : m_dirtyRects) {
+        for (int chunkY = std::max(rect.y0, m_box.y0); chunkY < std::min(rect.y1, m_box.y1); ++chunkY) {
+            for (int chunkX = std::max(rect.x0, m_box.x0); chunkX < std::min(rect.x1, m_box.x1); ++chunkX) {
+                markDirty(chunkAt(chunkX, chunkY));
+            }
+        }
+    }
+    m_dirtyRects.clear();
+    for (int chunk : chunks) {
+        m_chunks[chunk].dirty = false;
+    }
+}
+
+void Lightmap::RelightChunk(const RaycastMapView& map, int chunk, int worker) {
+    Relight(map, chunk, worker);
+}
+
+void Lightmap::RelightChunk(const TiledMapView& map, int chunk, int worker) {
+    Relight(map, chunk, worker);
+}
+
+template <typename MapView>
+void Lightmap::Relight(const MapView& map, int chunk, int worker) {
+    const Chunk info = m_chunks[chunk];
+    const RaycastLight** lights = m_relightLights.data() + (size_t)worker * m_lights.size();
+    int lightCount = 0;
+    for (const RaycastLight& light : m_lights) {
+        const ChunkRect reach = ReachOf(light);
+        if (info.chunkX >= reach.x0 && info.chunkX < reach.x1 && info.chunkY >= reach.y0 && info.chunkY < reach.y1) {
+            lights[lightCount++] = &light;
+        }
+    }
+
+    // Each cell writes either its faces or its floor and leaves the other ambient
+    static const int kNormals[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    Color* chunkLuxels = m_luxels.data() + (size_t)chunk * kLightChunkLuxels;
+    Color* luxels = chunkLuxels;
+    for (int localY = 0; localY < kLightChunkSize; ++localY) {
+        for (int localX = 0; localX < kLightChunkSize; ++localX, luxels += kLightCellLuxels) {
+            const int x = (info.chunkX << kLightChunkShift) + localX;
+            const int y = (info.chunkY << kLightChunkShift) + localY;
+            const int cell = MapCell(map, x, y);
+            for (int v = 0; v < kLightFaceLuxels; ++v) {
+                for (int u = 0; u < kLightFaceLuxels; ++u) {
+                    Color& luxel = chunkLuxels[PlaneLuxelIndex((x << kLightLuxelShift) + u, (y << kLightLuxelShift) + v)];
+                    if (cell != 0) {
+                        luxel = m_ambient;
+                        continue;
+                    }
+                    const float pointX = (float)x + ((float)u + 0.5f) / (float)kLightFaceLuxels;
+                    const float pointY = (float)y + ((float)v + 0.5f) / (float)kLightFaceLuxels;
+                    luxel = GatherLight(map, lights, lightCount, m_ambient, pointX, pointY, 0.0f, 0.0f, kLightHeight);
+                }
+            }
+            if (cell <= 0) {
+                std::fill(luxels, luxels + kLightCellLuxels, m_ambient);
+                continue;
+            }
+            for (int face = 0; face < 4; ++face) {
+                const int normalX = kNormals[face][0];
+                const int normalY = kNormals[face][1];
+                Color* faceLuxels = luxels + face * kLightFaceLuxels;
+                // Faces against another wall or the map edge are never seen
+                if (MapCell(map, x + normalX, y + normalY) != 0) {
+                    std::fill(faceLuxels, faceLuxels + kLightFaceLuxels, m_ambient);
+                    continue;
+                }
+                for (int k = 0; k < kLightFaceLuxels; ++k) {
+                    const float along = ((float)k + 0.5f) / (float)kLightFaceLuxels;
+                    float pointX, pointY;
+                    if (normalX != 0) {
+                        pointX = (normalX < 0) ? (float)x - kFaceOffset : (float)(x + 1) + kFaceOffset;
+                        pointY = (float)y + along;
+                    }
+                    else {
+                        pointX = (float)x + along;
+                        pointY = (normalY < 0) ? (float)y - kFaceOffset : (float)(y + 1) + kFaceOffset;
+                    }
+                    faceLuxels[k] = GatherLight(map, lights, lightCount, m_ambient, pointX, pointY, (float)normalX, (float)normalY, 0.0f);
+                }
+            }
+        }
+    }
+}
+
+// World coordinate to 16.16 fixed point luxels, clamped far outside any map (NaN included)
+static inline int64_t ToFixedLuxels(float coord) {
+    const double kLimit = 1099511627776.0; // 2^40
+    double fixed = (double)coord * (double)(kLightFaceLuxels << 16);
+    if (!(fixed > -kLimit)) fixed = -kLimit;
+    if (!(fixed < kLimit)) fixed = kLimit;
+    return (int64_t)fixed;
+}
+
+// PlaneLight for a run of pixels. Luxel coordinates are stepped in fixed point so that a pixel costs
+// one unsigned bounds test, and the chunk only changes every kLightChunkSize cells, so it is looked up
+// once per run. The members are read into locals first, since as far as the compiler knows dst may
+// alias them.
+void Lightmap::ShadePlaneRow(const FloorRowSetup& row, Color* dst, int colBegin, int colEnd) const {
+    const uint64_t limitX = (uint64_t)m_mapWidth * kLightFaceLuxels;
+    const uint64_t limitY = (uint64_t)m_mapHeight * kLightFaceLuxels;
+    const Color ambient = m_ambient;
+    int64_t fixedX = ToFixedLuxels(row.originX + (float)colBegin * row.stepX);
+    int64_t fixedY = ToFixedLuxels(row.originY + (float)colBegin * row.stepY);
+    const int64_t stepX = ToFixedLuxels(row.stepX);
+    const int64_t stepY = ToFixedLuxels(row.stepY);
+    int64_t chunkX = -1, chunkY = -1;
+    const Color* chunk = nullptr;
+    for (int x = colBegin; x < colEnd; ++x, fixedX += stepX, fixedY += stepY) {
+        const int64_t lx = fixedX >> 16;
+        const int64_t ly = fixedY >> 16;
+        Color light = ambient;
+        if ((uint64_t)lx < limitX && (uint64_t)ly < limitY) {
+            if ((lx >> kLightPlaneShift) != chunkX || (ly >> kLightPlaneShift) != chunkY) {
+                chunkX = lx >> kLightPlaneShift;
+                chunkY = ly >> kLightPlaneShift;
+                chunk = ChunkLuxels((int)chunkX, (int)chunkY);
+            }
+            if (chunk != nullptr) light = chunk[PlaneLuxelIndex((int)lx, (int)ly)];
+        }
+        dst[x] = ApplyLight(dst[x], light);
+    }
+}
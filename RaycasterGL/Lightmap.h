@@ -0,0 +1,170 @@
+// Lightmap.h
+// Internal cache of the light reaching every wall face and floor/ceiling cell (SetRaycastLights).
+//
+// Light is kept per chunk of kLightChunkSize x kLightChunkSize cells as RGBA8 luxels, 255 being full
+// brightness. A wall cell keeps kLightFaceLuxels along each of its four faces. The floor, which shares
+// its light with the ceiling (lights hang at mid-wall height), is a row-major grid of kLightFaceLuxels
+// x kLightFaceLuxels luxels per cell, so a floor pixel finds its luxel with shifts and masks. Only
+// chunks within reach of a light are stored, the rest of the map reads as the ambient light. Changing
+// a light or a cell marks the chunks of the lights concerned, and only those are relit.
+#ifndef LIGHTMAP_H
+#define LIGHTMAP_H
+
+#include "RaycastKernel.h"
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+constexpr int kLightChunkShift = 4;
+constexpr int kLightChunkSize = 1 << kLightChunkShift;
+constexpr int kLightLuxelShift = 2;
+constexpr int kLightFaceLuxels = 1 << kLightLuxelShift;               // Per face, and per cell side on the floor
+constexpr int kLightCellLuxels = 4 * kLightFaceLuxels;                // Face luxels of one wall cell
+constexpr int kLightPlaneShift = kLightChunkShift + kLightLuxelShift; // Floor luxels per chunk side, log2
+constexpr int kLightPlaneOffset = kLightChunkSize * kLightChunkSize * kLightCellLuxels; // Floor grid after the faces
+constexpr int kLightChunkLuxels = kLightPlaneOffset + (1 << (2 * kLightPlaneShift));
+
+// Face luxels of a wall cell start at face * kLightFaceLuxels, ordered along +Y (west, east) or +X (north, south)
+enum LightFace {
+    LIGHT_FACE_WEST,  // Normal -X
+    LIGHT_FACE_EAST,  // Normal +X
+    LIGHT_FACE_NORTH, // Normal -Y
+    LIGHT_FACE_SOUTH  // Normal +Y
+};
+
+// round(a * b / 255) for bytes, without a division
+inline unsigned char MultiplyLight(unsigned a, unsigned b) {
+    const unsigned t = a * b + 128;
+    return (unsigned char)((t + (t >> 8)) >> 8);
+}
+
+// color * light / 255 per channel; alpha is kept.
+inline Color ApplyLight(Color color, Color light) {
+    return Color{ MultiplyLight(color.r, light.r), MultiplyLight(color.g, light.g), MultiplyLight(color.b, light.b), color.a };
+}
+
+class Lightmap {
+public:
+    Lightmap() = default;
+    Lightmap(const Lightmap&) = delete;
+    Lightmap& operator=(const Lightmap&) = delete;
+
+    // Changing the ambient light relights every stored chunk.
+    void SetLighting(bool enabled, Color ambient);
+    bool IsEnabled() const { return m_enabled; }
+    // Replaces the lights. Only lights that differ from the one at the same index before mark chunks.
+    void SetLights(const RaycastLight* lights, int count);
+    // Threads that may run RelightChunk at once, as workers 0 .. workerCount - 1. Together with
+    // SetLights this sizes their light lists, so relighting does not allocate.
+    void SetRelightWorkers(int workerCount);
+    // Forgets the lights, the map and every chunk, and turns lighting off.
+    void Clear();
+
+    // Follows the map being rendered. A map of another size or kind relights every chunk; cells of a
+    // dense map that differ from the last one relight the chunks of the lights that reach them.
+    void TrackMap(const RaycastMapView& map);
+    void TrackMap(const TiledMapView& map, uint64_t version);
+    // SetCell took the loaded map from version 'before' to 'after'.
+    void CellEdited(int x, int y, uint64_t before, uint64_t after);
+
+    // Allocates chunks newly in reach of a light, frees those no longer in reach, and lists the
+    // chunks to relight. Not thread-safe; RelightChunk may then run on several threads at once, each
+    // with its own worker index.
+    void CollectDirtyChunks(std::vector<int>& chunks);
+    void RelightChunk(const RaycastMapView& map, int chunk, int worker);
+    void RelightChunk(const TiledMapView& map, int chunk, int worker);
+    int GetStoredChunkCount() const { return (int)m_chunks.size() - (int)m_freeChunks.size(); }
+
+    // Light on the face a camera at (posX, posY) sees of a wall hit.
+    Color WallLight(const RaycastHit& hit, float posX, float posY) const {
+        const Color* chunk = ChunkLuxels(hit.mapX >> kLightChunkShift, hit.mapY >> kLightChunkShift);
+        if (chunk == nullptr) {
+            return m_ambient;
+        }
+        const int mask = kLightChunkSize - 1;
+        const Color* luxels = chunk + (((hit.mapY & mask) << kLightChunkShift) | (hit.mapX & mask)) * kLightCellLuxels;
+        const int face = (hit.side == 0) ? ((posX < (float)hit.mapX) ? LIGHT_FACE_WEST : LIGHT_FACE_EAST)
+                                         : ((posY < (float)hit.mapY) ? LIGHT_FACE_NORTH : LIGHT_FACE_SOUTH);
+        const int along = std::min((int)(hit.wallX * (float)kLightFaceLuxels), kLightFaceLuxels - 1);
+        return luxels[face * kLightFaceLuxels + along];
+    }
+
+    // Light on the floor and ceiling at world point (x, y).
+    Color PlaneLight(float x, float y) const {
+        if (!(x >= 0.0f && y >= 0.0f && x < (float)m_mapWidth && y < (float)m_mapHeight)) {
+            return m_ambient;
+        }
+        const int luxelX = (int)(x * (float)kLightFaceLuxels);
+        const int luxelY = (int)(y * (float)kLightFaceLuxels);
+        const Color* chunk = ChunkLuxels(luxelX >> kLightPlaneShift, luxelY >> kLightPlaneShift);
+        if (chunk == nullptr) {
+            return m_ambient;
+        }
+        return chunk[PlaneLuxelIndex(luxelX, luxelY)];
+    }
+
+    // Lights pixels [colBegin, colEnd) of a floor or ceiling scanline.
+    void ShadePlaneRow(const FloorRowSetup& row, Color* dst, int colBegin, int colEnd) const;
+
+private:
+    // Chunk coordinates [x0, x1) x [y0, y1)
+    struct ChunkRect {
+        int x0, y0, x1, y1;
+    };
+
+    struct Chunk {
+        int chunkX, chunkY;
+        bool dirty;
+    };
+
+    // Luxels of chunk (chunkX, chunkY), null if no light reaches it
+    const Color* ChunkLuxels(int chunkX, int chunkY) const {
+        const int boxX = chunkX - m_box.x0;
+        const int boxY = chunkY - m_box.y0;
+        const int boxWidth = m_box.x1 - m_box.x0;
+        if ((unsigned)boxX >= (unsigned)boxWidth || (unsigned)boxY >= (unsigned)(m_box.y1 - m_box.y0)) {
+            return nullptr;
+        }
+        const int chunk = m_directory[(size_t)boxY * boxWidth + boxX];
+        return (chunk >= 0) ? m_luxels.data() + (size_t)chunk * kLightChunkLuxels : nullptr;
+    }
+
+    // Floor luxel (luxelX, luxelY) of the map within its chunk
+    static int PlaneLuxelIndex(int luxelX, int luxelY) {
+        const int mask = (1 << kLightPlaneShift) - 1;
+        return kLightPlaneOffset + (((luxelY & mask) << kLightPlaneShift) | (luxelX & mask));
+    }
+
+    // Chunks holding the cells whose faces or floor a light can reach; empty if it reaches nothing
+    ChunkRect ReachOf(const RaycastLight& light) const;
+    // Relights the chunks of every light reaching cell (x, y) or its neighbours
+    void MarkCell(int x, int y);
+    // Forgets the tracked map and every chunk
+    void ResetMap(int width, int height);
+    template <typename MapView>
+    void Relight(const MapView& map, int chunk, int worker);
+
+    bool m_enabled = false;
+    Color m_ambient = WHITE;
+    std::vector<RaycastLight> m_lights;
+    int m_relightWorkers = 1;
+    std::vector<const RaycastLight*> m_relightLights; // m_lights.size() per worker: those reaching its chunk
+
+    int m_mapWidth = 0;
+    int m_mapHeight = 0;
+    bool m_mapTiled = false;
+    uint64_t m_mapVersion = 0;          // Of the loaded map, when m_mapTiled
+    std::vector<uint8_t> m_mapCells;    // Copy of the dense map, when not
+
+    ChunkRect m_box = {};               // Chunks the directory covers
+    std::vector<int> m_directory;       // Index into m_chunks per chunk of m_box, -1 if out of reach
+    std::vector<int> m_nextDirectory;   // Built by CollectDirtyChunks when the lights moved
+    std::vector<Chunk> m_chunks;
+    std::vector<Color> m_luxels;        // kLightChunkLuxels per entry of m_chunks
+    std::vector<int> m_freeChunks;
+    std::vector<ChunkRect> m_dirtyRects; // Waiting for CollectDirtyChunks
+    bool m_layoutChanged = false;       // Lights moved: chunks may have to be allocated or freed
+    bool m_relightAll = false;
+};
+
+#endif
@@ -0,0 +1,34 @@
+// MappedFile.h
+// Internal read-only memory mapping of a whole file. Pages are read by the OS on first access,
+// so opening a large file costs the same as opening a small one.
+// Kept free of raylib.h: the Windows implementation needs windows.h, whose names clash with raylib's.
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps filePath read-only, closing any previous mapping first. Fails for empty files.
+    bool Open(const char* filePath);
+    void Close();
+
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#if defined(_WIN32)
+    void* m_file = nullptr;    // HANDLE
+    void* m_mapping = nullptr; // HANDLE
+#endif
+};
+
+#endif
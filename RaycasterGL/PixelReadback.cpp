@@ -0,0 +1,148 @@
+// PixelReadback.cpp
+#include "PixelReadback.h"
+#include <stddef.h>
+#include <string.h>
+
+// raylib's rlgl has no pixel buffer API, so the few entry points needed are loaded from the
+// current context through GLFW, which raylib is built on.
+typedef void (*GLFWglproc)(void);
+extern "C" GLFWglproc glfwGetProcAddress(const char* procname);
+
+#if defined(_WIN32)
+#define READBACK_APIENTRY __stdcall
+#else
+#define READBACK_APIENTRY
+#endif
+
+static const unsigned int GL_PIXEL_PACK_BUFFER = 0x88EB;
+static const unsigned int GL_STREAM_READ = 0x88E1;
+static const unsigned int GL_RGBA = 0x1908;
+static const unsigned int GL_UNSIGNED_BYTE = 0x1401;
+static const unsigned int GL_MAP_READ_BIT = 0x0001;
+static const unsigned int GL_SYNC_GPU_COMMANDS_COMPLETE = 0x9117;
+static const unsigned int GL_SYNC_FLUSH_COMMANDS_BIT = 0x0001;
+static const unsigned int GL_ALREADY_SIGNALED = 0x911A;
+static const unsigned int GL_CONDITION_SATISFIED = 0x911C;
+static const uint64_t kWaitForeverNs = ~(uint64_t)0;
+
+struct GlReadbackApi {
+    void (READBACK_APIENTRY* GenBuffers)(int n, unsigned int* buffers);
+    void (READBACK_APIENTRY* DeleteBuffers)(int n, const unsigned int* buffers);
+    void (READBACK_APIENTRY* BindBuffer)(unsigned int target, unsigned int buffer);
+    void (READBACK_APIENTRY* BufferData)(unsigned int target, ptrdiff_t size, const void* data, unsigned int usage);
+    void (READBACK_APIENTRY* ReadPixels)(int x, int y, int width, int height, unsigned int format, unsigned int type, void* pixels);
+    void* (READBACK_APIENTRY* MapBufferRange)(unsigned int target, ptrdiff_t offset, ptrdiff_t length, unsigned int access);
+    unsigned char (READBACK_APIENTRY* UnmapBuffer)(unsigned int target);
+    void* (READBACK_APIENTRY* FenceSync)(unsigned int condition, unsigned int flags);
+    unsigned int (READBACK_APIENTRY* ClientWaitSync)(void* sync, unsigned int flags, uint64_t timeout);
+    void (READBACK_APIENTRY* DeleteSync)(void* sync);
+};
+
+static GlReadbackApi g_gl = {};
+
+template <typename T>
+static bool LoadEntryPoint(T& function, const char* name) {
+    function = reinterpret_cast<T>(glfwGetProcAddress(name));
+    return function != nullptr;
+}
+
+static bool LoadReadbackApi() {
+    bool loaded = true;
+    loaded &= LoadEntryPoint(g_gl.GenBuffers, "glGenBuffers");
+    loaded &= LoadEntryPoint(g_gl.DeleteBuffers, "glDeleteBuffers");
+    loaded &= LoadEntryPoint(g_gl.BindBuffer, "glBindBuffer");
+    loaded &= LoadEntryPoint(g_gl.BufferData, "glBufferData");
+    loaded &= LoadEntryPoint(g_gl.ReadPixels, "glReadPixels");
+    loaded &= LoadEntryPoint(g_gl.MapBufferRange, "glMapBufferRange");
+    loaded &= LoadEntryPoint(g_gl.UnmapBuffer, "glUnmapBuffer");
+    loaded &= LoadEntryPoint(g_gl.FenceSync, "glFenceSync");
+    loaded &= LoadEntryPoint(g_gl.ClientWaitSync, "glClientWaitSync");
+    loaded &= LoadEntryPoint(g_gl.DeleteSync, "glDeleteSync");
+    return loaded;
+}
+
+bool PixelReadback::Start(int width, int height) {
+    Stop();
+    if (width <= 0 || height <= 0 || !LoadReadbackApi()) {
+        return false;
+    }
+    const ptrdiff_t frameBytes = (ptrdiff_t)width * height * 4;
+    g_gl.GenBuffers(kBufferCount, m_buffers);
+    for (unsigned int buffer : m_buffers) {
+        g_gl.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        g_gl.BufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+    }
+    g_gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_width = width;
+    m_height = height;
+    m_head = 0;
+    m_pending = 0;
+    return true;
+}
+
+void PixelReadback::Stop() {
+    if (!IsRunning()) {
+        return;
+    }
+    for (void*& fence : m_fences) {
+        if (fence != nullptr) g_gl.DeleteSync(fence);
+        fence = nullptr;
+    }
+    g_gl.DeleteBuffers(kBufferCount, m_buffers);
+    memset(m_buffers, 0, sizeof(m_buffers));
+    m_width = 0;
+    m_height = 0;
+    m_pending = 0;
+}
+
+void PixelReadback::Queue() {
+    if (!IsRunning() || IsFull()) {
+        return;
+    }
+    // Into the bound pack buffer, glReadPixels only schedules the copy
+    g_gl.BindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[m_head]);
+    g_gl.ReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    g_gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0); // raylib's own reads expect client memory
+    m_fences[m_head] = g_gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_head = (m_head + 1) % kBufferCount;
+    ++m_pending;
+}
+
+bool PixelReadback::PollOldest(bool wait) {
+    if (m_pending == 0) {
+        return false;
+    }
+    const int oldest = (m_head - m_pending + kBufferCount) % kBufferCount;
+    // The flush bit makes sure the fence reaches the GPU, so a later poll cannot wait forever
+    const unsigned int status = g_gl.ClientWaitSync(m_fences[oldest], GL_SYNC_FLUSH_COMMANDS_BIT, wait ? kWaitForeverNs : 0);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+void PixelReadback::TakeOldest(uint8_t* dst) {
+    if (m_pending == 0) {
+        return;
+    }
+    const int oldest = (m_head - m_pending + kBufferCount) % kBufferCount;
+    g_gl.DeleteSync(m_fences[oldest]);
+    m_fences[oldest] = nullptr;
+    --m_pending;
+    if (dst == nullptr) {
+        return;
+    }
+    const size_t rowBytes = (size_t)m_width * 4;
+    g_gl.BindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[oldest]);
+    const uint8_t* src = (const uint8_t*)g_gl.MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (ptrdiff_t)(rowBytes * m_height), GL_MAP_READ_BIT);
+    if (src != nullptr) {
+        // GL rows run bottom to top
+        for (int y = 0; y < m_height; ++y) {
+            uint8_t* row = dst + (size_t)y * rowBytes;
+            memcpy(row, src + (size_t)(m_height - 1 - y) * rowBytes, rowBytes);
+            for (size_t a = 3; a < rowBytes; a += 4) row[a] = 255;
+        }
+        g_gl.UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else {
+        memset(dst, 0, rowBytes * m_height);
+    }
+    g_gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
@@ -0,0 +1,45 @@
+// PixelReadback.h
+// Asynchronous back buffer readback behind frame capture with the GPU backend. Each frame is read
+// into the next of a ring of pixel pack buffers allocated when the capture starts, and a fence is
+// placed behind it. A frame is mapped and copied out only once its fence has passed, a few frames
+// later, so the thread that renders neither waits for the GPU nor allocates per frame. Everything
+// runs on the thread that owns the GL context; GL objects are only released by Stop.
+#ifndef PIXEL_READBACK_H
+#define PIXEL_READBACK_H
+
+#include <stdint.h>
+
+class PixelReadback {
+public:
+    static const int kBufferCount = 3; // Frames the GPU may still be reading back
+
+    PixelReadback() = default;
+    PixelReadback(const PixelReadback&) = delete;
+    PixelReadback& operator=(const PixelReadback&) = delete;
+
+    // Allocates the buffers for width x height RGBA8 frames, releasing any previous ones. False if
+    // the context has no pixel buffers or fences (below OpenGL 3.2 or ES 3.0).
+    bool Start(int width, int height);
+    // Releases the buffers; frames still pending are discarded.
+    void Stop();
+    bool IsRunning() const { return m_width > 0; }
+    bool IsFull() const { return m_pending == kBufferCount; }
+
+    // Starts reading the back buffer into the next free buffer. The ring must not be full.
+    void Queue();
+    // True if a frame is pending and its readback has finished; with 'wait', waits for it instead.
+    bool PollOldest(bool wait);
+    // Copies the oldest pending frame into dst, top row first with opaque alpha like
+    // rlReadScreenPixels, and frees its buffer. A null dst discards the frame.
+    void TakeOldest(uint8_t* dst);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    unsigned int m_buffers[kBufferCount] = {};
+    void* m_fences[kBufferCount] = {}; // GLsync of each pending readback
+    int m_head = 0;                    // Next buffer Queue fills
+    int m_pending = 0;                 // Queued buffers not taken yet, oldest at m_head - m_pending
+};
+
+#endif
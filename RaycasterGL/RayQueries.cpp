@@ -0,0 +1,149 @@
+// RayQueries.cpp
+// CastRaycastRays: arbitrary rays cast through a map without drawing.
+#include "RendererContext.h"
+#include <algorithm>
+#include <math.h>
+
+// --- Ray Queries ---
+
+// Rays staged for one kernel call; rays that cannot hit anything are answered without casting
+static const int kRayQueryChunk = 256;
+// Rays per pool tile
+static const int kRayQueryGrain = 4 * kRayQueryChunk;
+
+template <typename MapView, typename T>
+static int CastRayRange(const MapView& view, const T* rays, int fieldCount, size_t rayStride, size_t fieldStride,
+    const RaycastRayOutput& output, int begin, int end) {
+    float posX[kRayQueryChunk], posY[kRayQueryChunk], dirX[kRayQueryChunk], dirY[kRayQueryChunk];
+    int rayIndex[kRayQueryChunk];
+    RaycastHit hits[kRayQueryChunk];
+    const float mapWidth = (float)view.width;
+    const float mapHeight = (float)view.height;
+    int hitCount = 0;
+    for (int chunk = begin; chunk < end; chunk += kRayQueryChunk) {
+        const int chunkEnd = std::min(chunk + kRayQueryChunk, end);
+        int staged = 0;
+        for (int i = chunk; i < chunkEnd; ++i) {
+            const T* ray = rays + (size_t)i * rayStride;
+            const float x = (float)ray[0];
+            const float y = (float)ray[fieldStride];
+            float dx, dy;
+            if (fieldCount == 3) {
+                // As MakeCameraRaySetup derives the view direction
+                const float angle = (float)ray[2 * fieldStride];
+                dx = cosf(angle);
+                dy = sinf(angle);
+            }
+            else {
+                dx = (float)ray[2 * fieldStride];
+                dy = (float)ray[3 * fieldStride];
+                const float length = sqrtf(dx * dx + dy * dy);
+                dx = (length > 0.0f && isfinite(length)) ? dx / length : NAN;
+                dy = (length > 0.0f && isfinite(length)) ? dy / length : NAN;
+            }
+            if (x >= 0.0f && y >= 0.0f && x < mapWidth && y < mapHeight && isfinite(dx) && isfinite(dy)) {
+                posX[staged] = x;
+                posY[staged] = y;
+                dirX[staged] = dx;
+                dirY[staged] = dy;
+                rayIndex[staged++] = i;
+                continue;
+            }
+            if (output.distances != nullptr) output.distances[i] = INFINITY;
+            if (output.cells != nullptr) output.cells[i] = -1;
+            if (output.sides != nullptr) output.sides[i] = -1;
+            if (output.texCoords != nullptr) output.texCoords[i] = NAN;
+        }
+
+        CastRays(view, posX, posY, dirX, dirY, staged, hits);
+        for (int k = 0; k < staged; ++k) {
+            const RaycastHit& hit = hits[k];
+            const int i = rayIndex[k];
+            const bool wall = hit.cell != 0;
+            hitCount += wall ? 1 : 0;
+            // Unit directions make perpDist the distance along the ray
+            if (output.distances != nullptr) output.distances[i] = wall ? hit.perpDist : INFINITY;
+            if (output.cells != nullptr) output.cells[i] = wall ? (int32_t)((int64_t)hit.mapY * view.width + hit.mapX) : -1;
+            if (output.sides != nullptr) output.sides[i] = wall ? (int8_t)hit.side : (int8_t)-1;
+            if (output.texCoords != nullptr) output.texCoords[i] = wall ? hit.wallX : NAN;
+        }
+    }
+    return hitCount;
+}
+
+template <typename MapView, typename T>
+static int CastRayQueries(RendererContext& ctx, const MapView& view, const T* rays, int rayCount, int fieldCount, size_t rayStride, size_t fieldStride,
+    const RaycastRayOutput* output) {
+    if (rayCount == 0) {
+        return 0;
+    }
+    if (rays == nullptr || rayCount < 0 || output == nullptr || fieldCount < 3 || fieldCount > 4) {
+        TraceLog(LOG_WARNING, "RENDER DLL: CastRaycastRays needs rays of 3 or 4 fields and an output");
+        return -1;
+    }
+    if (output->cells != nullptr && !HasInt32CellIds(view.width, view.height)) {
+        TraceLog(LOG_WARNING, "RENDER DLL: CastRaycastRays cannot output cell IDs of a %dx%d map, they exceed int32", view.width, view.height);
+        return -1;
+    }
+    std::atomic<int> hitCount{ 0 };
+    auto castRays = [&](int begin, int end, int) {
+        hitCount += CastRayRange(view, rays, fieldCount, rayStride, fieldStride, *output, begin, end);
+    };
+    ctx.workerPool.ParallelFor(rayCount, kRayQueryGrain, castRays);
+    return hitCount.load();
+}
+
+// The pool belongs to the thread that renders
+template <typename T>
+static int CastRaysOnDenseMap(RendererContext& ctx, const uint8_t* map, int mapW, int mapH, const T* rays, int rayCount, int fieldCount,
+    size_t rayStride, size_t fieldStride, const RaycastRayOutput* output) {
+    if (map == nullptr || mapW <= 0 || mapH <= 0) {
+        TraceLog(LOG_WARNING, "RENDER DLL: CastRaycastRays called with an empty map");
+        return -1;
+    }
+    int hitCount = 0;
+    auto cast = [&] {
+        RaycastMapView view;
+        view.cells = map;
+        view.width = mapW;
+        view.height = mapH;
+        hitCount = CastRayQueries(ctx, view, rays, rayCount, fieldCount, rayStride, fieldStride, output);
+    };
+    ctx.renderThread.RunOnThread(cast);
+    return hitCount;
+}
+
+template <typename T>
+static int CastRaysOnLoadedMap(RendererContext& ctx, const T* rays, int rayCount, int fieldCount, size_t rayStride, size_t fieldStride,
+    const RaycastRayOutput* output) {
+    if (!ctx.loadedMap.IsLoaded()) {
+        TraceLog(LOG_WARNING, "RENDER DLL: CastRaycastRays called without a loaded map");
+        return -1;
+    }
+    int hitCount = 0;
+    auto cast = [&] { hitCount = CastRayQueries(ctx, ctx.loadedMap.GetView(), rays, rayCount, fieldCount, rayStride, fieldStride, output); };
+    ctx.renderThread.RunOnThread(cast);
+    return hitCount;
+}
+
+int CastRaycastRays(const uint8_t* map, int mapW, int mapH, const double* rays, int rayCount, int fieldCount,
+    size_t rayStride, size_t fieldStride, const RaycastRayOutput* output) {
+    RendererContext& ctx = CurrentContext();
+    return CastRaysOnDenseMap(ctx, map, mapW, mapH, rays, rayCount, fieldCount, rayStride, fieldStride, output);
+}
+
+int CastRaycastRays(const uint8_t* map, int mapW, int mapH, const float* rays, int rayCount, int fieldCount,
+    size_t rayStride, size_t fieldStride, const RaycastRayOutput* output) {
+    RendererContext& ctx = CurrentContext();
+    return CastRaysOnDenseMap(ctx, map, mapW, mapH, rays, rayCount, fieldCount, rayStride, fieldStride, output);
+}
+
+int CastRaycastRays(const double* rays, int rayCount, int fieldCount, size_t rayStride, size_t fieldStride, const RaycastRayOutput* output) {
+    RendererContext& ctx = CurrentContext();
+    return CastRaysOnLoadedMap(ctx, rays, rayCount, fieldCount, rayStride, fieldStride, output);
+}
+
+int CastRaycastRays(const float* rays, int rayCount, int fieldCount, size_t rayStride, size_t fieldStride, const RaycastRayOutput* output) {
+    RendererContext& ctx = CurrentContext();
+    return CastRaysOnLoadedMap(ctx, rays, rayCount, fieldCount, rayStride, fieldStride, output);
+}
@@ -0,0 +1,414 @@
+// RaycastKernel.cpp
+
+// The packet kernels in RaycastSimd.cpp must match this file bit for bit, so multiply-adds
+// must not be fused here (MSVC only contracts under /fp:fast or /fp:contract).
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#include "RaycastKernel.h"
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+
+// Requested SIMD level; RAYCAST_SIMD_AUTO resolves to the detected level on first use
+static std::atomic<int> g_simdLevel{ RAYCAST_SIMD_AUTO };
+
+void CastRay(const RaycastMapView& map, float posX, float posY, float rayDirX, float rayDirY, RaycastHit& hit) {
+    int mapX = (int)floorf(posX);
+    int mapY = (int)floorf(posY);
+
+    // Length of ray from one x or y-side to the next. A zero component never crosses that axis.
+    float deltaDistX = (rayDirX == 0.0f) ? 1.0e30f : fabsf(1.0f / rayDirX);
+    float deltaDistY = (rayDirY == 0.0f) ? 1.0e30f : fabsf(1.0f / rayDirY);
+
+    int stepX, stepY;
+    float sideDistX, sideDistY;
+    if (rayDirX < 0.0f) { stepX = -1; sideDistX = (posX - (float)mapX) * deltaDistX; }
+    else                { stepX = 1;  sideDistX = ((float)mapX + 1.0f - posX) * deltaDistX; }
+    if (rayDirY < 0.0f) { stepY = -1; sideDistY = (posY - (float)mapY) * deltaDistY; }
+    else                { stepY = 1;  sideDistY = ((float)mapY + 1.0f - posY) * deltaDistY; }
+
+    int side = 0;
+    int steps = 0;
+    int cell = 0;
+    for (;;) {
+        if (sideDistX < sideDistY) {
+            sideDistX += deltaDistX;
+            mapX += stepX;
+            side = 0;
+        }
+        else {
+            sideDistY += deltaDistY;
+            mapY += stepY;
+            side = 1;
+        }
+        ++steps;
+        if (mapX < 0 || mapX >= map.width || mapY < 0 || mapY >= map.height) {
+            break; // Left the map
+        }
+        cell = map.cells[mapY * map.width + mapX];
+        if (cell != 0) {
+            break;
+        }
+    }
+
+    hit.mapX = mapX;
+    hit.mapY = mapY;
+    hit.cell = cell;
+    hit.side = side;
+    hit.steps = steps;
+    if (cell == 0) {
+        hit.perpDist = kRaycastNoHitDistance;
+        hit.wallX = 0.0f;
+        return;
+    }
+
+    hit.perpDist = (side == 0) ? (sideDistX - deltaDistX) : (sideDistY - deltaDistY);
+    float wallX = (side == 0) ? (posY + hit.perpDist * rayDirY) : (posX + hit.perpDist * rayDirX);
+    hit.wallX = wallX - floorf(wallX);
+}
+
+static CameraRaySetup MakeCameraRaySetup(const RaycastCamera& camera, float planeScale, int screenWidth, int screenHeight) {
+    CameraRaySetup setup;
+    setup.posX = camera.posX;
+    setup.posY = camera.posY;
+    setup.dirX = cosf(camera.angle);
+    setup.dirY = sinf(camera.angle);
+    // Camera plane is perpendicular to the view direction, scaled so its ends span the FOV
+    setup.planeX = -setup.dirY * planeScale;
+    setup.planeY = setup.dirX * planeScale;
+    // cameraX runs from -1 at the left edge to +1 at the right edge
+    setup.columnScale = (screenWidth > 1) ? 2.0f / (float)(screenWidth - 1) : 0.0f;
+    setup.columnOffset = (screenWidth > 1) ? -1.0f : 0.0f;
+    setup.screenWidth = screenWidth;
+    setup.screenHeight = screenHeight;
+    setup.cameraX = nullptr;
+    return setup;
+}
+
+CameraRaySetup MakeCameraRaySetup(const RaycastCamera& camera, int screenWidth, int screenHeight) {
+    return MakeCameraRaySetup(camera, tanf(camera.fov * 0.5f), screenWidth, screenHeight);
+}
+
+CameraRaySetup MakeCameraRaySetup(const RaycastCamera& camera, const CameraRayTable& table, int screenHeight) {
+    CameraRaySetup setup = MakeCameraRaySetup(camera, table.planeScale, table.screenWidth, screenHeight);
+    setup.cameraX = table.cameraX.data();
+    return setup;
+}
+
+void UpdateCameraRayTable(CameraRayTable& table, int screenWidth, float fov) {
+    if (table.screenWidth == screenWidth && table.fov == fov && (int)table.cameraX.size() == screenWidth) {
+        return;
+    }
+    const CameraRaySetup setup = MakeCameraRaySetup(RaycastCamera{ 0.0f, 0.0f, 0.0f, fov }, screenWidth, 1);
+    table.screenWidth = screenWidth;
+    table.fov = fov;
+    table.planeScale = tanf(fov * 0.5f);
+    table.cameraX.resize(screenWidth);
+    for (int x = 0; x < screenWidth; ++x) {
+        table.cameraX[x] = (float)x * setup.columnScale + setup.columnOffset;
+    }
+}
+
+static void CastCameraColumnsScalar(const RaycastMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits) {
+    for (int x = colBegin; x < colEnd; ++x) {
+        const float cameraX = setup.cameraX[x];
+        RaycastHit& hit = hits[x];
+        CastRay(map, setup.posX, setup.posY, setup.dirX + setup.planeX * cameraX, setup.dirY + setup.planeY * cameraX, hit);
+        ComputeWallSpan(hit.perpDist, setup.screenHeight, hit.drawStart, hit.drawEnd);
+    }
+}
+
+// The packet kernels read four bytes per cell fetch and index cells in 32-bit lanes, so tiny maps
+// and maps of 2^31 cells or more stay scalar
+static bool FitsPacketKernels(const RaycastMapView& map) {
+    const int64_t cells = (int64_t)map.width * map.height;
+    return cells >= 4 && cells <= INT32_MAX;
+}
+
+void CastCameraColumns(const RaycastMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits) {
+    int x = colBegin;
+    if (FitsPacketKernels(map)) {
+        switch (GetRaycastSimdLevel()) {
+        case RAYCAST_SIMD_AVX2:
+            x = CastCameraColumnsAVX2(map, setup, x, colEnd, hits);
+            break;
+        case RAYCAST_SIMD_SSE2:
+            x = CastCameraColumnsSSE2(map, setup, x, colEnd, hits);
+            break;
+        default:
+            break;
+        }
+    }
+    CastCameraColumnsScalar(map, setup, x, colEnd, hits);
+}
+
+void CastCameraColumns(const RaycastMapView& map, const RaycastCamera& camera, int screenWidth, int screenHeight,
+    int colBegin, int colEnd, RaycastHit* hits) {
+    CameraRayTable table;
+    UpdateCameraRayTable(table, screenWidth, camera.fov);
+    CastCameraColumns(map, MakeCameraRaySetup(camera, table, screenHeight), colBegin, colEnd, hits);
+}
+
+void CastRays(const RaycastMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int count, RaycastHit* hits) {
+    int i = 0;
+    if (FitsPacketKernels(map)) {
+        switch (GetRaycastSimdLevel()) {
+        case RAYCAST_SIMD_AVX2:
+            i = CastRaysAVX2(map, posX, posY, dirX, dirY, i, count, hits);
+            break;
+        case RAYCAST_SIMD_SSE2:
+            i = CastRaysSSE2(map, posX, posY, dirX, dirY, i, count, hits);
+            break;
+        default:
+            break;
+        }
+    }
+    for (; i < count; ++i) {
+        CastRay(map, posX[i], posY[i], dirX[i], dirY[i], hits[i]);
+    }
+}
+
+bool RetargetCameraHit(const RaycastHit& face, const CameraRaySetup& setup, float cameraX, RaycastHit& hit) {
+    const float rayDirX = setup.dirX + setup.planeX * cameraX;
+    const float rayDirY = setup.dirY + setup.planeY * cameraX;
+    // The face a ray enters lies on the near side of the cell: its left edge when moving in +X
+    float perpDist, along;
+    int alongCell;
+    if (face.side == 0) {
+        if (rayDirX == 0.0f) return false;
+        const float faceX = (float)face.mapX + ((rayDirX < 0.0f) ? 1.0f : 0.0f);
+        perpDist = (faceX - setup.posX) / rayDirX;
+        along = setup.posY + perpDist * rayDirY;
+        alongCell = face.mapY;
+    }
+    else {
+        if (rayDirY == 0.0f) return false;
+        const float faceY = (float)face.mapY + ((rayDirY < 0.0f) ? 1.0f : 0.0f);
+        perpDist = (faceY - setup.posY) / rayDirY;
+        along = setup.posX + perpDist * rayDirX;
+        alongCell = face.mapX;
+    }
+    // A ray pointing the other way gets a negative distance to the face
+    if (!(perpDist > 0.0f) || floorf(along) != (float)alongCell) {
+        return false;
+    }
+
+    hit = face;
+    hit.perpDist = perpDist;
+    hit.wallX = along - floorf(along);
+    hit.steps = 0;
+    ComputeWallSpan(hit.perpDist, setup.screenHeight, hit.drawStart, hit.drawEnd);
+    return true;
+}
+
+// --- Tiled Maps ---
+
+// Smallest n in [lo, hi] whose step has not been taken when the other axis reaches 'limit':
+// key(n) = sideDist0 + n * deltaDist, a step counts as taken while key(n) < limit (or <= limit
+// when 'takenOnTie', since ties step along Y). key(hi) is known to fail. Keys never decrease with n,
+// so the division only has to get close and the loops settle the last step exactly.
+static inline int FirstStepNotTaken(float sideDist0, float deltaDist, float limit, bool takenOnTie, int lo, int hi) {
+    auto taken = [&](int n) {
+        const float key = sideDist0 + (float)n * deltaDist;
+        return takenOnTie ? key <= limit : key < limit;
+    };
+    const float estimate = (limit - sideDist0) / deltaDist;
+    int n = (estimate <= (float)lo) ? lo : (estimate >= (float)hi) ? hi : (int)estimate;
+    while (n > lo && !taken(n - 1)) --n;
+    while (n < hi && taken(n)) ++n;
+    return n;
+}
+
+template <typename CellT>
+static void CastRayTiled(const TiledMapView& map, float posX, float posY, float rayDirX, float rayDirY, RaycastHit& hit) {
+    const int mapXStart = (int)floorf(posX);
+    const int mapYStart = (int)floorf(posY);
+
+    // Same set-up as CastRay
+    const float deltaDistX = (rayDirX == 0.0f) ? 1.0e30f : fabsf(1.0f / rayDirX);
+    const float deltaDistY = (rayDirY == 0.0f) ? 1.0e30f : fabsf(1.0f / rayDirY);
+    int stepX, stepY;
+    float sideDistX0, sideDistY0;
+    if (rayDirX < 0.0f) { stepX = -1; sideDistX0 = (posX - (float)mapXStart) * deltaDistX; }
+    else                { stepX = 1;  sideDistX0 = ((float)mapXStart + 1.0f - posX) * deltaDistX; }
+    if (rayDirY < 0.0f) { stepY = -1; sideDistY0 = (posY - (float)mapYStart) * deltaDistY; }
+    else                { stepY = 1;  sideDistY0 = ((float)mapYStart + 1.0f - posY) * deltaDistY; }
+
+    // The ray takes its n-th X step (from 0) when sideDistX0 + n * deltaDistX is the smaller key
+    int stepsX = 0, stepsY = 0;
+    float sideDistX = sideDistX0, sideDistY = sideDistY0;
+    int mapX = mapXStart, mapY = mapYStart;
+    const int tileMask = (1 << map.tileShift) - 1;
+
+    int side = 0;
+    int steps = 0;
+    int cell = 0;
+    for (;;) {
+        if (sideDistX < sideDistY) {
+            ++stepsX;
+            sideDistX = sideDistX0 + (float)stepsX * deltaDistX;
+            mapX += stepX;
+            side = 0;
+        }
+        else {
+            ++stepsY;
+            sideDistY = sideDistY0 + (float)stepsY * deltaDistY;
+            mapY += stepY;
+            side = 1;
+        }
+        ++steps;
+        if (mapX < 0 || mapX >= map.width || mapY < 0 || mapY >= map.height) {
+            break; // Left the map
+        }
+        const int emptyShift = map.skip[(mapY >> map.groupShift) * map.groupsX + (mapX >> map.groupShift)];
+        if (emptyShift == 0) {
+            const int tile = (mapY >> map.tileShift) * map.tilesX + (mapX >> map.tileShift);
+            cell = ((const CellT*)map.tiles[tile])[((mapY & tileMask) << map.tileShift) | (mapX & tileMask)];
+            if (cell != 0) {
+                break;
+            }
+            continue;
+        }
+
+        // Empty square (clipped to the map): find the step that leaves it, then move to the state
+        // just before that step, i.e. take every step of the other axis that comes first.
+        const int size = 1 << emptyShift;
+        const int squareX = mapX & ~(size - 1);
+        const int squareY = mapY & ~(size - 1);
+        const int cellsLeftX = (stepX > 0) ? std::min(squareX + size, map.width) - 1 - mapX : mapX - squareX;
+        const int cellsLeftY = (stepY > 0) ? std::min(squareY + size, map.height) - 1 - mapY : mapY - squareY;
+        const int exitStepX = stepsX + cellsLeftX;
+        const int exitStepY = stepsY + cellsLeftY;
+        const float exitKeyX = sideDistX0 + (float)exitStepX * deltaDistX;
+        const float exitKeyY = sideDistY0 + (float)exitStepY * deltaDistY;
+        if (exitKeyX < exitKeyY) {
+            stepsY = FirstStepNotTaken(sideDistY0, deltaDistY, exitKeyX, true, stepsY, exitStepY);
+            stepsX = exitStepX;
+        }
+        else {
+            stepsX = FirstStepNotTaken(sideDistX0, deltaDistX, exitKeyY, false, stepsX, exitStepX);
+            stepsY = exitStepY;
+        }
+        sideDistX = sideDistX0 + (float)stepsX * deltaDistX;
+        sideDistY = sideDistY0 + (float)stepsY * deltaDistY;
+        mapX = mapXStart + stepX * stepsX;
+        mapY = mapYStart + stepY * stepsY;
+    }
+
+    hit.mapX = mapX;
+    hit.mapY = mapY;
+    hit.cell = cell;
+    hit.side = side;
+    hit.steps = steps;
+    if (cell == 0) {
+        hit.perpDist = kRaycastNoHitDistance;
+        hit.wallX = 0.0f;
+        return;
+    }
+
+    // The key of the step that reached the wall
+    hit.perpDist = (side == 0) ? sideDistX0 + (float)(stepsX - 1) * deltaDistX : sideDistY0 + (float)(stepsY - 1) * deltaDistY;
+    float wallX = (side == 0) ? (posY + hit.perpDist * rayDirY) : (posX + hit.perpDist * rayDirX);
+    hit.wallX = wallX - floorf(wallX);
+}
+
+void CastRay(const TiledMapView& map, float posX, float posY, float rayDirX, float rayDirY, RaycastHit& hit) {
+    if (map.cellBytes == 2) CastRayTiled<uint16_t>(map, posX, posY, rayDirX, rayDirY, hit);
+    else CastRayTiled<uint8_t>(map, posX, posY, rayDirX, rayDirY, hit);
+}
+
+template <typename CellT>
+static void CastCameraColumnsTiled(const TiledMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits) {
+    for (int x = colBegin; x < colEnd; ++x) {
+        const float cameraX = setup.cameraX[x];
+        RaycastHit& hit = hits[x];
+        CastRayTiled<CellT>(map, setup.posX, setup.posY, setup.dirX + setup.planeX * cameraX, setup.dirY + setup.planeY * cameraX, hit);
+        ComputeWallSpan(hit.perpDist, setup.screenHeight, hit.drawStart, hit.drawEnd);
+    }
+}
+
+void CastCameraColumns(const TiledMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits) {
+    if (map.cellBytes == 2) CastCameraColumnsTiled<uint16_t>(map, setup, colBegin, colEnd, hits);
+    else CastCameraColumnsTiled<uint8_t>(map, setup, colBegin, colEnd, hits);
+}
+
+template <typename CellT>
+static void CastRaysTiled(const TiledMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int count, RaycastHit* hits) {
+    for (int i = 0; i < count; ++i) {
+        CastRayTiled<CellT>(map, posX[i], posY[i], dirX[i], dirY[i], hits[i]);
+    }
+}
+
+void CastRays(const TiledMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int count, RaycastHit* hits) {
+    if (map.cellBytes == 2) CastRaysTiled<uint16_t>(map, posX, posY, dirX, dirY, count, hits);
+    else CastRaysTiled<uint8_t>(map, posX, posY, dirX, dirY, count, hits);
+}
+
+// --- Floor Casting ---
+
+// Texel index along one axis for a world coordinate; the texture repeats every cell
+static inline int FloorTexel(float coord, int size) {
+    const float frac = coord - floorf(coord);
+    const int texel = (int)(frac * (float)size);
+    return (texel < size - 1) ? texel : size - 1;
+}
+
+static void CastFloorRowScalar(const FloorRowSetup& row, const SoftwareTexture& texture, Color* dst, int colBegin, int colEnd) {
+    for (int x = colBegin; x < colEnd; ++x) {
+        const float worldX = row.originX + (float)x * row.stepX;
+        const float worldY = row.originY + (float)x * row.stepY;
+        const int texX = FloorTexel(worldX, texture.width);
+        const int texY = FloorTexel(worldY, texture.height);
+        dst[x] = texture.pixels[texX * texture.xStride + texY * texture.yStride];
+    }
+}
+
+void CastFloorRow(const FloorRowSetup& row, const SoftwareTexture& texture, Color* dst, int colBegin, int colEnd) {
+    int x = colBegin;
+    switch (GetRaycastSimdLevel()) {
+    case RAYCAST_SIMD_AVX2:
+        x = CastFloorRowAVX2(row, texture, dst, x, colEnd);
+        break;
+    case RAYCAST_SIMD_SSE2:
+        x = CastFloorRowSSE2(row, texture, dst, x, colEnd);
+        break;
+    default:
+        break;
+    }
+    CastFloorRowScalar(row, texture, dst, x, colEnd);
+}
+
+// --- SIMD Level Selection ---
+
+// The 4-wide SSE2 packets lose to the scalar loop (no gathers, and lanes wait for the longest ray),
+// so AUTO only leaves scalar for AVX2. SSE2 is used only when asked for.
+static RaycastSimdLevel AutoRaycastSimdLevel() {
+    return (DetectRaycastSimdLevel() == RAYCAST_SIMD_AVX2) ? RAYCAST_SIMD_AVX2 : RAYCAST_SIMD_SCALAR;
+}
+
+void SetRaycastSimdLevel(RaycastSimdLevel level) {
+    const RaycastSimdLevel supported = DetectRaycastSimdLevel();
+    if (level == RAYCAST_SIMD_AUTO) {
+        level = AutoRaycastSimdLevel();
+    }
+    else if (level > supported) {
+        level = supported;
+    }
+    g_simdLevel.store(level, std::memory_order_relaxed);
+}
+
+RaycastSimdLevel GetRaycastSimdLevel() {
+    int level = g_simdLevel.load(std::memory_order_relaxed);
+    if (level == RAYCAST_SIMD_AUTO) {
+        level = AutoRaycastSimdLevel();
+        g_simdLevel.store(level, std::memory_order_relaxed);
+    }
+    return (RaycastSimdLevel)level;
+}
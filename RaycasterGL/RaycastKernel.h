@@ -0,0 +1,145 @@
+// RaycastKernel.h
+// Internal DDA raycasting core shared by the engine's native render paths.
+// Not part of the public API; include RaycasterEngine.h instead.
+#ifndef RAYCAST_KERNEL_H
+#define RAYCAST_KERNEL_H
+
+#include "RaycasterEngine.h"
+#include "SoftwareRenderer.h"
+#include <stdint.h>
+#include <vector>
+
+// Distance reported for rays that leave the map without hitting a wall.
+constexpr float kRaycastNoHitDistance = 1.0e6f;
+
+// Read-only view of a dense, row-major map: cells[y * width + x], non-zero = wall.
+struct RaycastMapView {
+    const uint8_t* cells = nullptr;
+    int width = 0;
+    int height = 0;
+};
+
+// Read-only view of a tiled map (TiledMap.h).
+struct TiledMapView {
+    const uint8_t* const* tiles = nullptr; // Cells of tile (tx, ty) at tiles[ty * tilesX + tx], row-major within the tile
+    const uint8_t* skip = nullptr;         // Per group of cells, skip[gy * groupsX + gx]: 0 if it may hold walls,
+                                           // otherwise log2 of the side of the aligned, all-empty square it lies in
+    int width = 0;
+    int height = 0;
+    int tilesX = 0;
+    int tileShift = 0;                     // Tiles are (1 << tileShift) cells square
+    int groupsX = 0;
+    int groupShift = 0;                    // Groups are (1 << groupShift) cells square
+    int cellBytes = 1;                     // 1 = uint8_t cells, 2 = uint16_t cells
+};
+
+// Result of casting one ray through the map.
+struct RaycastHit {
+    float perpDist;   // Distance to the wall measured along the camera direction (fisheye corrected)
+    float wallX;      // Fractional hit position along the wall face, [0, 1)
+    int mapX;         // Cell that was hit
+    int mapY;
+    int cell;         // Map value of the hit cell, 0 if the ray left the map
+    int side;         // 0 = hit an X face (E/W), 1 = hit a Y face (N/S)
+    int steps;        // Number of DDA steps taken
+    int drawStart;    // Screen rows covered by the wall slice (camera casts only)
+    int drawEnd;
+};
+
+// Closest distance used when projecting wall heights, avoids huge slices when hugging a wall.
+constexpr float kRaycastMinDistance = 0.1f;
+
+// Screen rows [top, bottom] covered by a wall at perpDist on a screenHeight-tall view.
+inline void ComputeWallSpan(float perpDist, int screenHeight, int& top, int& bottom) {
+    if (perpDist < kRaycastMinDistance) perpDist = kRaycastMinDistance;
+    int lineHeight = (int)((float)screenHeight / perpDist);
+    top = screenHeight / 2 - lineHeight / 2;
+    bottom = screenHeight / 2 + lineHeight / 2;
+    if (top < 0) top = 0;
+    if (bottom > screenHeight - 1) bottom = screenHeight - 1;
+}
+
+// Per-frame camera constants. Column x casts along
+// (dirX + planeX * cameraX, dirY + planeY * cameraX) with cameraX = x * columnScale + columnOffset.
+struct CameraRaySetup {
+    float posX, posY;
+    float dirX, dirY;
+    float planeX, planeY;
+    float columnScale;
+    float columnOffset;
+    int screenWidth;
+    int screenHeight;
+    const float* cameraX; // cameraX of every column, from a CameraRayTable; required by CastCameraColumns
+};
+
+// The per-column part of the camera, which only changes with the resolution or field of view.
+struct CameraRayTable {
+    int screenWidth = 0;
+    float fov = 0.0f;
+    float planeScale = 0.0f;    // tanf(fov / 2)
+    std::vector<float> cameraX; // Bit-identical to x * columnScale + columnOffset
+};
+
+// Rebuilds the table unless it already matches screenWidth and fov.
+void UpdateCameraRayTable(CameraRayTable& table, int screenWidth, float fov);
+// Camera constants without column table (cameraX is null): enough to project points into the view.
+CameraRaySetup MakeCameraRaySetup(const RaycastCamera& camera, int screenWidth, int screenHeight);
+// Camera constants for casting, with the table built by UpdateCameraRayTable(table, screenWidth, camera.fov).
+CameraRaySetup MakeCameraRaySetup(const RaycastCamera& camera, const CameraRayTable& table, int screenHeight);
+
+// Casts a single ray from (posX, posY) along (rayDirX, rayDirY). The direction does not
+// need to be normalised; perpDist is expressed in units of its length.
+void CastRay(const RaycastMapView& map, float posX, float posY, float rayDirX, float rayDirY, RaycastHit& hit);
+
+// Casts the rays for screen columns [colBegin, colEnd) of a screenWidth x screenHeight view and
+// writes them to hits[colBegin..colEnd). Uses the SIMD level selected by SetRaycastSimdLevel.
+void CastCameraColumns(const RaycastMapView& map, const RaycastCamera& camera, int screenWidth, int screenHeight,
+    int colBegin, int colEnd, RaycastHit* hits);
+void CastCameraColumns(const RaycastMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits);
+
+// Casts ray i of [0, count) from (posX[i], posY[i]) along (dirX[i], dirY[i]) into hits[i], exactly as
+// CastRay would, with the SIMD level selected by SetRaycastSimdLevel. drawStart and drawEnd are not
+// set. Origins must lie inside the map.
+void CastRays(const RaycastMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int count, RaycastHit* hits);
+
+// Re-aims 'face', a wall hit of the camera at setup's position, at column cameraX of setup: the
+// caller guarantees the new ray reaches the same face first (e.g. it lies between two rays that
+// both hit it). Distance and wallX are evaluated in closed form, so they may differ from a cast in
+// the last bit. Returns false, leaving hit untouched, if the ray misses the face after all.
+bool RetargetCameraHit(const RaycastHit& face, const CameraRaySetup& setup, float cameraX, RaycastHit& hit);
+
+// Tiled map versions of the above. A ray that enters an empty square crosses it in one step:
+// side distances are evaluated as initial + n * delta instead of being accumulated, so the jump
+// lands on exactly the state that stepping cell by cell would reach. The distances may therefore
+// differ from the dense kernels in the last bit. Scalar only; hit.steps counts cells plus jumps.
+void CastRay(const TiledMapView& map, float posX, float posY, float rayDirX, float rayDirY, RaycastHit& hit);
+void CastCameraColumns(const TiledMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits);
+void CastRays(const TiledMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int count, RaycastHit* hits);
+
+// One floor or ceiling scanline: pixel x shows world point (originX + x * stepX, originY + x * stepY).
+struct FloorRowSetup {
+    float originX, originY;
+    float stepX, stepY;
+};
+
+// Fills dst[colBegin..colEnd) with texels of 'texture', which repeats once per map cell.
+// Uses the SIMD level selected by SetRaycastSimdLevel.
+void CastFloorRow(const FloorRowSetup& row, const SoftwareTexture& texture, Color* dst, int colBegin, int colEnd);
+
+// --- Packet Kernels (RaycastSimd.cpp) ---
+// Each processes whole packets only and returns the first column it did not cast; the caller
+// finishes the remainder with the scalar path. Only valid when map.width * map.height >= 4.
+int CastCameraColumnsSSE2(const RaycastMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits);
+int CastCameraColumnsAVX2(const RaycastMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits);
+int CastRaysSSE2(const RaycastMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int begin, int end, RaycastHit* hits);
+int CastRaysAVX2(const RaycastMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int begin, int end, RaycastHit* hits);
+int CastFloorRowSSE2(const FloorRowSetup& row, const SoftwareTexture& texture, Color* dst, int colBegin, int colEnd);
+int CastFloorRowAVX2(const FloorRowSetup& row, const SoftwareTexture& texture, Color* dst, int colBegin, int colEnd);
+// Highest level the CPU and OS support.
+RaycastSimdLevel DetectRaycastSimdLevel();
+
+#endif
@@ -0,0 +1,690 @@
+// RaycastSimd.cpp
+// Packet DDA: steps 4 (SSE2) or 8 (AVX2) adjacent camera columns at once, one ray per lane.
+// Every lane performs exactly the floating point operations of CastRay/ComputeWallSpan in
+// RaycastKernel.cpp, in the same order, so output is bit-identical to the scalar path.
+// Arbitrary rays (CastRays) are streamed instead: a lane whose ray finishes takes the next one, so
+// rays of very different lengths do not leave lanes idle until the longest ray of a packet ends.
+// The floor row kernels follow the same rule against CastFloorRowScalar, 4 or 8 pixels at a time.
+
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#include "RaycastKernel.h"
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RAYCAST_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(RAYCAST_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define RC_TARGET_SSE2 __attribute__((target("sse2")))
+#define RC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RC_TARGET_SSE2
+#define RC_TARGET_AVX2
+#endif
+
+#ifdef RAYCAST_X86_SIMD
+
+// --- CPU Detection ---
+
+RaycastSimdLevel DetectRaycastSimdLevel() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    bool avx2 = false;
+    // AVX state must also be enabled by the OS (XCR0 bits 1 and 2)
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    // libgcc/compiler-rt already check OS support for the AVX register state
+    __builtin_cpu_init();
+    const bool sse2 = __builtin_cpu_supports("sse2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) return RAYCAST_SIMD_AVX2;
+    if (sse2) return RAYCAST_SIMD_SSE2;
+    return RAYCAST_SIMD_SCALAR;
+}
+
+// Scatters one packet of lane results into the AoS hit buffer.
+static inline void StorePacket(RaycastHit* hits, int count, const float* perp, const float* wallX, const int* mapX, const int* mapY,
+    const int* cell, const int* side, const int* steps, const int* top, const int* bottom) {
+    for (int i = 0; i < count; ++i) {
+        RaycastHit& hit = hits[i];
+        hit.perpDist = perp[i];
+        hit.wallX = wallX[i];
+        hit.mapX = mapX[i];
+        hit.mapY = mapY[i];
+        hit.cell = cell[i];
+        hit.side = side[i];
+        hit.steps = steps[i];
+        hit.drawStart = top[i];
+        hit.drawEnd = bottom[i];
+    }
+}
+
+// State of the rays being streamed through the lanes of CastRaysSSE2/AVX2. Lanes are set up and
+// finished with CastRay's own scalar expressions; only the stepping runs in vector registers.
+template <int N>
+struct RayLanes {
+    alignas(32) float posX[N], posY[N], dirX[N], dirY[N];
+    alignas(32) float deltaDistX[N], deltaDistY[N], sideDistX[N], sideDistY[N];
+    alignas(32) int stepX[N], stepY[N], stepYRow[N], mapX[N], mapY[N], idx[N], steps[N];
+    alignas(32) int cell[N], side[N];
+    int ray[N];
+};
+
+template <int N>
+static inline void StartLane(RayLanes<N>& lanes, int lane, const RaycastMapView& map, float posX, float posY, float rayDirX, float rayDirY, int ray) {
+    const int mapX = (int)floorf(posX);
+    const int mapY = (int)floorf(posY);
+    const float deltaDistX = (rayDirX == 0.0f) ? 1.0e30f : fabsf(1.0f / rayDirX);
+    const float deltaDistY = (rayDirY == 0.0f) ? 1.0e30f : fabsf(1.0f / rayDirY);
+    lanes.posX[lane] = posX;
+    lanes.posY[lane] = posY;
+    lanes.dirX[lane] = rayDirX;
+    lanes.dirY[lane] = rayDirY;
+    lanes.deltaDistX[lane] = deltaDistX;
+    lanes.deltaDistY[lane] = deltaDistY;
+    if (rayDirX < 0.0f) { lanes.stepX[lane] = -1; lanes.sideDistX[lane] = (posX - (float)mapX) * deltaDistX; }
+    else                { lanes.stepX[lane] = 1;  lanes.sideDistX[lane] = ((float)mapX + 1.0f - posX) * deltaDistX; }
+    if (rayDirY < 0.0f) { lanes.stepY[lane] = -1; lanes.sideDistY[lane] = (posY - (float)mapY) * deltaDistY; }
+    else                { lanes.stepY[lane] = 1;  lanes.sideDistY[lane] = ((float)mapY + 1.0f - posY) * deltaDistY; }
+    lanes.stepYRow[lane] = lanes.stepY[lane] * map.width;
+    lanes.mapX[lane] = mapX;
+    lanes.mapY[lane] = mapY;
+    lanes.idx[lane] = mapY * map.width + mapX;
+    lanes.steps[lane] = 0;
+    lanes.ray[lane] = ray;
+}
+
+// Parks a lane that has no ray left on cell (0, 0), where it stays
+template <int N>
+static inline void ParkLane(RayLanes<N>& lanes, int lane) {
+    lanes.stepX[lane] = 0;
+    lanes.stepY[lane] = 0;
+    lanes.stepYRow[lane] = 0;
+    lanes.mapX[lane] = 0;
+    lanes.mapY[lane] = 0;
+    lanes.idx[lane] = 0;
+    lanes.ray[lane] = -1;
+}
+
+// Writes the hit of a lane whose last step hit lanes.cell (0 = left the map) on lanes.side
+template <int N>
+static inline void FinishLane(const RayLanes<N>& lanes, int lane, RaycastHit* hits) {
+    RaycastHit& hit = hits[lanes.ray[lane]];
+    const int side = lanes.side[lane];
+    hit.mapX = lanes.mapX[lane];
+    hit.mapY = lanes.mapY[lane];
+    hit.cell = lanes.cell[lane];
+    hit.side = side;
+    hit.steps = lanes.steps[lane];
+    if (hit.cell == 0) {
+        hit.perpDist = kRaycastNoHitDistance;
+        hit.wallX = 0.0f;
+        return;
+    }
+    hit.perpDist = (side == 0) ? (lanes.sideDistX[lane] - lanes.deltaDistX[lane]) : (lanes.sideDistY[lane] - lanes.deltaDistY[lane]);
+    const float wallX = (side == 0) ? (lanes.posY[lane] + hit.perpDist * lanes.dirY[lane]) : (lanes.posX[lane] + hit.perpDist * lanes.dirX[lane]);
+    hit.wallX = wallX - floorf(wallX);
+}
+
+// Finishes the lanes in 'finished' (a bit per lane) and refills them from rays [next, end).
+// Returns false once every lane is parked.
+template <int N>
+static inline bool RefillLanes(RayLanes<N>& lanes, unsigned finished, const RaycastMapView& map, const float* posX, const float* posY,
+    const float* dirX, const float* dirY, int& next, int end, RaycastHit* hits) {
+    for (int lane = 0; lane < N; ++lane) {
+        if ((finished & (1u << lane)) == 0) continue;
+        FinishLane(lanes, lane, hits);
+        if (next < end) {
+            StartLane(lanes, lane, map, posX[next], posY[next], dirX[next], dirY[next], next);
+            ++next;
+        }
+        else {
+            ParkLane(lanes, lane);
+        }
+    }
+    for (int lane = 0; lane < N; ++lane) {
+        if (lanes.ray[lane] >= 0) return true;
+    }
+    return false;
+}
+
+// --- SSE2 (4 lanes) ---
+
+RC_TARGET_SSE2 static inline __m128 Select4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+RC_TARGET_SSE2 static inline __m128i Select4i(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// floorf for |x| < 2^31 without SSE4.1, keeping the sign of zero like floorf does
+RC_TARGET_SSE2 static inline __m128 Floor4(__m128 x) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    t = _mm_or_ps(t, _mm_and_ps(x, signMask));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+}
+
+RC_TARGET_SSE2 int CastCameraColumnsSSE2(const RaycastMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits) {
+    const int mapXStart = (int)floorf(setup.posX);
+    const int mapYStart = (int)floorf(setup.posY);
+    const float mapXStartF = (float)mapXStart;
+    const float mapYStartF = (float)mapYStart;
+    // Same expressions as CastRay's initial side distances
+    const __m128 backX = _mm_set1_ps(setup.posX - mapXStartF);
+    const __m128 fwdX = _mm_set1_ps(mapXStartF + 1.0f - setup.posX);
+    const __m128 backY = _mm_set1_ps(setup.posY - mapYStartF);
+    const __m128 fwdY = _mm_set1_ps(mapYStartF + 1.0f - setup.posY);
+
+    const __m128 posX = _mm_set1_ps(setup.posX);
+    const __m128 posY = _mm_set1_ps(setup.posY);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 bigDelta = _mm_set1_ps(1.0e30f);
+    const __m128i zeroi = _mm_setzero_si128();
+    const __m128i onei = _mm_set1_epi32(1);
+    const __m128i mapMaxX = _mm_set1_epi32(map.width - 1);
+    const __m128i mapMaxY = _mm_set1_epi32(map.height - 1);
+
+    const int halfHeight = setup.screenHeight / 2;
+    const __m128 screenHeightF = _mm_set1_ps((float)setup.screenHeight);
+    const __m128 minDist = _mm_set1_ps(kRaycastMinDistance);
+
+    alignas(16) int outMapX[4], outMapY[4], outCell[4], outSide[4], outSteps[4], outTop[4], outBottom[4];
+    alignas(16) float outPerp[4], outWallX[4];
+
+    int x = colBegin;
+    for (; x + 4 <= colEnd; x += 4) {
+        const __m128 cameraX = _mm_loadu_ps(setup.cameraX + x);
+        const __m128 rayDirX = _mm_add_ps(_mm_set1_ps(setup.dirX), _mm_mul_ps(_mm_set1_ps(setup.planeX), cameraX));
+        const __m128 rayDirY = _mm_add_ps(_mm_set1_ps(setup.dirY), _mm_mul_ps(_mm_set1_ps(setup.planeY), cameraX));
+
+        const __m128 deltaDistX = Select4(_mm_cmpeq_ps(rayDirX, zero), bigDelta, _mm_and_ps(_mm_div_ps(one, rayDirX), absMask));
+        const __m128 deltaDistY = Select4(_mm_cmpeq_ps(rayDirY, zero), bigDelta, _mm_and_ps(_mm_div_ps(one, rayDirY), absMask));
+
+        const __m128 negX = _mm_cmplt_ps(rayDirX, zero);
+        const __m128 negY = _mm_cmplt_ps(rayDirY, zero);
+        // -1 where negative, +1 otherwise
+        const __m128i stepX = _mm_or_si128(_mm_castps_si128(negX), onei);
+        const __m128i stepY = _mm_or_si128(_mm_castps_si128(negY), onei);
+        const __m128i stepYRow = Select4i(_mm_castps_si128(negY), _mm_set1_epi32(-map.width), _mm_set1_epi32(map.width));
+
+        __m128 sideDistX = Select4(negX, _mm_mul_ps(backX, deltaDistX), _mm_mul_ps(fwdX, deltaDistX));
+        __m128 sideDistY = Select4(negY, _mm_mul_ps(backY, deltaDistY), _mm_mul_ps(fwdY, deltaDistY));
+        __m128i mapX = _mm_set1_epi32(mapXStart);
+        __m128i mapY = _mm_set1_epi32(mapYStart);
+        // Linear cell index, tracked incrementally because SSE2 has no 32-bit multiply
+        __m128i idx = _mm_set1_epi32(mapYStart * map.width + mapXStart);
+
+        // State captured at each lane's first hit (or exit from the map)
+        __m128 hitSideDistX = sideDistX, hitSideDistY = sideDistY;
+        __m128i mapXHit = mapX, mapYHit = mapY;
+        __m128i side = zeroi;
+        __m128i steps = zeroi;
+        __m128i cell = zeroi;
+        __m128i done = zeroi;
+        __m128i iteration = zeroi;
+
+        // Lanes keep stepping after they finish so the stepping chain never waits on a map fetch;
+        // only the captured state and the loop exit depend on the fetched cells.
+        do {
+            const __m128i stepsX = _mm_castps_si128(_mm_cmplt_ps(sideDistX, sideDistY));
+            const __m128i stepsY = _mm_andnot_si128(stepsX, _mm_set1_epi32(-1));
+            sideDistX = Select4(_mm_castsi128_ps(stepsX), _mm_add_ps(sideDistX, deltaDistX), sideDistX);
+            sideDistY = Select4(_mm_castsi128_ps(stepsY), _mm_add_ps(sideDistY, deltaDistY), sideDistY);
+            mapX = _mm_add_epi32(mapX, _mm_and_si128(stepX, stepsX));
+            mapY = _mm_add_epi32(mapY, _mm_and_si128(stepY, stepsY));
+            idx = _mm_add_epi32(idx, _mm_or_si128(_mm_and_si128(stepX, stepsX), _mm_and_si128(stepYRow, stepsY)));
+            iteration = _mm_add_epi32(iteration, onei);
+
+            const __m128i out = _mm_or_si128(_mm_or_si128(_mm_cmplt_epi32(mapX, zeroi), _mm_cmpgt_epi32(mapX, mapMaxX)),
+                _mm_or_si128(_mm_cmplt_epi32(mapY, zeroi), _mm_cmpgt_epi32(mapY, mapMaxY)));
+
+            // No gather before AVX2: out-of-bounds lanes read cell 0 and are masked off afterwards
+            const __m128i safeIdx = _mm_andnot_si128(out, idx);
+            const __m128i fetched = _mm_andnot_si128(out, _mm_setr_epi32(
+                map.cells[_mm_cvtsi128_si32(safeIdx)],
+                map.cells[_mm_cvtsi128_si32(_mm_shuffle_epi32(safeIdx, _MM_SHUFFLE(1, 1, 1, 1)))],
+                map.cells[_mm_cvtsi128_si32(_mm_shuffle_epi32(safeIdx, _MM_SHUFFLE(2, 2, 2, 2)))],
+                map.cells[_mm_cvtsi128_si32(_mm_shuffle_epi32(safeIdx, _MM_SHUFFLE(3, 3, 3, 3)))]));
+            const __m128i finished = _mm_or_si128(out, _mm_andnot_si128(_mm_cmpeq_epi32(fetched, zeroi), _mm_set1_epi32(-1)));
+            const __m128i first = _mm_andnot_si128(done, finished);
+
+            hitSideDistX = Select4(_mm_castsi128_ps(first), sideDistX, hitSideDistX);
+            hitSideDistY = Select4(_mm_castsi128_ps(first), sideDistY, hitSideDistY);
+            mapXHit = Select4i(first, mapX, mapXHit);
+            mapYHit = Select4i(first, mapY, mapYHit);
+            side = Select4i(first, _mm_and_si128(stepsY, onei), side);
+            steps = Select4i(first, iteration, steps);
+            cell = Select4i(first, fetched, cell);
+            done = _mm_or_si128(done, finished);
+        } while (_mm_movemask_ps(_mm_castsi128_ps(done)) != 0xF);
+        sideDistX = hitSideDistX;
+        sideDistY = hitSideDistY;
+        mapX = mapXHit;
+        mapY = mapYHit;
+
+        const __m128 hitMask = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmpeq_epi32(cell, zeroi), _mm_set1_epi32(-1)));
+        const __m128 sideIsY = _mm_castsi128_ps(_mm_cmpeq_epi32(side, onei));
+        __m128 perp = Select4(sideIsY, _mm_sub_ps(sideDistY, deltaDistY), _mm_sub_ps(sideDistX, deltaDistX));
+        const __m128 wall = Select4(sideIsY, _mm_add_ps(posX, _mm_mul_ps(perp, rayDirX)), _mm_add_ps(posY, _mm_mul_ps(perp, rayDirY)));
+        const __m128 wallX = Select4(hitMask, _mm_sub_ps(wall, Floor4(wall)), zero);
+        perp = Select4(hitMask, perp, _mm_set1_ps(kRaycastNoHitDistance));
+
+        // ComputeWallSpan
+        const __m128 clamped = Select4(_mm_cmplt_ps(perp, minDist), minDist, perp);
+        const __m128i halfLine = _mm_srai_epi32(_mm_cvttps_epi32(_mm_div_ps(screenHeightF, clamped)), 1);
+        __m128i top = _mm_sub_epi32(_mm_set1_epi32(halfHeight), halfLine);
+        __m128i bottom = _mm_add_epi32(_mm_set1_epi32(halfHeight), halfLine);
+        top = Select4i(_mm_cmplt_epi32(top, zeroi), zeroi, top);
+        const __m128i maxRow = _mm_set1_epi32(setup.screenHeight - 1);
+        bottom = Select4i(_mm_cmpgt_epi32(bottom, maxRow), maxRow, bottom);
+
+        _mm_store_ps(outPerp, perp);
+        _mm_store_ps(outWallX, wallX);
+        _mm_store_si128((__m128i*)outMapX, mapX);
+        _mm_store_si128((__m128i*)outMapY, mapY);
+        _mm_store_si128((__m128i*)outCell, cell);
+        _mm_store_si128((__m128i*)outSide, side);
+        _mm_store_si128((__m128i*)outSteps, steps);
+        _mm_store_si128((__m128i*)outTop, top);
+        _mm_store_si128((__m128i*)outBottom, bottom);
+        StorePacket(hits + x, 4, outPerp, outWallX, outMapX, outMapY, outCell, outSide, outSteps, outTop, outBottom);
+    }
+    return x;
+}
+
+// Texel index along one axis, see FloorTexel in RaycastKernel.cpp
+RC_TARGET_SSE2 static inline __m128i FloorTexel4(__m128 coord, __m128 sizeF, __m128i sizeMax) {
+    const __m128 frac = _mm_sub_ps(coord, Floor4(coord));
+    const __m128i texel = _mm_cvttps_epi32(_mm_mul_ps(frac, sizeF));
+    return Select4i(_mm_cmplt_epi32(texel, sizeMax), texel, sizeMax);
+}
+
+RC_TARGET_SSE2 int CastFloorRowSSE2(const FloorRowSetup& row, const SoftwareTexture& texture, Color* dst, int colBegin, int colEnd) {
+    const __m128 originX = _mm_set1_ps(row.originX);
+    const __m128 originY = _mm_set1_ps(row.originY);
+    const __m128 stepX = _mm_set1_ps(row.stepX);
+    const __m128 stepY = _mm_set1_ps(row.stepY);
+    const __m128 widthF = _mm_set1_ps((float)texture.width);
+    const __m128 heightF = _mm_set1_ps((float)texture.height);
+    const __m128i widthMax = _mm_set1_epi32(texture.width - 1);
+    const __m128i heightMax = _mm_set1_epi32(texture.height - 1);
+    const __m128i laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+    alignas(16) int texX[4], texY[4];
+
+    int x = colBegin;
+    for (; x + 4 <= colEnd; x += 4) {
+        const __m128 xs = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x), laneOffsets));
+        _mm_store_si128((__m128i*)texX, FloorTexel4(_mm_add_ps(originX, _mm_mul_ps(xs, stepX)), widthF, widthMax));
+        _mm_store_si128((__m128i*)texY, FloorTexel4(_mm_add_ps(originY, _mm_mul_ps(xs, stepY)), heightF, heightMax));
+        // No gather (or 32-bit multiply) before AVX2: address the four texels one by one
+        for (int i = 0; i < 4; ++i) {
+            dst[x + i] = texture.pixels[texX[i] * texture.xStride + texY[i] * texture.yStride];
+        }
+    }
+    return x;
+}
+
+RC_TARGET_SSE2 int CastRaysSSE2(const RaycastMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int begin, int end, RaycastHit* hits) {
+    RayLanes<4> lanes;
+    int next = begin;
+    for (int lane = 0; lane < 4; ++lane) {
+        if (next < end) {
+            StartLane(lanes, lane, map, posX[next], posY[next], dirX[next], dirY[next], next);
+            ++next;
+        }
+        else {
+            ParkLane(lanes, lane);
+        }
+    }
+    if (lanes.ray[0] < 0) {
+        return end;
+    }
+
+    const __m128i zeroi = _mm_setzero_si128();
+    const __m128i onei = _mm_set1_epi32(1);
+    const __m128i mapMaxX = _mm_set1_epi32(map.width - 1);
+    const __m128i mapMaxY = _mm_set1_epi32(map.height - 1);
+    for (;;) {
+        const __m128 deltaDistX = _mm_load_ps(lanes.deltaDistX);
+        const __m128 deltaDistY = _mm_load_ps(lanes.deltaDistY);
+        const __m128i stepX = _mm_load_si128((const __m128i*)lanes.stepX);
+        const __m128i stepY = _mm_load_si128((const __m128i*)lanes.stepY);
+        const __m128i stepYRow = _mm_load_si128((const __m128i*)lanes.stepYRow);
+        const __m128i active = _mm_cmpgt_epi32(_mm_setr_epi32(lanes.ray[0], lanes.ray[1], lanes.ray[2], lanes.ray[3]), _mm_set1_epi32(-1));
+        __m128 sideDistX = _mm_load_ps(lanes.sideDistX);
+        __m128 sideDistY = _mm_load_ps(lanes.sideDistY);
+        __m128i mapX = _mm_load_si128((const __m128i*)lanes.mapX);
+        __m128i mapY = _mm_load_si128((const __m128i*)lanes.mapY);
+        __m128i idx = _mm_load_si128((const __m128i*)lanes.idx);
+        __m128i steps = _mm_load_si128((const __m128i*)lanes.steps);
+
+        // Step every lane until at least one active lane hits a wall or leaves the map
+        __m128i stepsY, fetched;
+        int finished;
+        do {
+            const __m128i stepsX = _mm_castps_si128(_mm_cmplt_ps(sideDistX, sideDistY));
+            stepsY = _mm_andnot_si128(stepsX, _mm_set1_epi32(-1));
+            sideDistX = Select4(_mm_castsi128_ps(stepsX), _mm_add_ps(sideDistX, deltaDistX), sideDistX);
+            sideDistY = Select4(_mm_castsi128_ps(stepsY), _mm_add_ps(sideDistY, deltaDistY), sideDistY);
+            mapX = _mm_add_epi32(mapX, _mm_and_si128(stepX, stepsX));
+            mapY = _mm_add_epi32(mapY, _mm_and_si128(stepY, stepsY));
+            idx = _mm_add_epi32(idx, _mm_or_si128(_mm_and_si128(stepX, stepsX), _mm_and_si128(stepYRow, stepsY)));
+            steps = _mm_add_epi32(steps, onei);
+
+            const __m128i out = _mm_or_si128(_mm_or_si128(_mm_cmplt_epi32(mapX, zeroi), _mm_cmpgt_epi32(mapX, mapMaxX)),
+                _mm_or_si128(_mm_cmplt_epi32(mapY, zeroi), _mm_cmpgt_epi32(mapY, mapMaxY)));
+            const __m128i safeIdx = _mm_andnot_si128(out, idx);
+            fetched = _mm_andnot_si128(out, _mm_setr_epi32(
+                map.cells[_mm_cvtsi128_si32(safeIdx)],
+                map.cells[_mm_cvtsi128_si32(_mm_shuffle_epi32(safeIdx, _MM_SHUFFLE(1, 1, 1, 1)))],
+                map.cells[_mm_cvtsi128_si32(_mm_shuffle_epi32(safeIdx, _MM_SHUFFLE(2, 2, 2, 2)))],
+                map.cells[_mm_cvtsi128_si32(_mm_shuffle_epi32(safeIdx, _MM_SHUFFLE(3, 3, 3, 3)))]));
+            const __m128i done = _mm_and_si128(active, _mm_or_si128(out, _mm_andnot_si128(_mm_cmpeq_epi32(fetched, zeroi), _mm_set1_epi32(-1))));
+            finished = _mm_movemask_ps(_mm_castsi128_ps(done));
+        } while (finished == 0);
+
+        _mm_store_ps(lanes.sideDistX, sideDistX);
+        _mm_store_ps(lanes.sideDistY, sideDistY);
+        _mm_store_si128((__m128i*)lanes.mapX, mapX);
+        _mm_store_si128((__m128i*)lanes.mapY, mapY);
+        _mm_store_si128((__m128i*)lanes.idx, idx);
+        _mm_store_si128((__m128i*)lanes.steps, steps);
+        _mm_store_si128((__m128i*)lanes.cell, fetched);
+        _mm_store_si128((__m128i*)lanes.side, _mm_and_si128(stepsY, onei));
+        if (!RefillLanes(lanes, (unsigned)finished, map, posX, posY, dirX, dirY, next, end, hits)) {
+            return end;
+        }
+    }
+}
+
+// --- AVX2 (8 lanes) ---
+
+RC_TARGET_AVX2 int CastCameraColumnsAVX2(const RaycastMapView& map, const CameraRaySetup& setup, int colBegin, int colEnd, RaycastHit* hits) {
+    const int mapXStart = (int)floorf(setup.posX);
+    const int mapYStart = (int)floorf(setup.posY);
+    const float mapXStartF = (float)mapXStart;
+    const float mapYStartF = (float)mapYStart;
+    const __m256 backX = _mm256_set1_ps(setup.posX - mapXStartF);
+    const __m256 fwdX = _mm256_set1_ps(mapXStartF + 1.0f - setup.posX);
+    const __m256 backY = _mm256_set1_ps(setup.posY - mapYStartF);
+    const __m256 fwdY = _mm256_set1_ps(mapYStartF + 1.0f - setup.posY);
+
+    const __m256 posX = _mm256_set1_ps(setup.posX);
+    const __m256 posY = _mm256_set1_ps(setup.posY);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 bigDelta = _mm256_set1_ps(1.0e30f);
+    const __m256i zeroi = _mm256_setzero_si256();
+    const __m256i onei = _mm256_set1_epi32(1);
+    const __m256i allOnes = _mm256_set1_epi32(-1);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i mapMaxX = _mm256_set1_epi32(map.width - 1);
+    const __m256i mapMaxY = _mm256_set1_epi32(map.height - 1);
+    const __m256i mapWidth = _mm256_set1_epi32(map.width);
+    // Gathers read 4 bytes, so the last valid gather start is 4 bytes before the end of the map.
+    // Lane indices are 32-bit: CastCameraColumns only sends maps whose cell IDs fit in an int.
+    const __m256i lastGather = _mm256_set1_epi32((int)((int64_t)map.width * map.height - 4));
+    const int* cellBase = (const int*)map.cells;
+
+    const int halfHeight = setup.screenHeight / 2;
+    const __m256 screenHeightF = _mm256_set1_ps((float)setup.screenHeight);
+    const __m256 minDist = _mm256_set1_ps(kRaycastMinDistance);
+
+    alignas(32) int outMapX[8], outMapY[8], outCell[8], outSide[8], outSteps[8], outTop[8], outBottom[8];
+    alignas(32) float outPerp[8], outWallX[8];
+
+    int x = colBegin;
+    for (; x + 8 <= colEnd; x += 8) {
+        const __m256 cameraX = _mm256_loadu_ps(setup.cameraX + x);
+        const __m256 rayDirX = _mm256_add_ps(_mm256_set1_ps(setup.dirX), _mm256_mul_ps(_mm256_set1_ps(setup.planeX), cameraX));
+        const __m256 rayDirY = _mm256_add_ps(_mm256_set1_ps(setup.dirY), _mm256_mul_ps(_mm256_set1_ps(setup.planeY), cameraX));
+
+        const __m256 deltaDistX = _mm256_blendv_ps(_mm256_and_ps(_mm256_div_ps(one, rayDirX), absMask), bigDelta, _mm256_cmp_ps(rayDirX, zero, _CMP_EQ_OQ));
+        const __m256 deltaDistY = _mm256_blendv_ps(_mm256_and_ps(_mm256_div_ps(one, rayDirY), absMask), bigDelta, _mm256_cmp_ps(rayDirY, zero, _CMP_EQ_OQ));
+
+        const __m256 negX = _mm256_cmp_ps(rayDirX, zero, _CMP_LT_OQ);
+        const __m256 negY = _mm256_cmp_ps(rayDirY, zero, _CMP_LT_OQ);
+        const __m256i stepX = _mm256_or_si256(_mm256_castps_si256(negX), onei);
+        const __m256i stepY = _mm256_or_si256(_mm256_castps_si256(negY), onei);
+        const __m256i stepYRow = _mm256_mullo_epi32(stepY, mapWidth);
+
+        __m256 sideDistX = _mm256_blendv_ps(_mm256_mul_ps(fwdX, deltaDistX), _mm256_mul_ps(backX, deltaDistX), negX);
+        __m256 sideDistY = _mm256_blendv_ps(_mm256_mul_ps(fwdY, deltaDistY), _mm256_mul_ps(backY, deltaDistY), negY);
+        __m256i mapX = _mm256_set1_epi32(mapXStart);
+        __m256i mapY = _mm256_set1_epi32(mapYStart);
+        __m256i idx = _mm256_set1_epi32(mapYStart * map.width + mapXStart);
+
+        // State captured at each lane's first hit (or exit from the map), see the SSE2 kernel
+        __m256 hitSideDistX = sideDistX, hitSideDistY = sideDistY;
+        __m256i mapXHit = mapX, mapYHit = mapY;
+        __m256i side = zeroi;
+        __m256i steps = zeroi;
+        __m256i cell = zeroi;
+        __m256i done = zeroi;
+        __m256i iteration = zeroi;
+
+        do {
+            const __m256i stepsX = _mm256_castps_si256(_mm256_cmp_ps(sideDistX, sideDistY, _CMP_LT_OQ));
+            const __m256i stepsY = _mm256_andnot_si256(stepsX, allOnes);
+            sideDistX = _mm256_blendv_ps(sideDistX, _mm256_add_ps(sideDistX, deltaDistX), _mm256_castsi256_ps(stepsX));
+            sideDistY = _mm256_blendv_ps(sideDistY, _mm256_add_ps(sideDistY, deltaDistY), _mm256_castsi256_ps(stepsY));
+            mapX = _mm256_add_epi32(mapX, _mm256_and_si256(stepX, stepsX));
+            mapY = _mm256_add_epi32(mapY, _mm256_and_si256(stepY, stepsY));
+            idx = _mm256_add_epi32(idx, _mm256_or_si256(_mm256_and_si256(stepX, stepsX), _mm256_and_si256(stepYRow, stepsY)));
+            iteration = _mm256_add_epi32(iteration, onei);
+
+            const __m256i out = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(zeroi, mapX), _mm256_cmpgt_epi32(mapX, mapMaxX)),
+                _mm256_or_si256(_mm256_cmpgt_epi32(zeroi, mapY), _mm256_cmpgt_epi32(mapY, mapMaxY)));
+
+            // Gather 4 bytes per lane starting at or before the cell, then shift the cell's byte down
+            const __m256i gatherAt = _mm256_min_epi32(idx, lastGather);
+            const __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(idx, gatherAt), 3);
+            const __m256i gathered = _mm256_mask_i32gather_epi32(zeroi, cellBase, gatherAt, _mm256_andnot_si256(out, allOnes), 1);
+            const __m256i fetched = _mm256_and_si256(_mm256_srlv_epi32(gathered, shift), byteMask);
+
+            const __m256i finished = _mm256_or_si256(out, _mm256_andnot_si256(_mm256_cmpeq_epi32(fetched, zeroi), allOnes));
+            const __m256i first = _mm256_andnot_si256(done, finished);
+
+            hitSideDistX = _mm256_blendv_ps(hitSideDistX, sideDistX, _mm256_castsi256_ps(first));
+            hitSideDistY = _mm256_blendv_ps(hitSideDistY, sideDistY, _mm256_castsi256_ps(first));
+            mapXHit = _mm256_blendv_epi8(mapXHit, mapX, first);
+            mapYHit = _mm256_blendv_epi8(mapYHit, mapY, first);
+            side = _mm256_blendv_epi8(side, _mm256_and_si256(stepsY, onei), first);
+            steps = _mm256_blendv_epi8(steps, iteration, first);
+            cell = _mm256_blendv_epi8(cell, fetched, first);
+            done = _mm256_or_si256(done, finished);
+        } while (!_mm256_testc_si256(done, allOnes));
+        sideDistX = hitSideDistX;
+        sideDistY = hitSideDistY;
+        mapX = mapXHit;
+        mapY = mapYHit;
+
+        const __m256 hitMask = _mm256_castsi256_ps(_mm256_andnot_si256(_mm256_cmpeq_epi32(cell, zeroi), allOnes));
+        const __m256 sideIsY = _mm256_castsi256_ps(_mm256_cmpeq_epi32(side, onei));
+        __m256 perp = _mm256_blendv_ps(_mm256_sub_ps(sideDistX, deltaDistX), _mm256_sub_ps(sideDistY, deltaDistY), sideIsY);
+        const __m256 wall = _mm256_blendv_ps(_mm256_add_ps(posY, _mm256_mul_ps(perp, rayDirY)), _mm256_add_ps(posX, _mm256_mul_ps(perp, rayDirX)), sideIsY);
+        const __m256 wallX = _mm256_blendv_ps(zero, _mm256_sub_ps(wall, _mm256_floor_ps(wall)), hitMask);
+        perp = _mm256_blendv_ps(_mm256_set1_ps(kRaycastNoHitDistance), perp, hitMask);
+
+        // ComputeWallSpan
+        const __m256 clamped = _mm256_blendv_ps(perp, minDist, _mm256_cmp_ps(perp, minDist, _CMP_LT_OQ));
+        const __m256i halfLine = _mm256_srai_epi32(_mm256_cvttps_epi32(_mm256_div_ps(screenHeightF, clamped)), 1);
+        const __m256i top = _mm256_max_epi32(_mm256_sub_epi32(_mm256_set1_epi32(halfHeight), halfLine), zeroi);
+        const __m256i bottom = _mm256_min_epi32(_mm256_add_epi32(_mm256_set1_epi32(halfHeight), halfLine), _mm256_set1_epi32(setup.screenHeight - 1));
+
+        _mm256_store_ps(outPerp, perp);
+        _mm256_store_ps(outWallX, wallX);
+        _mm256_store_si256((__m256i*)outMapX, mapX);
+        _mm256_store_si256((__m256i*)outMapY, mapY);
+        _mm256_store_si256((__m256i*)outCell, cell);
+        _mm256_store_si256((__m256i*)outSide, side);
+        _mm256_store_si256((__m256i*)outSteps, steps);
+        _mm256_store_si256((__m256i*)outTop, top);
+        _mm256_store_si256((__m256i*)outBottom, bottom);
+        StorePacket(hits + x, 8, outPerp, outWallX, outMapX, outMapY, outCell, outSide, outSteps, outTop, outBottom);
+    }
+    return x;
+}
+
+RC_TARGET_AVX2 static inline __m256i FloorTexel8(__m256 coord, __m256 sizeF, __m256i sizeMax) {
+    const __m256 frac = _mm256_sub_ps(coord, _mm256_floor_ps(coord));
+    return _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(frac, sizeF)), sizeMax);
+}
+
+RC_TARGET_AVX2 int CastFloorRowAVX2(const FloorRowSetup& row, const SoftwareTexture& texture, Color* dst, int colBegin, int colEnd) {
+    const __m256 originX = _mm256_set1_ps(row.originX);
+    const __m256 originY = _mm256_set1_ps(row.originY);
+    const __m256 stepX = _mm256_set1_ps(row.stepX);
+    const __m256 stepY = _mm256_set1_ps(row.stepY);
+    const __m256 widthF = _mm256_set1_ps((float)texture.width);
+    const __m256 heightF = _mm256_set1_ps((float)texture.height);
+    const __m256i widthMax = _mm256_set1_epi32(texture.width - 1);
+    const __m256i heightMax = _mm256_set1_epi32(texture.height - 1);
+    const __m256i xStride = _mm256_set1_epi32(texture.xStride);
+    const __m256i yStride = _mm256_set1_epi32(texture.yStride);
+    const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const int* texels = (const int*)texture.pixels;
+
+    int x = colBegin;
+    for (; x + 8 <= colEnd; x += 8) {
+        const __m256 xs = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(x), laneOffsets));
+        const __m256i texX = FloorTexel8(_mm256_add_ps(originX, _mm256_mul_ps(xs, stepX)), widthF, widthMax);
+        const __m256i texY = FloorTexel8(_mm256_add_ps(originY, _mm256_mul_ps(xs, stepY)), heightF, heightMax);
+        const __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(texX, xStride), _mm256_mullo_epi32(texY, yStride));
+        _mm256_storeu_si256((__m256i*)(dst + x), _mm256_i32gather_epi32(texels, index, 4));
+    }
+    return x;
+}
+
+RC_TARGET_AVX2 int CastRaysAVX2(const RaycastMapView& map, const float* posX, const float* posY, const float* dirX, const float* dirY,
+    int begin, int end, RaycastHit* hits) {
+    RayLanes<8> lanes;
+    int next = begin;
+    for (int lane = 0; lane < 8; ++lane) {
+        if (next < end) {
+            StartLane(lanes, lane, map, posX[next], posY[next], dirX[next], dirY[next], next);
+            ++next;
+        }
+        else {
+            ParkLane(lanes, lane);
+        }
+    }
+    if (lanes.ray[0] < 0) {
+        return end;
+    }
+
+    const __m256i zeroi = _mm256_setzero_si256();
+    const __m256i onei = _mm256_set1_epi32(1);
+    const __m256i allOnes = _mm256_set1_epi32(-1);
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i mapMaxX = _mm256_set1_epi32(map.width - 1);
+    const __m256i mapMaxY = _mm256_set1_epi32(map.height - 1);
+    // Gathers read 4 bytes, see CastCameraColumnsAVX2
+    const __m256i lastGather = _mm256_set1_epi32((int)((int64_t)map.width * map.height - 4));
+    const int* cellBase = (const int*)map.cells;
+    for (;;) {
+        const __m256 deltaDistX = _mm256_load_ps(lanes.deltaDistX);
+        const __m256 deltaDistY = _mm256_load_ps(lanes.deltaDistY);
+        const __m256i stepX = _mm256_load_si256((const __m256i*)lanes.stepX);
+        const __m256i stepY = _mm256_load_si256((const __m256i*)lanes.stepY);
+        const __m256i stepYRow = _mm256_load_si256((const __m256i*)lanes.stepYRow);
+        const __m256i active = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)lanes.ray), allOnes);
+        __m256 sideDistX = _mm256_load_ps(lanes.sideDistX);
+        __m256 sideDistY = _mm256_load_ps(lanes.sideDistY);
+        __m256i mapX = _mm256_load_si256((const __m256i*)lanes.mapX);
+        __m256i mapY = _mm256_load_si256((const __m256i*)lanes.mapY);
+        __m256i idx = _mm256_load_si256((const __m256i*)lanes.idx);
+        __m256i steps = _mm256_load_si256((const __m256i*)lanes.steps);
+
+        __m256i stepsY, fetched;
+        int finished;
+        do {
+            const __m256i stepsX = _mm256_castps_si256(_mm256_cmp_ps(sideDistX, sideDistY, _CMP_LT_OQ));
+            stepsY = _mm256_andnot_si256(stepsX, allOnes);
+            sideDistX = _mm256_blendv_ps(sideDistX, _mm256_add_ps(sideDistX, deltaDistX), _mm256_castsi256_ps(stepsX));
+            sideDistY = _mm256_blendv_ps(sideDistY, _mm256_add_ps(sideDistY, deltaDistY), _mm256_castsi256_ps(stepsY));
+            mapX = _mm256_add_epi32(mapX, _mm256_and_si256(stepX, stepsX));
+            mapY = _mm256_add_epi32(mapY, _mm256_and_si256(stepY, stepsY));
+            idx = _mm256_add_epi32(idx, _mm256_or_si256(_mm256_and_si256(stepX, stepsX), _mm256_and_si256(stepYRow, stepsY)));
+            steps = _mm256_add_epi32(steps, onei);
+
+            const __m256i out = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(zeroi, mapX), _mm256_cmpgt_epi32(mapX, mapMaxX)),
+                _mm256_or_si256(_mm256_cmpgt_epi32(zeroi, mapY), _mm256_cmpgt_epi32(mapY, mapMaxY)));
+            const __m256i gatherAt = _mm256_min_epi32(idx, lastGather);
+            const __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(idx, gatherAt), 3);
+            const __m256i gathered = _mm256_mask_i32gather_epi32(zeroi, cellBase, gatherAt, _mm256_andnot_si256(out, allOnes), 1);
+            fetched = _mm256_and_si256(_mm256_srlv_epi32(gathered, shift), byteMask);
+            const __m256i done = _mm256_and_si256(active, _mm256_or_si256(out, _mm256_andnot_si256(_mm256_cmpeq_epi32(fetched, zeroi), allOnes)));
+            finished = _mm256_movemask_ps(_mm256_castsi256_ps(done));
+        } while (finished == 0);
+
+        _mm256_store_ps(lanes.sideDistX, sideDistX);
+        _mm256_store_ps(lanes.sideDistY, sideDistY);
+        _mm256_store_si256((__m256i*)lanes.mapX, mapX);
+        _mm256_store_si256((__m256i*)lanes.mapY, mapY);
+        _mm256_store_si256((__m256i*)lanes.idx, idx);
+        _mm256_store_si256((__m256i*)lanes.steps, steps);
+        _mm256_store_si256((__m256i*)lanes.cell, fetched);
+        _mm256_store_si256((__m256i*)lanes.side, _mm256_and_si256(stepsY, onei));
+        if (!RefillLanes(lanes, (unsigned)finished, map, posX, posY, dirX, dirY, next, end, hits)) {
+            return end;
+        }
+    }
+}
+
+#else // !RAYCAST_X86_SIMD
+
+RaycastSimdLevel DetectRaycastSimdLevel() {
+    return RAYCAST_SIMD_SCALAR;
+}
+
+int CastCameraColumnsSSE2(const RaycastMapView&, const CameraRaySetup&, int colBegin, int, RaycastHit*) {
+    return colBegin;
+}
+
+int CastCameraColumnsAVX2(const RaycastMapView&, const CameraRaySetup&, int colBegin, int, RaycastHit*) {
+    return colBegin;
+}
+
+int CastRaysSSE2(const RaycastMapView&, const float*, const float*, const float*, const float*, int begin, int, RaycastHit*) {
+    return begin;
+}
+
+int CastRaysAVX2(const RaycastMapView&, const float*, const float*, const float*, const float*, int begin, int, RaycastHit*) {
+    return begin;
+}
+
+int CastFloorRowSSE2(const FloorRowSetup&, const SoftwareTexture&, Color*, int colBegin, int) {
+    return colBegin;
+}
+
+int CastFloorRowAVX2(const FloorRowSetup&, const SoftwareTexture&, Color*, int colBegin, int) {
+    return colBegin;
+}
+
+#endif
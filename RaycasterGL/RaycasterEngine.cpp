@@ -2,74 +2,677 @@
 #define RENDERINGENGINE_EXPORTS // Define this before including the header in the implementation file
 
 #include "RaycasterEngine.h"
-#include "raylib.h"
-#include <map>
+#include "RendererContext.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <limits.h>
+#include <math.h>
 #include <string>
-#include <vector> // Needed if using texture loading approach below
+#include <thread>
 
-// --- Global State (Managed within the DLL) ---
-int g_screenWidth = 0;
-int g_screenHeight = 0;
+// --- Renderer Context ---
+// The state lives in RendererContext.h; the contexts themselves are defined here.
 
-// Texture management: Map an ID provided to the EXE to the Raylib Texture object
-std::map<TextureID, Texture2D> g_textureMap;
-TextureID g_nextTextureID = 1; // Start IDs from 1 (0 can signify invalid/none)
+RendererContext g_defaultContext;
+thread_local RendererContext* t_boundContext = nullptr; // BindRendererContext
+// raylib keeps one window and GPU context per process, so only one renderer may use a windowed backend
+std::atomic<RendererContext*> g_windowContext{ nullptr };
+
+// Takes a free slot, or appends one. Call with textureMutex held and the table not full.
+static unsigned int AllocateTextureSlot(RendererContext& ctx) {
+    if (!ctx.freeTextureSlots.empty()) {
+        const unsigned int index = ctx.freeTextureSlots.back();
+        ctx.freeTextureSlots.pop_back();
+        return index;
+    }
+    ctx.textureSlots.emplace_back();
+    return (unsigned int)ctx.textureSlots.size() - 1;
+}
+
+static bool IsTextureTableFull(RendererContext& ctx) {
+    return ctx.freeTextureSlots.empty() && ctx.textureSlots.size() > kTextureIndexMask;
+}
+
+// Copies a texture's mip chain ('levels', row-major, laid out by slot.mipOffsets) into a free
+// block of an atlas page; UnloadTextureByID frees the block again.
+// Textures that do not fit keep working through their own Texture2D, unbatched.
+static void AddToAtlas(RendererContext& ctx, TextureSlot& slot, const std::vector<Color>& levels) {
+    const int blockWidth = MipChainBlockWidth(slot.width, slot.mipCount);
+    int page = -1, x = 0, y = 0;
+    for (size_t i = 0; i < ctx.atlasPages.size() && page < 0; ++i) {
+        if (ctx.atlasPages[i].packer.Allocate(blockWidth, slot.height, x, y)) page = (int)i;
+    }
+    if (page < 0 && (int)ctx.atlasPages.size() < kMaxAtlasPages) {
+        AtlasPage newPage;
+        Image blank = GenImageColor(kAtlasPageSize, kAtlasPageSize, BLANK);
+        newPage.texture = LoadTextureFromImage(blank);
+        UnloadImage(blank);
+        if (newPage.texture.id > 0 && newPage.packer.Allocate(blockWidth, slot.height, x, y)) {
+            ctx.atlasPages.push_back(newPage);
+            page = (int)ctx.atlasPages.size() - 1;
+        }
+        else if (newPage.texture.id > 0) {
+            UnloadTexture(newPage.texture);
+        }
+    }
+    if (page < 0) {
+        TraceLog(LOG_INFO, "RENDER DLL: Texture %dx%d not added to the wall atlas, slices will not batch", slot.width, slot.height);
+        return;
+    }
+
+    for (int l = 0; l < slot.mipCount; ++l) {
+        int offsetX, offsetY;
+        MipLevelOffset(slot.width, slot.height, l, offsetX, offsetY);
+        Rectangle region = { (float)(x + offsetX), (float)(y + offsetY),
+            (float)MipLevelWidth(slot.width, l), (float)MipLevelHeight(slot.height, l) };
+        UpdateTextureRec(ctx.atlasPages[page].texture, region, levels.data() + slot.mipOffsets[l]);
+    }
+    slot.atlasPage = page;
+    slot.atlasX = x;
+    slot.atlasY = y;
+}
+
+// Adds one textured quad to the open RL_QUADS batch
+void EmitQuad(RendererContext& ctx, const QueuedSlice& quad) {
+    rlCheckRenderBatchLimit(4);
+    rlColor4ub(quad.tint.r, quad.tint.g, quad.tint.b, quad.tint.a);
+    rlTexCoord2f(quad.u0, quad.v0);
+    rlVertex2f(quad.x, quad.y);
+    rlTexCoord2f(quad.u0, quad.v1);
+    rlVertex2f(quad.x, quad.y + quad.height);
+    rlTexCoord2f(quad.u1, quad.v1);
+    rlVertex2f(quad.x + quad.width, quad.y + quad.height);
+    rlTexCoord2f(quad.u1, quad.v0);
+    rlVertex2f(quad.x + quad.width, quad.y);
+    ++ctx.frameStats.batchedQuads;
+}
+
+// Draws the queued textured slices, one quad batch per atlas page. Called before any other
+// draw so the frame keeps its submission order.
+void FlushSliceBatch(RendererContext& ctx) {
+    if (ctx.sliceBatch.empty()) {
+        return;
+    }
+    for (size_t page = 0; page < ctx.atlasPages.size(); ++page) {
+        bool begun = false;
+        for (const QueuedSlice& slice : ctx.sliceBatch) {
+            if (slice.page != (int)page) continue;
+            if (!begun) {
+                CountGpuDraw(ctx, ctx.atlasPages[page].texture.id);
+                rlSetTexture(ctx.atlasPages[page].texture.id);
+                rlBegin(RL_QUADS);
+                begun = true;
+            }
+            EmitQuad(ctx, slice);
+        }
+        if (begun) {
+            rlEnd();
+            rlSetTexture(0);
+        }
+    }
+    ctx.sliceBatch.clear();
+}
+
+// --- Dynamic Resolution ---
+
+// Screen rows per work-stealing band when stretching the view
+static const int kStretchBandRows = 16;
+
+static void ComputeViewSize(RendererContext& ctx, float scale, int& viewWidth, int& viewHeight) {
+    viewWidth = std::clamp((int)lroundf((float)ctx.screenWidth * scale), 1, ctx.screenWidth);
+    viewHeight = std::clamp((int)lroundf((float)ctx.screenHeight * scale), 1, ctx.screenHeight);
+}
+
+bool IsViewScaled(RendererContext& ctx) {
+    return ctx.viewWidth != ctx.screenWidth || ctx.viewHeight != ctx.screenHeight;
+}
+
+// Points drawing at the reduced-resolution view target, if the frame has one
+static void BeginScaledView(RendererContext& ctx) {
+    if (ctx.viewActive || !IsViewScaled(ctx)) {
+        return;
+    }
+    if (IsSoftwareBackend(ctx)) {
+        ctx.viewBuffer.resize((size_t)ctx.viewWidth * ctx.viewHeight);
+        ctx.softwareTarget.pixels = ctx.viewBuffer.data();
+        ctx.softwareTarget.width = ctx.viewWidth;
+        ctx.softwareTarget.height = ctx.viewHeight;
+        SwClear(ctx.softwareTarget, BLACK);
+    }
+    else {
+        if (ctx.viewTexture.id == 0) {
+            ctx.viewTexture = LoadRenderTexture(ctx.screenWidth, ctx.screenHeight);
+        }
+        FlushSliceBatch(ctx);
+        BeginTextureMode(ctx.viewTexture);
+        ClearBackground(BLACK);
+    }
+    ctx.viewActive = true;
+}
+
+// Stretches the view to the screen and points drawing back at it. Every draw outside the native
+// view calls this first.
+static void FinishScaledView(RendererContext& ctx) {
+    if (!ctx.viewActive) {
+        return;
+    }
+    ctx.viewActive = false;
+    const auto start = FrameProfiler::Clock::now();
+    if (IsSoftwareBackend(ctx)) {
+        const SoftwareTarget view = ctx.softwareTarget;
+        ctx.softwareTarget.pixels = ctx.framebuffer.data();
+        ctx.softwareTarget.width = ctx.screenWidth;
+        ctx.softwareTarget.height = ctx.screenHeight;
+        ctx.stretchColumns.resize(ctx.screenWidth);
+        for (int x = 0; x < ctx.screenWidth; ++x) {
+            ctx.stretchColumns[x] = (int)((2LL * x + 1) * view.width / (2LL * ctx.screenWidth));
+        }
+        auto stretchBand = [&](int rowBegin, int rowEnd, int) {
+            SwStretchRows(ctx.softwareTarget, view, ctx.stretchColumns.data(), rowBegin, rowEnd);
+        };
+        ctx.workerPool.ParallelFor(ctx.screenHeight, kStretchBandRows, stretchBand);
+    }
+    else {
+        FlushSliceBatch(ctx);
+        EndTextureMode();
+        // Render textures are stored bottom-up: the view is the last rows, flipped
+        const float textureHeight = (float)ctx.viewTexture.texture.height;
+        Rectangle source = { 0.0f, textureHeight - (float)ctx.viewHeight, (float)ctx.viewWidth, -(float)ctx.viewHeight };
+        Rectangle dest = { 0.0f, 0.0f, (float)ctx.screenWidth, (float)ctx.screenHeight };
+        DrawTexturePro(ctx.viewTexture.texture, source, dest, Vector2{ 0.0f, 0.0f }, 0.0f, WHITE);
+        CountGpuDraw(ctx, ctx.viewTexture.texture.id);
+    }
+    ctx.profiler.EndStage(PROFILE_STAGE_UPSCALE, start);
+}
+
+void SetRenderScale(float scale) {
+    RendererContext& ctx = CurrentContext();
+    std::lock_guard<std::mutex> lock(ctx.resolutionMutex);
+    ctx.resolution.SetFixed(scale);
+}
+
+void SetRenderScaleBudget(float budgetMs, float minScale, float maxScale) {
+    RendererContext& ctx = CurrentContext();
+    std::lock_guard<std::mutex> lock(ctx.resolutionMutex);
+    ctx.resolution.SetBudget(budgetMs, minScale, maxScale);
+}
+
+RenderScaleStatus GetRenderScaleStatus() {
+    RendererContext& ctx = CurrentContext();
+    RenderScaleStatus status = {};
+    {
+        std::lock_guard<std::mutex> lock(ctx.resolutionMutex);
+        ctx.resolution.GetStatus(status);
+    }
+    ComputeViewSize(ctx, status.scale, status.viewWidth, status.viewHeight);
+    return status;
+}
+
+static void InstallLoadedTextures(RendererContext& ctx);
+static void CaptureFrame(RendererContext& ctx);
+static void StopCaptureState(RendererContext& ctx);
+static void CollectInputEvents(RendererContext& ctx);
+static void PaceFrame(RendererContext& ctx, double inputTime);
+
+// Render thread: publishes what the caller may ask about input and the window
+void PublishInputState(RendererContext& ctx) {
+    if (!HasWindow(ctx)) {
+        return;
+    }
+    InputSnapshot snapshot;
+    for (int key = 0; key < kInputKeyCount; ++key) snapshot.keys[key] = IsKeyDown(key);
+    for (int button = 0; button < kInputMouseButtons; ++button) snapshot.mouseButtons[button] = IsMouseButtonDown(button);
+    snapshot.mousePosition = GetMousePosition();
+    {
+        std::lock_guard<std::mutex> lock(ctx.inputMutex);
+        ctx.inputSnapshot = snapshot;
+    }
+    ctx.windowCloseRequested.store(::WindowShouldClose(), std::memory_order_release);
+}
+
+// --- Renderer Contexts ---
+
+RendererContext* CreateRendererContext() {
+    return new RendererContext();
+}
+
+void DestroyRendererContext(RendererContext* context) {
+    if (context == nullptr) {
+        return;
+    }
+    if (context == &g_defaultContext) {
+        TraceLog(LOG_WARNING, "RENDER DLL: The default renderer context cannot be destroyed");
+        return;
+    }
+    RendererContext* previous = BindRendererContext(context);
+    ShutdownRenderer(); // Does nothing harmful on a context that was never initialized
+    BindRendererContext(previous == context ? nullptr : previous);
+    delete context;
+}
+
+RendererContext* GetDefaultRendererContext() {
+    return &g_defaultContext;
+}
+
+RendererContext* BindRendererContext(RendererContext* context) {
+    RendererContext* previous = &CurrentContext();
+    t_boundContext = (context == &g_defaultContext) ? nullptr : context;
+    return previous;
+}
+
+RendererContext* GetBoundRendererContext() {
+    return &CurrentContext();
+}
 
 // --- Exported Function Implementations ---
 
 bool InitRenderer(int screenWidth, int screenHeight, const char* windowTitle) {
-    g_screenWidth = screenWidth;
-    g_screenHeight = screenHeight;
-    InitWindow(g_screenWidth, g_screenHeight, windowTitle);
-    if (!IsWindowReady()) {
+    RendererConfig config;
+    config.screenWidth = screenWidth;
+    config.screenHeight = screenHeight;
+    config.windowTitle = windowTitle;
+    config.backend = RENDERER_BACKEND_RAYLIB;
+    return InitRenderer(config);
+}
+
+// Body of InitRenderer, on the thread that will own the window
+static bool InitRendererState(RendererContext& ctx, const RendererConfig& config) {
+    if (config.screenWidth <= 0 || config.screenHeight <= 0) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Invalid screen size %dx%d", config.screenWidth, config.screenHeight);
         return false;
     }
+    if (config.backend != RENDERER_BACKEND_SOFTWARE) {
+        RendererContext* owner = nullptr;
+        if (!g_windowContext.compare_exchange_strong(owner, &ctx) && owner != &ctx) {
+            TraceLog(LOG_WARNING, "RENDER DLL: Another renderer context has the window, only RENDERER_BACKEND_SOFTWARE can run beside it");
+            return false;
+        }
+    }
+    ctx.screenWidth = config.screenWidth;
+    ctx.screenHeight = config.screenHeight;
+    ctx.backend = config.backend;
+
+    if (HasWindow(ctx)) {
+        InitWindow(ctx.screenWidth, ctx.screenHeight, config.windowTitle ? config.windowTitle : "");
+        if (!IsWindowReady()) {
+            g_windowContext.store(nullptr);
+            return false;
+        }
+    }
     // SetTargetFPS(60); // FPS can be controlled here or in the EXE loop logic
-    g_textureMap.clear();
-    g_nextTextureID = 1;
+
+    if (IsSoftwareBackend(ctx)) {
+        ctx.framebuffer.assign((size_t)ctx.screenWidth * ctx.screenHeight, BLACK);
+        ctx.softwareTarget.pixels = ctx.framebuffer.data();
+        ctx.softwareTarget.width = ctx.screenWidth;
+        ctx.softwareTarget.height = ctx.screenHeight;
+    }
+    if (ctx.backend == RENDERER_BACKEND_SOFTWARE_WINDOWED) {
+        Image frame = { ctx.framebuffer.data(), ctx.screenWidth, ctx.screenHeight, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        ctx.presentTexture = LoadTextureFromImage(frame);
+    }
+
+    ctx.workerPool.Start(config.workerThreads);
+    TraceLog(LOG_INFO, "RENDER DLL: Raycasting on %d worker thread(s)", ctx.workerPool.GetWorkerCount());
+
+    {
+        std::lock_guard<std::mutex> lock(ctx.textureMutex);
+        ctx.textureSlots.clear();
+        ctx.freeTextureSlots.clear();
+    }
+    ctx.textureLoadThreads = config.textureLoadThreads;
+    ctx.raycastReuse.valid = false;
+    ctx.raycastReuseEnabled.store(config.frameReuse, std::memory_order_relaxed);
+    ctx.texturePlaceholder.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(ctx.resolutionMutex);
+        ctx.resolution.SetFixed(config.renderScale);
+        ctx.resolution.SetBudget(config.frameBudgetMs, config.minRenderScale, config.renderScale);
+        ComputeViewSize(ctx, ctx.resolution.GetScale(), ctx.viewWidth, ctx.viewHeight);
+    }
+    ctx.viewActive = false;
+    ctx.sliceBatch.clear();
+    ctx.frameStats = RendererStats{};
+    ctx.profiler.Reset();
+
+    ctx.timeBase = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(ctx.pacingMutex);
+        ctx.pacer.Reset();
+    }
+    ctx.inputEvents.Clear();
+    ctx.polledEvents.reserve(2 * (kInputKeyCount + kInputMouseButtons) + 2); // Down and up per key and button, move, wheel
+    memset(ctx.polledKeys, 0, sizeof(ctx.polledKeys));
+    memset(ctx.polledMouseButtons, 0, sizeof(ctx.polledMouseButtons));
+    ctx.polledMousePosition = Vector2{ 0.0f, 0.0f };
+    {
+        std::lock_guard<std::mutex> lock(ctx.inputMutex);
+        ctx.inputReadTime = -1.0;
+    }
     return true;
 }
 
-void ShutdownRenderer() {
-    // Unload all textures managed by the DLL
-    for (auto const& [id, texture] : g_textureMap) {
-        UnloadTexture(texture);
+bool InitRenderer(const RendererConfig& config) {
+    RendererContext& ctx = CurrentContext();
+    const int framesInFlight = std::clamp(config.framesInFlight, 0, RENDERER_MAX_FRAMES_IN_FLIGHT);
+    if (framesInFlight == 0) {
+        return InitRendererState(ctx, config);
+    }
+
+    ctx.renderThread.Start(framesInFlight, ReplayFrame, &ctx);
+    ctx.recordedViewReady = false;
+    ctx.windowCloseRequested.store(false, std::memory_order_relaxed);
+    bool success = false;
+    auto init = [&] {
+        t_boundContext = &ctx; // For the rest of the render thread's life
+        success = InitRendererState(ctx, config);
+        if (success) PublishInputState(ctx);
+    };
+    ctx.renderThread.RunOnThread(init);
+    if (!success) {
+        ctx.renderThread.Stop();
+        return false;
+    }
+    TraceLog(LOG_INFO, "RENDER DLL: Pipelined on a render thread, up to %d frame(s) in flight", framesInFlight);
+    return true;
+}
+
+// Body of ShutdownRenderer, on the thread that owns the window
+static void ShutdownRendererState(RendererContext& ctx) {
+    StopCaptureState(ctx);
+    // Unload all textures managed by the DLL, abandoning the ones still decoding
+    ctx.textureLoader.Stop();
+    ctx.decodedTextures.clear();
+    for (const TextureSlot& slot : ctx.textureSlots) {
+        if (slot.live && slot.gpu.id > 0) UnloadTexture(slot.gpu);
+    }
+    {
+        std::lock_guard<std::mutex> lock(ctx.textureMutex);
+        ctx.textureSlots.clear();
+        ctx.freeTextureSlots.clear();
+    }
+    for (const AtlasPage& page : ctx.atlasPages) {
+        UnloadTexture(page.texture);
+    }
+    ctx.atlasPages.clear();
+    ctx.sliceBatch.clear();
+    if (ctx.planeTexture.id > 0) {
+        UnloadTexture(ctx.planeTexture);
+        ctx.planeTexture = Texture2D{};
+    }
+    ctx.planeBuffer.clear();
+    ctx.planeBuffer.shrink_to_fit();
+    if (ctx.viewTexture.id > 0) {
+        UnloadRenderTexture(ctx.viewTexture);
+        ctx.viewTexture = RenderTexture2D{};
+    }
+    ctx.viewBuffer.clear();
+    ctx.viewBuffer.shrink_to_fit();
+    ctx.viewActive = false;
+    ctx.lightmap.Clear();
+    ctx.dirtyLightChunks.clear();
+    ctx.batchScratch.clear();
+    ctx.batchScratch.shrink_to_fit();
+    ctx.workerPool.Stop();
+
+    if (ctx.presentTexture.id > 0) {
+        UnloadTexture(ctx.presentTexture);
+        ctx.presentTexture = Texture2D{};
+    }
+    ctx.framebuffer.clear();
+    ctx.framebuffer.shrink_to_fit();
+    ctx.softwareTarget = SoftwareTarget{};
+
+    if (HasWindow(ctx) && g_windowContext.load() == &ctx) {
+        CloseWindow();
+        g_windowContext.store(nullptr);
     }
-    g_textureMap.clear();
-    CloseWindow();
+}
+
+void ShutdownRenderer() {
+    RendererContext& ctx = CurrentContext();
+    auto shutdown = [&] { ShutdownRendererState(ctx); };
+    ctx.renderThread.RunOnThread(shutdown);
+    ctx.renderThread.Stop();
 }
 
 bool Renderer_WindowShouldClose() {
+    RendererContext& ctx = CurrentContext();
+    if (!HasWindow(ctx)) {
+        return false; // Headless renderers run until the caller stops
+    }
+    if (IsRecording(ctx)) {
+        return ctx.windowCloseRequested.load(std::memory_order_acquire);
+    }
     return ::WindowShouldClose(); // Use Raylib's function directly
 }
 
+static float CurrentRenderScale(RendererContext& ctx) {
+    std::lock_guard<std::mutex> lock(ctx.resolutionMutex);
+    return ctx.resolution.GetScale();
+}
+
 void BeginFrame() {
-    BeginDrawing();
-    ClearBackground(BLACK); // Default clear color, could be configurable
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        ctx.renderThread.GetRecordBuffer();
+        RecBeginFrame* command = RecordCommand<RecBeginFrame>(ctx, REC_BEGIN_FRAME);
+        command->waitMs = ctx.renderThread.TakeWaitMs();
+        command->renderScale = CurrentRenderScale(ctx);
+        ComputeViewSize(ctx, command->renderScale, ctx.recordedViewWidth, ctx.recordedViewHeight);
+        ctx.recordedViewReady = false;
+        return;
+    }
+    BeginFrameAtScale(ctx, CurrentRenderScale(ctx));
+}
+
+// Body of BeginFrame, on the thread that renders. A replayed frame uses the scale read when it
+// was recorded.
+void BeginFrameAtScale(RendererContext& ctx, float renderScale) {
+    ctx.profiler.BeginFrame();
+    const auto start = FrameProfiler::Clock::now();
+    ctx.frameStats = RendererStats{};
+    ctx.boundTexture = 0;
+    ctx.raycastViewReady = false;
+    ctx.frameStats.renderScale = renderScale;
+    ComputeViewSize(ctx, ctx.frameStats.renderScale, ctx.viewWidth, ctx.viewHeight);
+    ctx.frameStats.viewWidth = ctx.viewWidth;
+    ctx.frameStats.viewHeight = ctx.viewHeight;
+    InstallLoadedTextures(ctx);
+    if (IsSoftwareBackend(ctx)) {
+        SwClear(ctx.softwareTarget, BLACK);
+    }
+    else {
+        BeginDrawing();
+        ClearBackground(BLACK); // Default clear color, could be configurable
+    }
+    ctx.profiler.EndStage(PROFILE_STAGE_BEGIN, start);
+}
+
+// Body of EndFrame, on the thread that renders. inputTime is the caller's RecEndFrame::inputTime.
+void PresentFrame(RendererContext& ctx, double inputTime) {
+    FinishScaledView(ctx);
+    const auto start = FrameProfiler::Clock::now();
+    // SOFTWARE: the frame is already complete in framebuffer
+    if (IsSoftwareBackend(ctx)) {
+        CaptureFrame(ctx);
+    }
+    if (ctx.backend != RENDERER_BACKEND_SOFTWARE) {
+        if (ctx.backend == RENDERER_BACKEND_SOFTWARE_WINDOWED) {
+            UpdateTexture(ctx.presentTexture, ctx.framebuffer.data());
+            BeginDrawing();
+            DrawTexture(ctx.presentTexture, 0, 0, WHITE);
+            CountGpuDraw(ctx, ctx.presentTexture.id);
+        }
+        FlushSliceBatch(ctx);
+        if (ctx.backend == RENDERER_BACKEND_RAYLIB) {
+            CaptureFrame(ctx);
+        }
+        EndDrawing();
+    }
+    ctx.profiler.EndStage(PROFILE_STAGE_PRESENT, start);
+    ctx.profiler.EndFrame(ctx.frameStats);
+
+    const RendererStats& stats = ctx.frameStats;
+    const float renderMs = stats.beginMs + stats.lightingMs + stats.floorMs + stats.raycastMs + stats.wallMs + stats.spritesMs +
+        stats.textMs + stats.commandsMs + stats.upscaleMs;
+    {
+        std::lock_guard<std::mutex> lock(ctx.resolutionMutex);
+        ctx.resolution.Update(renderMs);
+    }
+    PaceFrame(ctx, inputTime);
 }
 
 void EndFrame() {
-    EndDrawing();
+    RendererContext& ctx = CurrentContext();
+    double inputTime;
+    {
+        std::lock_guard<std::mutex> lock(ctx.inputMutex);
+        inputTime = ctx.inputReadTime;
+        ctx.inputReadTime = -1.0;
+    }
+    if (IsRecording(ctx)) {
+        RecordCommand<RecEndFrame>(ctx, REC_END_FRAME)->inputTime = inputTime;
+        ctx.renderThread.Submit();
+        return;
+    }
+    PresentFrame(ctx, inputTime);
+}
+
+// Reads texture.path and builds its mip chain, row-major for the GPU and transposed for the CPU.
+// Touches no engine state, so the loader threads call it too.
+static void DecodeTextureFile(DecodedTexture& texture) {
+    Image image = LoadImage(texture.path.c_str());
+    if (image.data == nullptr) {
+        texture.ok = false;
+        return;
+    }
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.mipCount = MipLevelCount(image.width, image.height);
+    BuildMipChain((const Color*)image.data, image.width, image.height, texture.mipCount, texture.levels, texture.mipOffsets);
+    UnloadImage(image);
+
+    // Transpose every level once at load time; every frame then reads wall columns sequentially
+    texture.columns.resize(texture.levels.size());
+    for (int l = 0; l < texture.mipCount; ++l) {
+        const int levelW = MipLevelWidth(texture.width, l);
+        const int levelH = MipLevelHeight(texture.height, l);
+        const Color* rows = texture.levels.data() + texture.mipOffsets[l];
+        Color* columns = texture.columns.data() + texture.mipOffsets[l];
+        for (int y = 0; y < levelH; ++y) {
+            for (int x = 0; x < levelW; ++x) {
+                columns[(size_t)x * levelH + y] = rows[(size_t)y * levelW + x];
+            }
+        }
+    }
+    texture.ok = true;
+}
+
+// Builds a ready slot from a decoded texture, uploading it on GPU backends. Must run on the thread
+// that owns the GPU context.
+static bool InstallTexture(RendererContext& ctx, DecodedTexture& decoded, TextureSlot& loaded) {
+    loaded.width = decoded.width;
+    loaded.height = decoded.height;
+    loaded.mipCount = decoded.mipCount;
+    memcpy(loaded.mipOffsets, decoded.mipOffsets, sizeof(loaded.mipOffsets));
+    if (!IsSoftwareBackend(ctx)) {
+        Image image = { decoded.levels.data(), decoded.width, decoded.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        loaded.gpu = LoadTextureFromImage(image);
+        if (loaded.gpu.id <= 0) { // Check if loading failed (texture.id will be > 0 on success)
+            return false;
+        }
+        AddToAtlas(ctx, loaded, decoded.levels);
+    }
+    loaded.columns = std::move(decoded.columns);
+    loaded.live = true;
+    loaded.status = TEXTURE_STATUS_READY;
+    return true;
+}
+
+// Uploads the textures the loader has finished into their reserved slots
+static void InstallLoadedTextures(RendererContext& ctx) {
+    if (!ctx.textureLoader.IsRunning()) {
+        return;
+    }
+    ctx.textureLoader.TakeFinished(ctx.decodedTextures);
+    for (DecodedTexture& decoded : ctx.decodedTextures) {
+        TextureSlot* slot = FindTextureSlot(ctx, decoded.textureId);
+        if (slot == nullptr || slot->status != TEXTURE_STATUS_PENDING) {
+            continue; // Unloaded while it was decoding
+        }
+        TextureSlot loaded;
+        const bool installed = decoded.ok && InstallTexture(ctx, decoded, loaded);
+        std::lock_guard<std::mutex> lock(ctx.textureMutex);
+        if (installed) {
+            loaded.generation = slot->generation;
+            *slot = std::move(loaded);
+            TraceLog(LOG_INFO, "RENDER DLL: Loaded texture '%s' with ID %u", decoded.path.c_str(), decoded.textureId);
+        }
+        else {
+            slot->status = TEXTURE_STATUS_FAILED;
+            TraceLog(LOG_WARNING, "RENDER DLL: Failed to load texture: %s", decoded.path.c_str());
+        }
+    }
+    ctx.decodedTextures.clear();
 }
 
 TextureID LoadTextureFromPath(const char* filePath) {
-    Texture2D texture = LoadTexture(filePath);
-    if (texture.id <= 0) { // Check if loading failed (texture.id will be > 0 on success)
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        TextureID textureId = 0;
+        auto load = [&] { textureId = LoadTextureFromPath(filePath); };
+        ctx.renderThread.RunOnThread(load);
+        return textureId;
+    }
+    if (IsTextureTableFull(ctx)) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Too many textures loaded, cannot load: %s", filePath);
+        return 0;
+    }
+
+    DecodedTexture decoded;
+    decoded.path = filePath ? filePath : "";
+    DecodeTextureFile(decoded);
+    TextureSlot loaded;
+    if (!decoded.ok || !InstallTexture(ctx, decoded, loaded)) {
         TraceLog(LOG_WARNING, "RENDER DLL: Failed to load texture: %s", filePath);
         return 0; // Return 0 (invalid ID) on failure
     }
 
-    TextureID currentId = g_nextTextureID++;
-    g_textureMap[currentId] = texture;
+    std::lock_guard<std::mutex> lock(ctx.textureMutex);
+    const unsigned int index = AllocateTextureSlot(ctx);
+    TextureSlot& slot = ctx.textureSlots[index];
+    loaded.generation = slot.generation;
+    slot = std::move(loaded);
+    TextureID currentId = MakeTextureID(index, slot.generation);
     TraceLog(LOG_INFO, "RENDER DLL: Loaded texture '%s' with ID %u", filePath, currentId);
     return currentId;
 }
 
 void UnloadTextureByID(TextureID textureId) {
-    auto it = g_textureMap.find(textureId);
-    if (it != g_textureMap.end()) {
-        UnloadTexture(it->second); // Unload Raylib texture
-        g_textureMap.erase(it);    // Remove from map
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        auto unload = [&] { UnloadTextureByID(textureId); };
+        ctx.renderThread.RunOnThread(unload);
+        return;
+    }
+    TextureSlot* slot = FindTextureSlot(ctx, textureId);
+    if (slot != nullptr) {
+        if (slot->gpu.id > 0) UnloadTexture(slot->gpu); // Unload Raylib texture
+        if (slot->atlasPage >= 0) {
+            // Draw everything that may still sample the block before a later load overwrites it
+            FlushSliceBatch(ctx);
+            rlDrawRenderBatchActive();
+            ctx.atlasPages[slot->atlasPage].packer.Free(slot->atlasX, slot->atlasY,
+                MipChainBlockWidth(slot->width, slot->mipCount), slot->height);
+        }
+        std::lock_guard<std::mutex> lock(ctx.textureMutex);
+        const unsigned int generation = slot->generation + 1;
+        *slot = TextureSlot{};
+        // Skip generation 0 on wrap-around so IDs stay non-zero
+        slot->generation = (generation >= (1u << (32 - kTextureIndexBits))) ? 1 : generation;
+        ctx.freeTextureSlots.push_back(textureId & kTextureIndexMask);
         TraceLog(LOG_INFO, "RENDER DLL: Unloaded texture with ID %u", textureId);
     }
     else {
@@ -77,27 +680,173 @@ void UnloadTextureByID(TextureID textureId) {
     }
 }
 
+// --- Asynchronous Texture Loading ---
+
+int LoadTexturesAsync(const char* const* filePaths, int count, TextureID* ids) {
+    RendererContext& ctx = CurrentContext();
+    if (filePaths == nullptr || ids == nullptr || count <= 0) {
+        return 0;
+    }
+    if (IsRecording(ctx)) {
+        int queued = 0;
+        auto load = [&] { queued = LoadTexturesAsync(filePaths, count, ids); };
+        ctx.renderThread.RunOnThread(load);
+        return queued;
+    }
+    if (!ctx.textureLoader.IsRunning()) {
+        ctx.textureLoader.Start(ctx.textureLoadThreads, DecodeTextureFile);
+    }
+
+    int queued = 0;
+    std::lock_guard<std::mutex> lock(ctx.textureMutex);
+    for (int i = 0; i < count; ++i) {
+        ids[i] = 0;
+        if (filePaths[i] == nullptr) {
+            continue;
+        }
+        if (IsTextureTableFull(ctx)) {
+            TraceLog(LOG_WARNING, "RENDER DLL: Too many textures loaded, cannot load: %s", filePaths[i]);
+            continue;
+        }
+        const unsigned int index = AllocateTextureSlot(ctx);
+        TextureSlot& slot = ctx.textureSlots[index];
+        slot.live = true;
+        slot.status = TEXTURE_STATUS_PENDING;
+        ids[i] = MakeTextureID(index, slot.generation);
+        ctx.textureLoader.Enqueue(ids[i], filePaths[i]);
+        ++queued;
+    }
+    return queued;
+}
+
+TextureID LoadTextureFromPathAsync(const char* filePath) {
+    TextureID textureId = 0;
+    LoadTexturesAsync(&filePath, 1, &textureId);
+    return textureId;
+}
+
+TextureLoadStatus GetTextureLoadStatus(TextureID textureId) {
+    RendererContext& ctx = CurrentContext();
+    std::lock_guard<std::mutex> lock(ctx.textureMutex);
+    const TextureSlot* slot = FindTextureSlot(ctx, textureId);
+    return (slot != nullptr) ? slot->status : TEXTURE_STATUS_INVALID;
+}
+
+int GetPendingTextureCount() {
+    RendererContext& ctx = CurrentContext();
+    return ctx.textureLoader.GetPendingCount();
+}
+
+void WaitForTextureLoads() {
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        auto wait = [] { WaitForTextureLoads(); };
+        ctx.renderThread.RunOnThread(wait);
+        return;
+    }
+    if (ctx.textureLoader.IsRunning()) {
+        ctx.textureLoader.WaitIdle();
+        InstallLoadedTextures(ctx);
+    }
+}
+
+void SetTexturePlaceholder(TextureID placeholder) {
+    RendererContext& ctx = CurrentContext();
+    ctx.texturePlaceholder.store(placeholder, std::memory_order_relaxed);
+}
+
+TextureID GetTexturePlaceholder() {
+    RendererContext& ctx = CurrentContext();
+    return ctx.texturePlaceholder.load(std::memory_order_relaxed);
+}
+
 void DrawWallSlice(int screenX, int drawStartY, int drawEndY, Color color) {
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        *RecordCommand<RecShape>(ctx, REC_WALL_SLICE) = RecShape{ screenX, drawStartY, drawEndY, 0, color };
+        return;
+    }
+    FinishScaledView(ctx);
+    if (IsSoftwareBackend(ctx)) {
+        SwDrawColumn(ctx.softwareTarget, screenX, drawStartY, drawEndY, color);
+        return;
+    }
     // Ensure coordinates are within bounds (optional, but good practice)
-    // if (screenX < 0 || screenX >= g_screenWidth) return;
-    // drawStartY = Clamp(drawStartY, 0, g_screenHeight - 1);
-    // drawEndY = Clamp(drawEndY, 0, g_screenHeight - 1);
+    // if (screenX < 0 || screenX >= screenWidth) return;
+    // drawStartY = Clamp(drawStartY, 0, screenHeight - 1);
+    // drawEndY = Clamp(drawEndY, 0, screenHeight - 1);
     // if (drawStartY >= drawEndY) return;
 
+    FlushSliceBatch(ctx);
     DrawLine(screenX, drawStartY, screenX, drawEndY, color);
+    CountGpuDraw(ctx, 0);
     // Or DrawRectangle(screenX, drawStartY, 1, drawEndY - drawStartY + 1, color);
 }
 
 void DrawTexturedWallSlice(int screenX, int drawStartY, int drawEndY, float drawWidth,
     TextureID textureId, float texCoordX, Color tint) {
-    auto it = g_textureMap.find(textureId);
-    if (it == g_textureMap.end()) {
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        *RecordCommand<RecTexturedSlice>(ctx, REC_TEXTURED_SLICE) = RecTexturedSlice{ screenX, drawStartY, drawEndY, drawWidth, textureId, texCoordX, tint };
+        return;
+    }
+    FinishScaledView(ctx);
+    ++ctx.frameStats.texturedSlices;
+    const TextureSlot* slot = FindTexture(ctx, textureId);
+    if (slot == nullptr) {
         // Draw error color or do nothing if texture ID is invalid
-        DrawRectangle(screenX, drawStartY, (int)drawWidth, drawEndY - drawStartY, MAGENTA);
+        DrawScreenRectangle(screenX, drawStartY, (int)drawWidth, drawEndY - drawStartY, MAGENTA);
+        return;
+    }
+
+    // Far walls sample a smaller mip level so neighbouring columns do not alias
+    const int spanHeight = drawEndY - drawStartY;
+    const int level = SelectMipLevel(slot->height, spanHeight, slot->mipCount);
+
+    if (IsSoftwareBackend(ctx)) {
+        ctx.frameStats.textureLookups += SwDrawTexturedColumn(ctx.softwareTarget, screenX, drawStartY, drawEndY, drawWidth,
+            SoftwareTextureFromSlot(*slot, level), texCoordX, tint);
         return;
     }
 
-    Texture2D texture = it->second;
+    if (slot->atlasPage >= 0) {
+        if (spanHeight <= 0 || drawWidth <= 0.0f) {
+            return;
+        }
+        const int levelWidth = MipLevelWidth(slot->width, level);
+        int offsetX, offsetY;
+        MipLevelOffset(slot->width, slot->height, level, offsetX, offsetY);
+        const int texX = std::clamp((int)(texCoordX * levelWidth), 0, levelWidth - 1);
+        const float texel = 1.0f / (float)kAtlasPageSize;
+
+        QueuedSlice slice;
+        slice.x = (float)screenX;
+        slice.y = (float)drawStartY;
+        slice.width = drawWidth;
+        slice.height = (float)spanHeight;
+        slice.u0 = (float)(slot->atlasX + offsetX + texX) * texel;
+        slice.u1 = slice.u0 + texel;
+        slice.v0 = (float)(slot->atlasY + offsetY) * texel;
+        slice.v1 = (float)(slot->atlasY + offsetY + MipLevelHeight(slot->height, level)) * texel;
+        slice.tint = tint;
+        slice.page = slot->atlasPage;
+
+        // Magnified near walls repeat the same texel column: widen the previous quad instead
+        if (!ctx.sliceBatch.empty()) {
+            QueuedSlice& last = ctx.sliceBatch.back();
+            if (last.page == slice.page && last.u0 == slice.u0 && last.v0 == slice.v0 && last.v1 == slice.v1 &&
+                last.y == slice.y && last.height == slice.height && last.x + last.width == slice.x &&
+                last.tint.r == tint.r && last.tint.g == tint.g && last.tint.b == tint.b && last.tint.a == tint.a) {
+                last.width += slice.width;
+                return;
+            }
+        }
+        ctx.sliceBatch.push_back(slice);
+        return;
+    }
+
+    FlushSliceBatch(ctx);
+    Texture2D texture = slot->gpu;
 
     // Calculate the source rectangle within the texture
     // texCoordX is the normalized X coordinate (0..1)
@@ -113,36 +862,1210 @@ void DrawTexturedWallSlice(int screenX, int drawStartY, int drawEndY, float draw
 
     // Use DrawTexturePro for precise control over source/dest rectangles
     DrawTexturePro(texture, sourceRec, destRec, Vector2{ 0, 0 }, 0.0f, tint);
+    CountGpuDraw(ctx, texture.id);
 }
 
 
 void DrawSprite(TextureID textureId, Rectangle sourceRec, Rectangle destRec, Vector2 origin, float rotation, Color tint) {
-    auto it = g_textureMap.find(textureId);
-    if (it != g_textureMap.end()) {
-        DrawTexturePro(it->second, sourceRec, destRec, origin, rotation, tint);
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        *RecordCommand<RecSprite>(ctx, REC_SPRITE) = RecSprite{ textureId, sourceRec, destRec, origin, rotation, tint };
+        return;
     }
-    else {
+    FinishScaledView(ctx);
+    const TextureSlot* slot = FindTexture(ctx, textureId);
+    if (slot == nullptr) {
         // Draw error color if texture ID is invalid
-        DrawRectangleRec(destRec, MAGENTA);
+        if (IsSoftwareBackend(ctx)) SwFillRect(ctx.softwareTarget, (int)destRec.x, (int)destRec.y, (int)destRec.width, (int)destRec.height, MAGENTA);
+        else {
+            FlushSliceBatch(ctx);
+            DrawRectangleRec(destRec, MAGENTA);
+            CountGpuDraw(ctx, 0);
+        }
+    }
+    else if (IsSoftwareBackend(ctx)) {
+        ctx.frameStats.textureLookups += SwDrawTexturePro(ctx.softwareTarget, SoftwareTextureFromSlot(*slot), sourceRec, destRec, origin, rotation, tint);
+    }
+    else {
+        FlushSliceBatch(ctx);
+        DrawTexturePro(slot->gpu, sourceRec, destRec, origin, rotation, tint);
+        CountGpuDraw(ctx, slot->gpu.id);
     }
 }
 
 void DrawScreenRectangle(int posX, int posY, int width, int height, Color color) {
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        *RecordCommand<RecShape>(ctx, REC_RECT) = RecShape{ posX, posY, width, height, color };
+        return;
+    }
+    FinishScaledView(ctx);
+    if (IsSoftwareBackend(ctx)) {
+        SwFillRect(ctx.softwareTarget, posX, posY, width, height, color);
+        return;
+    }
+    FlushSliceBatch(ctx);
     DrawRectangle(posX, posY, width, height, color);
+    CountGpuDraw(ctx, 0);
 }
 
 void DrawScreenLine(int startPosX, int startPosY, int endPosX, int endPosY, Color color) {
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        *RecordCommand<RecShape>(ctx, REC_LINE) = RecShape{ startPosX, startPosY, endPosX, endPosY, color };
+        return;
+    }
+    FinishScaledView(ctx);
+    if (IsSoftwareBackend(ctx)) {
+        SwDrawLine(ctx.softwareTarget, startPosX, startPosY, endPosX, endPosY, color);
+        return;
+    }
+    FlushSliceBatch(ctx);
     DrawLine(startPosX, startPosY, endPosX, endPosY, color);
+    CountGpuDraw(ctx, 0);
 }
 
 void DrawScreenText(const char* text, int posX, int posY, int fontSize, Color color) {
-    DrawText(text, posX, posY, fontSize, color);
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        const size_t length = (text != nullptr) ? strlen(text) + 1 : 1;
+        RecText* command = RecordCommand<RecText>(ctx, REC_TEXT);
+        char* copy = (char*)RecordBytes(ctx, text, length);
+        copy[length - 1] = '\0';
+        *command = RecText{ copy, posX, posY, fontSize, color };
+        return;
+    }
+    FinishScaledView(ctx);
+    const auto start = FrameProfiler::Clock::now();
+    if (IsSoftwareBackend(ctx)) {
+        // raylib's default font only exists once a window is open, so headless frames carry no text
+        if (HasWindow(ctx)) {
+            Image frame = { ctx.framebuffer.data(), ctx.screenWidth, ctx.screenHeight, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            ImageDrawText(&frame, text, posX, posY, fontSize, color);
+        }
+    }
+    else {
+        FlushSliceBatch(ctx);
+        DrawText(text, posX, posY, fontSize, color);
+        CountGpuDraw(ctx, GetFontDefault().texture.id);
+    }
+    ctx.profiler.EndStage(PROFILE_STAGE_TEXT, start);
 }
 
 int GetRendererScreenWidth() {
-    return g_screenWidth;
+    RendererContext& ctx = CurrentContext();
+    return ctx.screenWidth;
 }
 
 int GetRendererScreenHeight() {
-    return g_screenHeight;
-}
\ No newline at end of file
+    RendererContext& ctx = CurrentContext();
+    return ctx.screenHeight;
+}
+
+RendererBackend GetRendererBackend() {
+    RendererContext& ctx = CurrentContext();
+    return ctx.backend;
+}
+
+int GetRendererFramesInFlight() {
+    RendererContext& ctx = CurrentContext();
+    return ctx.renderThread.GetFramesInFlight();
+}
+
+bool IsRendererKeyDown(int key) {
+    RendererContext& ctx = CurrentContext();
+    if (!IsRecording(ctx)) {
+        return IsKeyDown(key);
+    }
+    std::lock_guard<std::mutex> lock(ctx.inputMutex);
+    return key >= 0 && key < kInputKeyCount && ctx.inputSnapshot.keys[key];
+}
+
+bool IsRendererMouseButtonDown(int button) {
+    RendererContext& ctx = CurrentContext();
+    if (!IsRecording(ctx)) {
+        return IsMouseButtonDown(button);
+    }
+    std::lock_guard<std::mutex> lock(ctx.inputMutex);
+    return button >= 0 && button < kInputMouseButtons && ctx.inputSnapshot.mouseButtons[button];
+}
+
+Vector2 GetRendererMousePosition() {
+    RendererContext& ctx = CurrentContext();
+    if (!IsRecording(ctx)) {
+        return GetMousePosition();
+    }
+    std::lock_guard<std::mutex> lock(ctx.inputMutex);
+    return ctx.inputSnapshot.mousePosition;
+}
+
+RendererStats GetRendererStats() {
+    RendererContext& ctx = CurrentContext();
+    RendererStats stats = {};
+    ctx.profiler.GetLatest(stats);
+    return stats;
+}
+
+int GetRendererStatsHistory(RendererStats* out, int maxFrames) {
+    RendererContext& ctx = CurrentContext();
+    return ctx.profiler.GetHistory(out, maxFrames);
+}
+
+bool WriteRendererTrace(const char* filePath) {
+    RendererContext& ctx = CurrentContext();
+    if (!ctx.profiler.WriteChromeTrace(filePath)) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Failed to write trace file: %s", filePath ? filePath : "(null)");
+        return false;
+    }
+    return true;
+}
+
+void SetRendererWorkerThreads(int workerThreads) {
+    RendererContext& ctx = CurrentContext();
+    // The pool belongs to the thread that renders
+    auto start = [&] { ctx.workerPool.Start(workerThreads); };
+    ctx.renderThread.RunOnThread(start);
+}
+
+int GetRendererWorkerThreads() {
+    RendererContext& ctx = CurrentContext();
+    return ctx.workerPool.GetWorkerCount();
+}
+
+const uint8_t* GetFramebuffer(int* width, int* height) {
+    RendererContext& ctx = CurrentContext();
+    ctx.renderThread.WaitIdle();
+    if (!IsSoftwareBackend(ctx) || ctx.framebuffer.empty()) {
+        if (width) *width = 0;
+        if (height) *height = 0;
+        return nullptr;
+    }
+    if (width) *width = ctx.screenWidth;
+    if (height) *height = ctx.screenHeight;
+    return (const uint8_t*)ctx.framebuffer.data();
+}
+
+bool ReadFramebufferPlanar(uint8_t* dst) {
+    RendererContext& ctx = CurrentContext();
+    ctx.renderThread.WaitIdle();
+    if (!IsSoftwareBackend(ctx) || ctx.framebuffer.empty() || dst == nullptr) {
+        return false;
+    }
+    SwReadPlanar(ctx.softwareTarget, dst);
+    return true;
+}
+
+// --- Frame Capture ---
+
+static const int kDefaultCaptureFrames = 8;
+static const int kDefaultCaptureFps = 30;
+static const size_t kMaxCaptureRingBytes = (size_t)1 << 30;
+
+// Moves the oldest GPU readback into the capture ring, or drops it if the ring is full
+static void DeliverOldestReadback(RendererContext& ctx) {
+    uint8_t* slot = ctx.frameCapture.BeginFrame();
+    ctx.captureReadback.TakeOldest(slot);
+    if (slot != nullptr) ctx.frameCapture.CommitFrame();
+}
+
+// Delivers the GPU readbacks that have finished, in order; with 'wait', all of them
+static void DeliverCaptureReadbacks(RendererContext& ctx, bool wait) {
+    while (ctx.captureReadback.PollOldest(wait)) {
+        DeliverOldestReadback(ctx);
+    }
+}
+
+// Writes out the frames still being read back, then stops the capture
+static void StopCaptureState(RendererContext& ctx) {
+    DeliverCaptureReadbacks(ctx, true);
+    ctx.captureReadback.Stop();
+    ctx.frameCapture.Stop();
+}
+
+// Copies the finished frame into the capture ring, unless the writer is behind and the frame is dropped.
+// With the GPU backend the frame is queued for readback instead, and earlier frames whose readback
+// finished are copied in; only a ring of readbacks all still in flight waits for the oldest.
+static void CaptureFrame(RendererContext& ctx) {
+    if (!ctx.frameCapture.IsRunning()) {
+        return;
+    }
+    if (!IsSoftwareBackend(ctx)) {
+        rlDrawRenderBatchActive(); // Draw what raylib still holds back before reading the back buffer
+    }
+    if (ctx.captureReadback.IsRunning()) {
+        DeliverCaptureReadbacks(ctx, false);
+        if (ctx.captureReadback.IsFull()) {
+            ctx.captureReadback.PollOldest(true);
+            DeliverOldestReadback(ctx);
+        }
+        ctx.captureReadback.Queue();
+        return;
+    }
+    uint8_t* slot = ctx.frameCapture.BeginFrame();
+    if (slot == nullptr) {
+        return;
+    }
+    const size_t bytes = (size_t)ctx.screenWidth * ctx.screenHeight * 4;
+    if (IsSoftwareBackend(ctx)) {
+        memcpy(slot, ctx.framebuffer.data(), bytes);
+    }
+    else {
+        // No pixel buffers in this context: a blocking read
+        unsigned char* pixels = rlReadScreenPixels(ctx.screenWidth, ctx.screenHeight); // Flipped to top row first
+        memcpy(slot, pixels, bytes);
+        MemFree(pixels);
+    }
+    ctx.frameCapture.CommitFrame();
+}
+
+bool StartFrameCapture(const char* filePath, FrameCaptureFormat format, int ringFrames, int fps) {
+    RendererContext& ctx = CurrentContext();
+    if (format != FRAME_CAPTURE_Y4M && format != FRAME_CAPTURE_RAW) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Unknown frame capture format %d", (int)format);
+        return false;
+    }
+    if (ringFrames <= 0) {
+        ringFrames = kDefaultCaptureFrames;
+    }
+    if (fps <= 0) {
+        fps = kDefaultCaptureFps;
+    }
+    // The ring is filled by the thread that renders, so it changes hands between frames
+    bool success = false;
+    auto start = [&] {
+        if (ctx.screenWidth <= 0 || ctx.screenHeight <= 0) {
+            TraceLog(LOG_WARNING, "RENDER DLL: StartFrameCapture needs an initialized renderer");
+            return;
+        }
+        const size_t frameBytes = (size_t)ctx.screenWidth * ctx.screenHeight * 4;
+        const int maxFrames = (int)std::clamp(kMaxCaptureRingBytes / frameBytes, (size_t)1, (size_t)RENDERER_CAPTURE_MAX_FRAMES);
+        if (ringFrames > maxFrames) {
+            TraceLog(LOG_WARNING, "RENDER DLL: Frame capture ring capped at %d frames, %d requested", maxFrames, ringFrames);
+            ringFrames = maxFrames;
+        }
+        StopCaptureState(ctx);
+        success = ctx.frameCapture.Start(filePath, format, ctx.screenWidth, ctx.screenHeight, ringFrames, fps);
+        if (!success) {
+            TraceLog(LOG_WARNING, "RENDER DLL: Failed to start frame capture to %s", filePath ? filePath : "(null)");
+        }
+        else if (ctx.backend == RENDERER_BACKEND_RAYLIB && !ctx.captureReadback.Start(ctx.screenWidth, ctx.screenHeight)) {
+            TraceLog(LOG_INFO, "RENDER DLL: No pixel buffers in this OpenGL context, captured frames are read back synchronously");
+        }
+    };
+    ctx.renderThread.RunOnThread(start);
+    return success;
+}
+
+FrameCaptureStats StopFrameCapture() {
+    RendererContext& ctx = CurrentContext();
+    auto stop = [&] { StopCaptureState(ctx); };
+    ctx.renderThread.RunOnThread(stop);
+    return ctx.frameCapture.GetStats();
+}
+
+FrameCaptureStats GetFrameCaptureStats() {
+    RendererContext& ctx = CurrentContext();
+    return ctx.frameCapture.GetStats();
+}
+
+// --- Input Events and Frame Pacing ---
+
+static const double kPaceSpinSeconds = 0.001; // The end of a pacing wait spins: sleeps can overshoot by about this much
+
+static double RendererTime(RendererContext& ctx) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - ctx.timeBase).count();
+}
+
+// Thread that owns the window, right after raylib polled input: pushes what changed since the last poll
+static void CollectInputEvents(RendererContext& ctx) {
+    if (!HasWindow(ctx)) {
+        return;
+    }
+    const double time = RendererTime(ctx);
+    const uint64_t frameIndex = ctx.frameStats.frameIndex;
+    std::vector<InputEvent>& events = ctx.polledEvents;
+    events.clear();
+    auto add = [&](InputEventType type, int code, float x, float y) {
+        events.push_back(InputEvent{ time, type, code, x, y, frameIndex });
+    };
+
+    // raylib queues the presses it saw during the poll, so a tap shorter than a poll still shows
+    for (int key = GetKeyPressed(); key > 0; key = GetKeyPressed()) {
+        if (key >= kInputKeyCount) {
+            continue;
+        }
+        if (ctx.polledKeys[key]) {
+            add(INPUT_EVENT_KEY_UP, key, 0.0f, 0.0f); // Released and pressed again within the poll
+        }
+        add(INPUT_EVENT_KEY_DOWN, key, 0.0f, 0.0f);
+        ctx.polledKeys[key] = true;
+    }
+    for (int key = 0; key < kInputKeyCount; ++key) {
+        const bool down = IsKeyDown(key);
+        if (down != ctx.polledKeys[key]) {
+            add(down ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP, key, 0.0f, 0.0f);
+            ctx.polledKeys[key] = down;
+        }
+    }
+
+    const Vector2 mouse = GetMousePosition();
+    if (mouse.x != ctx.polledMousePosition.x || mouse.y != ctx.polledMousePosition.y) {
+        add(INPUT_EVENT_MOUSE_MOVE, 0, mouse.x, mouse.y);
+        ctx.polledMousePosition = mouse;
+    }
+    for (int button = 0; button < kInputMouseButtons; ++button) {
+        const bool down = IsMouseButtonDown(button);
+        if (down != ctx.polledMouseButtons[button]) {
+            add(down ? INPUT_EVENT_MOUSE_DOWN : INPUT_EVENT_MOUSE_UP, button, mouse.x, mouse.y);
+            ctx.polledMouseButtons[button] = down;
+        }
+    }
+    const Vector2 wheel = GetMouseWheelMoveV(); // Movement during the poll
+    if (wheel.x != 0.0f || wheel.y != 0.0f) {
+        add(INPUT_EVENT_MOUSE_WHEEL, 0, wheel.x, wheel.y);
+    }
+
+    if (!events.empty()) {
+        ctx.inputEvents.Push(events.data(), (int)events.size());
+    }
+}
+
+// End of EndFrame on the thread that presents: takes the input the present polled, then with pacing
+// on waits for the next frame's start, polling input every pollMs and once more at the end
+static void PaceFrame(RendererContext& ctx, double inputTime) {
+    CollectInputEvents(ctx);
+    double now = RendererTime(ctx);
+    double start;
+    float pollMs;
+    {
+        std::lock_guard<std::mutex> lock(ctx.pacingMutex);
+        start = ctx.pacer.Presented(now, inputTime);
+        pollMs = ctx.pacer.GetPollMs();
+    }
+
+    const double waitBegin = now;
+    const bool poll = HasWindow(ctx) && pollMs > 0.0f;
+    double lastPoll = now;
+    while (now < start) {
+        const double sleep = std::min(start - now - kPaceSpinSeconds, poll ? lastPoll + pollMs / 1000.0 - now : start - now);
+        if (sleep > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(sleep));
+        else std::this_thread::yield();
+        now = RendererTime(ctx);
+        if (poll && now - lastPoll >= pollMs / 1000.0) {
+            PollInputEvents();
+            CollectInputEvents(ctx);
+            lastPoll = now;
+        }
+    }
+    if (poll && start > waitBegin) {
+        PollInputEvents(); // The caller reads input next
+        CollectInputEvents(ctx);
+        now = RendererTime(ctx);
+    }
+
+    std::lock_guard<std::mutex> lock(ctx.pacingMutex);
+    ctx.pacer.Resumed(now, (float)((now - waitBegin) * 1000.0));
+}
+
+double GetRendererTime() {
+    RendererContext& ctx = CurrentContext();
+    return RendererTime(ctx);
+}
+
+int ReadInputEvents(InputEvent* events, int maxEvents) {
+    RendererContext& ctx = CurrentContext();
+    if (events == nullptr || maxEvents <= 0) {
+        return 0;
+    }
+    const int count = ctx.inputEvents.Read(events, maxEvents);
+    if (count > 0) {
+        // Events come out oldest first; the next EndFrame measures its latency from the first
+        std::lock_guard<std::mutex> lock(ctx.inputMutex);
+        if (ctx.inputReadTime < 0.0 || events[0].time < ctx.inputReadTime) ctx.inputReadTime = events[0].time;
+    }
+    return count;
+}
+
+void SetFramePacing(float targetFps, float pollMs) {
+    RendererContext& ctx = CurrentContext();
+    std::lock_guard<std::mutex> lock(ctx.pacingMutex);
+    ctx.pacer.SetTarget(targetFps, pollMs);
+}
+
+FramePacingStats GetFramePacingStats() {
+    RendererContext& ctx = CurrentContext();
+    FramePacingStats stats = {};
+    {
+        std::lock_guard<std::mutex> lock(ctx.pacingMutex);
+        ctx.pacer.GetStats(stats);
+    }
+    stats.inputEventsQueued = ctx.inputEvents.GetQueued();
+    stats.inputEventsDropped = ctx.inputEvents.GetDropped();
+    return stats;
+}
+
+// --- Command Stream Submission ---
+
+static unsigned char CommandColorChannel(double value) {
+    if (!(value > 0.0)) return 0; // Also maps NaN to 0
+    return (value >= 255.0) ? 255 : (unsigned char)value;
+}
+
+// Screen coordinates saturate to +-2^29, so any caller value, and the difference of two, fits in an int
+static const double kCommandCoordinateLimit = 536870912.0;
+
+static int CommandCoordinate(double value) {
+    return (int)std::clamp(value, -kCommandCoordinateLimit, kCommandCoordinateLimit); // NaN is rejected earlier
+}
+
+// Valid IDs are nonzero, so anything out of range becomes 0 and draws as a missing texture
+static TextureID CommandTextureID(double value) {
+    return (value >= 0.0 && value <= (double)UINT_MAX) ? (TextureID)value : 0;
+}
+
+// Parameters each opcode reads, indexed by opcode
+static const int kDrawCommandParams[] = { 0, 4, 4, 3, 6 };
+static const int kDrawCommandUnknown = -1;
+static const int kDrawCommandInvalid = -2;
+
+// Reads the opcode and the parameters of a row; parameters past the end of the table read as 0.
+// Returns the opcode, kDrawCommandUnknown for a value that is not one, or kDrawCommandInvalid when
+// a parameter the opcode uses is NaN.
+template <typename T>
+static int DecodeDrawCommand(const T* row, int paramCount, size_t fieldStride, double p[6]) {
+    const double value = (double)row[0];
+    if (!(value >= (double)DRAW_CMD_NOP && value <= (double)DRAW_CMD_TEXTURED_SLICE) || value != floor(value)) {
+        return kDrawCommandUnknown; // Also NaN and infinities
+    }
+    const int opcode = (int)value;
+    for (int k = 0; k < 6; ++k) {
+        p[k] = (k < paramCount) ? (double)row[(size_t)(k + 1) * fieldStride] : 0.0;
+    }
+    for (int k = 0; k < kDrawCommandParams[opcode]; ++k) {
+        if (isnan(p[k])) return kDrawCommandInvalid;
+    }
+    return opcode;
+}
+
+template <typename T>
+static int ExecuteDrawCommands(const T* data, int commandCount, int fieldCount, size_t commandStride, size_t fieldStride) {
+    if (data == nullptr || commandCount <= 0) {
+        return 0;
+    }
+    if (fieldCount < DRAW_CMD_MIN_FIELDS) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Draw command table needs at least %d fields, got %d", DRAW_CMD_MIN_FIELDS, fieldCount);
+        return 0;
+    }
+
+    const int paramCount = fieldCount - 5;
+    const size_t colorOffset = (size_t)(fieldCount - 4) * fieldStride;
+    int drawn = 0;
+    int unknown = 0;
+    int invalid = 0;
+    for (int i = 0; i < commandCount; ++i) {
+        const T* row = data + (size_t)i * commandStride;
+        double p[6];
+        const int opcode = DecodeDrawCommand(row, paramCount, fieldStride, p);
+        if (opcode == kDrawCommandUnknown) {
+            ++unknown;
+            continue;
+        }
+        if (opcode == kDrawCommandInvalid) {
+            ++invalid;
+            continue;
+        }
+        Color color = {
+            CommandColorChannel((double)row[colorOffset]),
+            CommandColorChannel((double)row[colorOffset + fieldStride]),
+            CommandColorChannel((double)row[colorOffset + 2 * fieldStride]),
+            CommandColorChannel((double)row[colorOffset + 3 * fieldStride])
+        };
+
+        switch (opcode) {
+        case DRAW_CMD_NOP:
+            continue;
+        case DRAW_CMD_RECT:
+            DrawScreenRectangle(CommandCoordinate(p[0]), CommandCoordinate(p[1]), CommandCoordinate(p[2]), CommandCoordinate(p[3]), color);
+            break;
+        case DRAW_CMD_LINE:
+            DrawScreenLine(CommandCoordinate(p[0]), CommandCoordinate(p[1]), CommandCoordinate(p[2]), CommandCoordinate(p[3]), color);
+            break;
+        case DRAW_CMD_WALL_SLICE:
+            DrawWallSlice(CommandCoordinate(p[0]), CommandCoordinate(p[1]), CommandCoordinate(p[2]), color);
+            break;
+        case DRAW_CMD_TEXTURED_SLICE:
+            // Every path clamps to the edge texels, so clamping texCoordX first changes nothing
+            DrawTexturedWallSlice(CommandCoordinate(p[0]), CommandCoordinate(p[1]), CommandCoordinate(p[2]),
+                (float)std::clamp(p[3], -kCommandCoordinateLimit, kCommandCoordinateLimit), CommandTextureID(p[4]),
+                (float)std::clamp(p[5], 0.0, 1.0), color);
+            break;
+        }
+        ++drawn;
+    }
+    if (unknown > 0) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Skipped %d draw commands with unknown opcodes", unknown);
+    }
+    if (invalid > 0) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Skipped %d draw commands with NaN parameters", invalid);
+    }
+    return drawn;
+}
+
+// Copies the table into the frame being recorded as row-major doubles (exact for float tables too)
+// and returns what ExecuteDrawCommands will report for it
+template <typename T>
+static int RecordDrawCommands(RendererContext& ctx, const T* data, int commandCount, int fieldCount, size_t commandStride, size_t fieldStride) {
+    if (data == nullptr || commandCount <= 0) {
+        return 0;
+    }
+    if (fieldCount < DRAW_CMD_MIN_FIELDS) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Draw command table needs at least %d fields, got %d", DRAW_CMD_MIN_FIELDS, fieldCount);
+        return 0;
+    }
+    RecDrawCommands* command = RecordCommand<RecDrawCommands>(ctx, REC_DRAW_COMMANDS);
+    double* rows = (double*)RecordBytes(ctx, nullptr, sizeof(double) * commandCount * fieldCount);
+    const int paramCount = fieldCount - 5;
+    int drawn = 0;
+    for (int i = 0; i < commandCount; ++i) {
+        const T* row = data + (size_t)i * commandStride;
+        double* copy = rows + (size_t)i * fieldCount;
+        for (int f = 0; f < fieldCount; ++f) {
+            copy[f] = (double)row[(size_t)f * fieldStride];
+        }
+        double p[6];
+        if (DecodeDrawCommand(row, paramCount, fieldStride, p) > DRAW_CMD_NOP) ++drawn;
+    }
+    *command = RecDrawCommands{ rows, commandCount, fieldCount };
+    return drawn;
+}
+
+int SubmitDrawCommands(const double* data, int commandCount, int fieldCount, size_t commandStride, size_t fieldStride) {
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        return RecordDrawCommands(ctx, data, commandCount, fieldCount, commandStride, fieldStride);
+    }
+    FinishScaledView(ctx);
+    const auto start = FrameProfiler::Clock::now();
+    const int drawn = ExecuteDrawCommands(data, commandCount, fieldCount, commandStride, fieldStride);
+    ctx.profiler.EndStage(PROFILE_STAGE_COMMANDS, start);
+    return drawn;
+}
+
+int SubmitDrawCommands(const float* data, int commandCount, int fieldCount, size_t commandStride, size_t fieldStride) {
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        return RecordDrawCommands(ctx, data, commandCount, fieldCount, commandStride, fieldStride);
+    }
+    FinishScaledView(ctx);
+    const auto start = FrameProfiler::Clock::now();
+    const int drawn = ExecuteDrawCommands(data, commandCount, fieldCount, commandStride, fieldStride);
+    ctx.profiler.EndStage(PROFILE_STAGE_COMMANDS, start);
+    return drawn;
+}
+
+// --- Native Raycasting ---
+
+// Scanlines per work-stealing band of floor/ceiling casting
+static const int kFloorBandRows = 8;
+
+// Matches the colors used by matlab_mex/test.m
+static const Color g_defaultWallColors[] = {
+    { 200, 0, 0, 255 }, { 0, 200, 0, 255 }, { 0, 0, 200, 255 }, { 200, 200, 200, 255 }
+};
+const RaycastPalette g_defaultPalette = {
+    g_defaultWallColors, 4, { 50, 50, 50, 255 }, { 120, 120, 120, 255 }, { 80, 80, 80, 255 }, 0.7f, 0, 0
+};
+
+static Color ShadeColor(Color color, float shade) {
+    return Color{
+        (unsigned char)(color.r * shade + 0.5f),
+        (unsigned char)(color.g * shade + 0.5f),
+        (unsigned char)(color.b * shade + 0.5f),
+        color.a
+    };
+}
+
+static Color WallColorForHit(const RaycastPalette& palette, const RaycastHit& hit) {
+    Color color = (hit.cell >= 1 && hit.cell <= palette.wallColorCount) ? palette.wallColors[hit.cell - 1] : palette.defaultWallColor;
+    return (hit.side == 1) ? ShadeColor(color, palette.sideShade) : color;
+}
+
+// Fills 'table' with the wall colors of 'palette' as seen from both sides: entry cell * 2 + side,
+// for cells 0..wallColorCount, then the default color at wallColorCount + 1. Saves the software
+// rasterizer from shading every column.
+void BuildWallColorTable(const RaycastPalette& palette, std::vector<Color>& table) {
+    const int colorCount = std::max(palette.wallColorCount, 0);
+    table.resize((size_t)(colorCount + 2) * 2);
+    table[0] = table[1] = BLANK;
+    for (int cell = 1; cell <= colorCount + 1; ++cell) {
+        const Color color = (cell <= colorCount) ? palette.wallColors[cell - 1] : palette.defaultWallColor;
+        table[cell * 2] = color;
+        table[cell * 2 + 1] = ShadeColor(color, palette.sideShade);
+    }
+}
+
+// Whether every color the frame fills with is opaque, so walls and flat planes can be written
+// over each other without blending
+bool IsOpaqueRaycastPalette(const RaycastPalette& palette, bool flatCeiling, bool flatFloor) {
+    if (palette.defaultWallColor.a != 255 || (flatCeiling && palette.ceilingColor.a != 255) ||
+        (flatFloor && palette.floorColor.a != 255)) {
+        return false;
+    }
+    for (int i = 0; i < palette.wallColorCount; ++i) {
+        if (palette.wallColors[i].a != 255) return false;
+    }
+    return true;
+}
+
+typedef void (*DrawWallRowsFn)(SoftwareTarget& target, int colBegin, int colEnd, int rowBegin, int rowEnd,
+    const int* top, const int* bottom, const Color* wallColors, Color plane);
+
+// Draws the wall slices of columns [colBegin, colEnd) through drawRect(x, y, width, height, color),
+// lit by lightmap unless it is null. Neighbouring columns with the same span and color are merged
+// into a single rectangle.
+template <typename DrawRect>
+static void DrawWallRuns(const RaycastPalette& palette, const RaycastHit* hits, int colBegin, int colEnd,
+    const Lightmap* lightmap, const CameraRaySetup& setup, DrawRect drawRect) {
+    int runStart = -1, runTop = 0, runBottom = 0;
+    Color runColor = BLACK;
+    auto flushRun = [&](int runEnd) {
+        if (runStart >= 0) {
+            drawRect(runStart, runTop, runEnd - runStart, runBottom - runTop + 1, runColor);
+            runStart = -1;
+        }
+    };
+
+    for (int x = colBegin; x < colEnd; ++x) {
+        const RaycastHit& hit = hits[x];
+        if (hit.cell == 0) {
+            flushRun(x);
+            continue;
+        }
+        const int top = hit.drawStart;
+        const int bottom = hit.drawEnd;
+        Color color = WallColorForHit(palette, hit);
+        if (lightmap != nullptr) color = ApplyLight(color, lightmap->WallLight(hit, setup.posX, setup.posY));
+        if (runStart >= 0 && top == runTop && bottom == runBottom &&
+            color.r == runColor.r && color.g == runColor.g && color.b == runColor.b && color.a == runColor.a) {
+            continue;
+        }
+        flushRun(x);
+        runStart = x;
+        runTop = top;
+        runBottom = bottom;
+        runColor = color;
+    }
+    flushRun(colEnd);
+}
+
+// Casts scanlines [rowBegin, rowEnd) of the textured floor (lower half) and ceiling (upper half)
+// into pixels, a row-major screen-sized buffer. With a lightmap, halves without a texture are
+// filled with the palette's color and every row is lit; without, they are left untouched.
+// Returns the number of texels sampled.
+long long CastPlaneRows(const CameraRaySetup& setup, const RaycastPalette& palette, const TextureSlot* ceiling,
+    const TextureSlot* floor, const Lightmap* lightmap, Color* pixels, int rowBegin, int rowEnd) {
+    const int halfHeight = setup.screenHeight / 2;
+    const float rayDirX0 = setup.dirX + setup.planeX * setup.columnOffset;
+    const float rayDirY0 = setup.dirY + setup.planeY * setup.columnOffset;
+    long long sampled = 0;
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        const bool isFloor = y >= halfHeight;
+        const TextureSlot* texture = isFloor ? floor : ceiling;
+        if (texture == nullptr && lightmap == nullptr) {
+            continue;
+        }
+        // A wall at distance d spans screenHeight / d rows around the horizon, so a pixel centre
+        // p rows from the horizon shows the plane at distance 0.5 * screenHeight / p
+        const float p = isFloor ? (float)(y - halfHeight) + 0.5f : (float)(halfHeight - y) - 0.5f;
+        const float rowDistance = 0.5f * (float)setup.screenHeight / p;
+        FloorRowSetup row;
+        row.originX = setup.posX + rowDistance * rayDirX0;
+        row.originY = setup.posY + rowDistance * rayDirY0;
+        row.stepX = rowDistance * setup.planeX * setup.columnScale;
+        row.stepY = rowDistance * setup.planeY * setup.columnScale;
+        Color* dst = pixels + (size_t)y * setup.screenWidth;
+        if (texture == nullptr) {
+            std::fill(dst, dst + setup.screenWidth, isFloor ? palette.floorColor : palette.ceilingColor);
+            lightmap->ShadePlaneRow(row, dst, 0, setup.screenWidth);
+            continue;
+        }
+
+        // Distant rows skip across many texels per pixel: sample a smaller mip level
+        float texelsPerPixel = sqrtf(row.stepX * row.stepX + row.stepY * row.stepY) * (float)std::max(texture->width, texture->height);
+        int level = 0;
+        while (level + 1 < texture->mipCount && texelsPerPixel >= 2.0f) {
+            texelsPerPixel *= 0.5f;
+            ++level;
+        }
+        CastFloorRow(row, SoftwareTextureFromSlot(*texture, level), dst, 0, setup.screenWidth);
+        if (lightmap != nullptr) lightmap->ShadePlaneRow(row, dst, 0, setup.screenWidth);
+        sampled += setup.screenWidth;
+    }
+    return sampled;
+}
+
+// Rasterizes columns [colBegin, colEnd) of the walls into a software target, with the flat halves
+// of the floor and ceiling that were not cast. wallColors is BuildWallColorTable's table when the
+// palette is opaque (IsOpaqueRaycastPalette): every pixel is then written once, walls and flat
+// planes together. Null fills the planes first and draws the walls over them.
+void RasterizeRaycastColumns(SoftwareTarget& target, const CameraRaySetup& setup, const RaycastPalette& palette,
+    const Color* wallColors, const RaycastHit* hits, const Lightmap* lightmap, bool castCeiling, bool castFloor,
+    int colBegin, int colEnd) {
+    const int height = setup.screenHeight;
+    if (wallColors == nullptr) {
+        const int tileWidth = colEnd - colBegin;
+        if (!castCeiling) SwFillRect(target, colBegin, 0, tileWidth, height / 2, palette.ceilingColor);
+        if (!castFloor) SwFillRect(target, colBegin, height / 2, tileWidth, height - height / 2, palette.floorColor);
+        DrawWallRuns(palette, hits, colBegin, colEnd, lightmap, setup, [&target](int x, int y, int w, int h, Color color) {
+            SwFillRect(target, x, y, w, h, color);
+        });
+        return;
+    }
+
+    // The variants for the floor and ceiling kinds are picked here rather than tested per pixel
+    const int defaultColor = palette.wallColorCount + 1;
+    const DrawWallRowsFn drawCeilingRows = castCeiling ? SwDrawWallRows<false> : SwDrawWallRows<true>;
+    const DrawWallRowsFn drawFloorRows = castFloor ? SwDrawWallRows<false> : SwDrawWallRows<true>;
+    // A pool without workers hands over every column at once
+    for (int tileBegin = colBegin; tileBegin < colEnd; tileBegin += kRaycastTileColumns) {
+        const int tileEnd = std::min(tileBegin + kRaycastTileColumns, colEnd);
+        int top[kRaycastTileColumns], bottom[kRaycastTileColumns];
+        Color colors[kRaycastTileColumns];
+        for (int x = tileBegin; x < tileEnd; ++x) {
+            const RaycastHit& hit = hits[x];
+            const int i = x - tileBegin;
+            if (hit.cell == 0) {
+                top[i] = height;
+                bottom[i] = -1;
+                colors[i] = BLANK;
+                continue;
+            }
+            const int cell = (hit.cell <= palette.wallColorCount) ? hit.cell : defaultColor;
+            top[i] = hit.drawStart;
+            bottom[i] = hit.drawEnd;
+            colors[i] = wallColors[cell * 2 + (hit.side == 1)];
+            if (lightmap != nullptr) colors[i] = ApplyLight(colors[i], lightmap->WallLight(hit, setup.posX, setup.posY));
+        }
+        drawCeilingRows(target, tileBegin, tileEnd, 0, height / 2, top, bottom, colors, palette.ceilingColor);
+        drawFloorRows(target, tileBegin, tileEnd, height / 2, height, top, bottom, colors, palette.floorColor);
+    }
+}
+
+// --- Frame Reuse ---
+
+enum RaycastReuseMode {
+    RAYCAST_REUSE_NONE,    // Cast every column
+    RAYCAST_REUSE_ALL,     // Same pose: the hits are still valid
+    RAYCAST_REUSE_ROTATED  // Same position, new heading: rebuild what the previous hits allow
+};
+
+// Whether the map is the one raycastReuse was cast on
+static bool ReuseMatchesMap(RendererContext& ctx, const RaycastMapView& view) {
+    return !ctx.raycastReuse.tiled && view.width == ctx.raycastReuse.mapW && view.height == ctx.raycastReuse.mapH &&
+        memcmp(view.cells, ctx.raycastReuse.mapCells.data(), (size_t)view.width * view.height) == 0;
+}
+
+static bool ReuseMatchesMap(RendererContext& ctx, const TiledMapView&) {
+    return ctx.raycastReuse.tiled && ctx.raycastReuse.mapVersion == ctx.loadedMap.GetVersion();
+}
+
+// Records the map the hits were just cast on; returns false if it is not worth keeping
+static bool RememberReuseMap(RendererContext& ctx, const RaycastMapView& view, bool unchanged) {
+    const size_t cells = (size_t)view.width * view.height;
+    if (cells > RAYCAST_REUSE_MAX_DENSE_CELLS) {
+        return false;
+    }
+    if (!unchanged) {
+        ctx.raycastReuse.tiled = false;
+        ctx.raycastReuse.mapW = view.width;
+        ctx.raycastReuse.mapH = view.height;
+        ctx.raycastReuse.mapCells.assign(view.cells, view.cells + cells);
+    }
+    return true;
+}
+
+static bool RememberReuseMap(RendererContext& ctx, const TiledMapView&, bool) {
+    ctx.raycastReuse.tiled = true;
+    ctx.raycastReuse.mapVersion = ctx.loadedMap.GetVersion();
+    ctx.raycastReuse.mapCells.clear();
+    return true;
+}
+
+// Rebuilds column x of setup from the hits of 'previous', a camera at the same position with
+// another heading. The column's ray must fall between two previous rays that met the same wall
+// face: a wall cell hiding in the sliver between them would have to fit in less than a cell's width.
+static bool ReuseRotatedHit(const CameraRaySetup& previous, const RaycastHit* previousHits, const CameraRaySetup& setup,
+    int x, RaycastHit& hit) {
+    const float cameraX = setup.cameraX[x];
+    const float rayDirX = setup.dirX + setup.planeX * cameraX;
+    const float rayDirY = setup.dirY + setup.planeY * cameraX;
+    // The ray in the previous camera's terms: forward along its direction, across its plane
+    const float forward = rayDirX * previous.dirX + rayDirY * previous.dirY;
+    const float across = (rayDirX * previous.planeX + rayDirY * previous.planeY) /
+        (previous.planeX * previous.planeX + previous.planeY * previous.planeY);
+    if (!(forward > 0.0f)) {
+        return false;
+    }
+    const float column = (across / forward - previous.columnOffset) / previous.columnScale;
+    if (!(column >= 0.0f && column <= (float)(previous.screenWidth - 1))) {
+        return false;
+    }
+    const int left = (int)column;
+    const int right = ((float)left == column) ? left : left + 1;
+    const RaycastHit& a = previousHits[left];
+    const RaycastHit& b = previousHits[right];
+    if (a.cell == 0 || a.mapX != b.mapX || a.mapY != b.mapY || a.side != b.side) {
+        return false;
+    }
+    return RetargetCameraHit(a, setup, cameraX, hit);
+}
+
+void SetRaycastFrameReuse(bool enabled) {
+    RendererContext& ctx = CurrentContext();
+    ctx.raycastReuseEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool GetRaycastFrameReuse() {
+    RendererContext& ctx = CurrentContext();
+    return ctx.raycastReuseEnabled.load(std::memory_order_relaxed);
+}
+
+// --- Lighting ---
+
+static void TrackLightmapMap(RendererContext& ctx, const RaycastMapView& view) {
+    ctx.lightmap.TrackMap(view);
+}
+
+static void TrackLightmapMap(RendererContext& ctx, const TiledMapView& view) {
+    ctx.lightmap.TrackMap(view, ctx.loadedMap.GetVersion());
+}
+
+// Brings the lightmap up to date with the lights and the map of 'view'; returns the chunks relit
+template <typename MapView>
+int UpdateLightmap(RendererContext& ctx, const MapView& view) {
+    TrackLightmapMap(ctx, view);
+    ctx.lightmap.CollectDirtyChunks(ctx.dirtyLightChunks);
+    if (!ctx.dirtyLightChunks.empty()) {
+        ctx.lightmap.SetRelightWorkers(ctx.workerPool.GetWorkerCount()); // Allocates only when the pool grew
+        auto relight = [&](int begin, int end, int worker) {
+            for (int i = begin; i < end; ++i) ctx.lightmap.RelightChunk(view, ctx.dirtyLightChunks[i], worker);
+        };
+        ctx.workerPool.ParallelFor((int)ctx.dirtyLightChunks.size(), 1, relight);
+    }
+    return (int)ctx.dirtyLightChunks.size();
+}
+
+template int UpdateLightmap(RendererContext& ctx, const RaycastMapView& view);
+template int UpdateLightmap(RendererContext& ctx, const TiledMapView& view);
+
+// UpdateLightmap for the frame being rendered; null if lighting is off
+template <typename MapView>
+static const Lightmap* RelightView(RendererContext& ctx, const MapView& view) {
+    if (!ctx.lightmap.IsEnabled()) {
+        return nullptr;
+    }
+    const auto start = FrameProfiler::Clock::now();
+    ctx.frameStats.lightChunksRelit += UpdateLightmap(ctx, view);
+    ctx.profiler.EndStage(PROFILE_STAGE_LIGHTING, start);
+    return &ctx.lightmap;
+}
+
+void SetRaycastLighting(bool enabled, Color ambient) {
+    RendererContext& ctx = CurrentContext();
+    if (IsRecording(ctx)) {
+        *RecordCommand<RecLighting>(ctx, REC_LIGHTING) = RecLighting{ enabled, ambient };
+        return;
+    }
+    ctx.lightmap.SetLighting(enabled, ambient);
+}
+
+void SetRaycastLights(const RaycastLight* lights, int count) {
+    RendererContext& ctx = CurrentContext();
+    if (lights == nullptr || count < 0) {
+        count = 0;
+    }
+    if (IsRecording(ctx)) {
+        *RecordCommand<RecLights>(ctx, REC_LIGHTS) = RecLights{ (const RaycastLight*)RecordBytes(ctx, lights, sizeof(RaycastLight) * count), count };
+        return;
+    }
+    ctx.lightmap.SetLights(lights, count);
+}
+
+// Shared by the dense and loaded-map entry points; MapView is RaycastMapView or TiledMapView
+template <typename MapView>
+static void RenderRaycastView(RendererContext& ctx, const MapView& view, RaycastCamera camera, const RaycastPalette* palette) {
+    if (!IsUsableCameraPose(camera)) {
+        TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastFrame called with a non-finite or out-of-range camera pose");
+        return;
+    }
+    if (palette == nullptr) {
+        palette = &g_defaultPalette;
+    }
+
+    const int width = ctx.viewWidth;
+    const int height = ctx.viewHeight;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    BeginScaledView(ctx);
+    UpdateCameraRayTable(ctx.cameraRayTable, width, camera.fov);
+    const CameraRaySetup setup = MakeCameraRaySetup(camera, ctx.cameraRayTable, height);
+
+    // Same place, field of view, resolution and map as the last frame: the previous hits still hold
+    const bool reuseEnabled = ctx.raycastReuseEnabled.load(std::memory_order_relaxed);
+    const RaycastReuseState& previous = ctx.raycastReuse;
+    const bool mapUnchanged = previous.valid && ReuseMatchesMap(ctx, view);
+    RaycastReuseMode reuse = RAYCAST_REUSE_NONE;
+    if (reuseEnabled && mapUnchanged && camera.posX == previous.camera.posX && camera.posY == previous.camera.posY &&
+        camera.fov == previous.camera.fov && width == previous.setup.screenWidth && height == previous.setup.screenHeight) {
+        if (camera.angle == previous.camera.angle) reuse = RAYCAST_REUSE_ALL;
+        else if (width > 1) reuse = RAYCAST_REUSE_ROTATED;
+    }
+    if (reuse == RAYCAST_REUSE_ROTATED) {
+        std::swap(ctx.raycastHits, ctx.previousRaycastHits);
+    }
+    if ((int)ctx.raycastHits.size() < width) {
+        ctx.raycastHits.resize(width);
+    }
+    RaycastHit* hits = ctx.raycastHits.data();
+    const RaycastHit* previousHits = ctx.previousRaycastHits.data();
+    const Lightmap* lightmap = RelightView(ctx, view);
+
+    // Floor and ceiling first, in scanline order: each row is one straight line through world
+    // space, so the workers take bands of rows rather than column tiles. Lit flat halves are cast
+    // like textured ones, for the light of every pixel.
+    const TextureSlot* ceilingTexture = FindTexture(ctx, palette->ceilingTexture);
+    const TextureSlot* floorTexture = FindTexture(ctx, palette->floorTexture);
+    const bool castCeiling = ceilingTexture != nullptr || lightmap != nullptr;
+    const bool castFloor = floorTexture != nullptr || lightmap != nullptr;
+    const int planeRowBegin = castCeiling ? 0 : height / 2;
+    const int planeRowEnd = castFloor ? height : height / 2;
+    const auto floorStart = FrameProfiler::Clock::now();
+    if (planeRowBegin < planeRowEnd) {
+        Color* planePixels = ctx.softwareTarget.pixels;
+        if (!IsSoftwareBackend(ctx)) {
+            ctx.planeBuffer.resize((size_t)width * height);
+            planePixels = ctx.planeBuffer.data();
+        }
+        std::atomic<long long> sampled{ 0 };
+        auto castBand = [&](int rowBegin, int rowEnd, int) {
+            sampled.fetch_add(CastPlaneRows(setup, *palette, ceilingTexture, floorTexture, lightmap, planePixels,
+                planeRowBegin + rowBegin, planeRowBegin + rowEnd), std::memory_order_relaxed);
+        };
+        ctx.workerPool.ParallelFor(planeRowEnd - planeRowBegin, kFloorBandRows, castBand);
+        ctx.frameStats.textureLookups += sampled.load();
+
+        if (!IsSoftwareBackend(ctx)) {
+            if (ctx.planeTexture.id == 0 || ctx.planeTexture.width != width || ctx.planeTexture.height != height) {
+                if (ctx.planeTexture.id > 0) UnloadTexture(ctx.planeTexture);
+                Image planeImage = { ctx.planeBuffer.data(), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+                ctx.planeTexture = LoadTextureFromImage(planeImage);
+            }
+            else {
+                Rectangle rows = { 0.0f, (float)planeRowBegin, (float)width, (float)(planeRowEnd - planeRowBegin) };
+                UpdateTextureRec(ctx.planeTexture, rows, ctx.planeBuffer.data() + (size_t)planeRowBegin * width);
+            }
+        }
+    }
+    ctx.profiler.EndStage(PROFILE_STAGE_FLOOR, floorStart);
+
+    const auto raycastStart = FrameProfiler::Clock::now();
+    std::atomic<long long> ddaSteps{ 0 };
+    std::atomic<int> reused{ 0 };
+    auto castTile = [&](int colBegin, int colEnd, int) {
+        int tileReused = 0;
+        if (reuse == RAYCAST_REUSE_ROTATED) {
+            // Cast the runs of columns between the rebuilt ones, so the packet kernels still apply
+            int runBegin = colBegin;
+            for (int x = colBegin; x < colEnd; ++x) {
+                if (ReuseRotatedHit(previous.setup, previousHits, setup, x, hits[x])) {
+                    if (runBegin < x) CastCameraColumns(view, setup, runBegin, x, hits);
+                    runBegin = x + 1;
+                    ++tileReused;
+                }
+            }
+            if (runBegin < colEnd) CastCameraColumns(view, setup, runBegin, colEnd, hits);
+        }
+        else {
+            CastCameraColumns(view, setup, colBegin, colEnd, hits);
+        }
+        long long steps = 0;
+        for (int x = colBegin; x < colEnd; ++x) steps += hits[x].steps;
+        ddaSteps.fetch_add(steps, std::memory_order_relaxed);
+        reused.fetch_add(tileReused, std::memory_order_relaxed);
+    };
+    if (reuse == RAYCAST_REUSE_ALL) {
+        reused.store(width);
+    }
+    else {
+        ctx.workerPool.ParallelFor(width, kRaycastTileColumns, castTile);
+    }
+    ctx.frameStats.ddaSteps += ddaSteps.load();
+    ctx.frameStats.raysReused += reused.load();
+    ctx.frameStats.raysCast += width - reused.load();
+    ctx.raycastReuse.valid = reuseEnabled && RememberReuseMap(ctx, view, mapUnchanged);
+    ctx.raycastReuse.camera = camera;
+    ctx.raycastReuse.setup = setup;
+    ctx.profiler.EndStage(PROFILE_STAGE_RAYCAST, raycastStart);
+
+    // Software targets are rasterized tile by tile on the workers: tiles own disjoint columns,
+    // so they never touch the same pixel. raylib draw calls must stay on this thread.
+    const auto wallStart = FrameProfiler::Clock::now();
+    if (IsSoftwareBackend(ctx)) {
+        const bool opaque = IsOpaqueRaycastPalette(*palette, !castCeiling, !castFloor);
+        if (opaque) BuildWallColorTable(*palette, ctx.wallColorTable);
+        const Color* wallColors = opaque ? ctx.wallColorTable.data() : nullptr;
+        auto rasterizeTile = [&](int colBegin, int colEnd, int) {
+            RasterizeRaycastColumns(ctx.softwareTarget, setup, *palette, wallColors, hits, lightmap, castCeiling, castFloor, colBegin, colEnd);
+        };
+        ctx.workerPool.ParallelFor(width, kRaycastTileColumns, rasterizeTile);
+    }
+    else {
+        // Not DrawScreenRectangle, which would end a scaled view
+        auto drawRect = [&](int x, int y, int w, int h, Color color) {
+            DrawRectangle(x, y, w, h, color);
+            CountGpuDraw(ctx, 0);
+        };
+        FlushSliceBatch(ctx);
+        if (!castCeiling) drawRect(0, 0, width, height / 2, palette->ceilingColor);
+        if (!castFloor) drawRect(0, height / 2, width, height - height / 2, palette->floorColor);
+        if (planeRowBegin < planeRowEnd && ctx.planeTexture.id > 0) {
+            FlushSliceBatch(ctx);
+            Rectangle rows = { 0.0f, (float)planeRowBegin, (float)width, (float)(planeRowEnd - planeRowBegin) };
+            DrawTextureRec(ctx.planeTexture, rows, Vector2{ 0.0f, (float)planeRowBegin }, WHITE);
+            CountGpuDraw(ctx, ctx.planeTexture.id);
+        }
+        DrawWallRuns(*palette, hits, 0, width, lightmap, setup, drawRect);
+    }
+    ctx.profiler.EndStage(PROFILE_STAGE_WALLS, wallStart);
+    ctx.raycastView = setup;
+    ctx.raycastViewReady = true;
+    ctx.raycastViewLit = lightmap != nullptr;
+}
+
+// Records a RenderRaycastFrame call; map == nullptr stands for the loaded map, which frames in
+// flight read in place (edits wait for them)
+static void RecordRaycast(RendererContext& ctx, const uint8_t* map, int mapW, int mapH, RaycastCamera camera, const RaycastPalette* palette) {
+    if (!IsUsableCameraPose(camera)) {
+        // Replay would skip it, so the view of an earlier raycast stays the one sprites use
+        TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastFrame called with a non-finite or out-of-range camera pose");
+        return;
+    }
+    RecRaycast* command = RecordCommand<RecRaycast>(ctx, REC_RAYCAST);
+    command->camera = camera;
+    command->hasPalette = palette != nullptr;
+    command->palette = palette ? *palette : RaycastPalette{};
+    if (palette != nullptr && palette->wallColors != nullptr && palette->wallColorCount > 0) {
+        command->palette.wallColors = (const Color*)RecordBytes(ctx, palette->wallColors, sizeof(Color) * palette->wallColorCount);
+    }
+    command->map = (map != nullptr) ? (const uint8_t*)RecordBytes(ctx, map, (size_t)mapW * mapH) : nullptr;
+    command->mapW = mapW;
+    command->mapH = mapH;
+    ctx.recordedView = MakeCameraRaySetup(camera, ctx.recordedViewWidth, ctx.recordedViewHeight);
+    ctx.recordedViewReady = true;
+    ctx.recordedViewOpen = true;
+}
+
+void RenderRaycastFrame(const uint8_t* map, int mapW, int mapH, RaycastCamera camera, const RaycastPalette* palette) {
+    RendererContext& ctx = CurrentContext();
+    if (map == nullptr || mapW <= 0 || mapH <= 0) {
+        TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastFrame called with an empty map");
+        return;
+    }
+    if (IsRecording(ctx)) {
+        RecordRaycast(ctx, map, mapW, mapH, camera, palette);
+        return;
+    }
+    RaycastMapView view;
+    view.cells = map;
+    view.width = mapW;
+    view.height = mapH;
+    RenderRaycastView(ctx, view, camera, palette);
+}
+
+void RenderRaycastFrame(RaycastCamera camera, const RaycastPalette* palette) {
+    RendererContext& ctx = CurrentContext();
+    if (!ctx.loadedMap.IsLoaded()) {
+        TraceLog(LOG_WARNING, "RENDER DLL: RenderRaycastFrame called without a loaded map");
+        return;
+    }
+    if (IsRecording(ctx)) {
+        RecordRaycast(ctx, nullptr, 0, 0, camera, palette);
+        return;
+    }
+    RenderRaycastView(ctx, ctx.loadedMap.GetView(), camera, palette);
+}
+
+// --- Loaded Map ---
+
+bool SaveRaycastMap(const char* filePath, const void* cells, int width, int height, int cellBytes) {
+    if (!TiledMap::Save(filePath, cells, width, height, cellBytes, kMapDefaultTileShift)) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Failed to save map file: %s", filePath ? filePath : "(null)");
+        return false;
+    }
+    return true;
+}
+
+// Map changes wait for the frames in flight, which read the map in place
+
+bool LoadRaycastMap(const char* filePath) {
+    RendererContext& ctx = CurrentContext();
+    ctx.renderThread.WaitIdle();
+    if (!ctx.loadedMap.Load(filePath)) {
+        TraceLog(LOG_WARNING, "RENDER DLL: Failed to load map file: %s", filePath ? filePath : "(null)");
+        return false;
+    }
+    TraceLog(LOG_INFO, "RENDER DLL: Mapped %dx%d map, %d of %d tiles stored", ctx.loadedMap.GetWidth(), ctx.loadedMap.GetHeight(),
+        ctx.loadedMap.GetStoredTileCount(), ctx.loadedMap.GetTileCount());
+    return true;
+}
+
+bool SetRaycastMap(const void* cells, int width, int height, int cellBytes) {
+    RendererContext& ctx = CurrentContext();
+    ctx.renderThread.WaitIdle();
+    std::vector<uint8_t> image;
+    if (!TiledMap::BuildImage(cells, width, height, cellBytes, kMapDefaultTileShift, image) || !ctx.loadedMap.Assign(std::move(image))) {
+        TraceLog(LOG_WARNING, "RENDER DLL: SetRaycastMap called with an invalid map");
+        return false;
+    }
+    return true;
+}
+
+void UnloadRaycastMap() {
+    RendererContext& ctx = CurrentContext();
+    ctx.renderThread.WaitIdle();
+    ctx.loadedMap.Clear();
+}
+
+bool GetRaycastMapInfo(RaycastMapInfo* info) {
+    RendererContext& ctx = CurrentContext();
+    if (info == nullptr || !ctx.loadedMap.IsLoaded()) {
+        return false;
+    }
+    info->width = ctx.loadedMap.GetWidth();
+    info->height = ctx.loadedMap.GetHeight();
+    info->cellBytes = ctx.loadedMap.GetCellBytes();
+    info->tileSize = ctx.loadedMap.GetTileSize();
+    info->tileCount = ctx.loadedMap.GetTileCount();
+    info->storedTiles = ctx.loadedMap.GetStoredTileCount();
+    info->emptyTiles = ctx.loadedMap.GetEmptyTileCount();
+    info->memoryMapped = ctx.loadedMap.IsMapped();
+    info->version = ctx.loadedMap.GetVersion();
+    return true;
+}
+
+int GetRaycastMapCell(int x, int y) {
+    RendererContext& ctx = CurrentContext();
+    return ctx.loadedMap.GetCell(x, y);
+}
+
+bool SetRaycastMapCell(int x, int y, int value) {
+    RendererContext& ctx = CurrentContext();
+    ctx.renderThread.WaitIdle();
+    const uint64_t version = ctx.loadedMap.GetVersion();
+    if (!ctx.loadedMap.SetCell(x, y, value)) {
+        return false;
+    }
+    ctx.lightmap.CellEdited(x, y, version, ctx.loadedMap.GetVersion());
+    return true;
+}
@@ -2,9 +2,70 @@
 #define RENDERING_ENGINE_H
 
 #include "raylib.h" 
+#include <stddef.h>
+#include <stdint.h>
 
 typedef unsigned int TextureID; 
+
+typedef enum RendererBackend {
+    RENDERER_BACKEND_RAYLIB = 0,            // GPU rendering into a raylib window (default)
+    RENDERER_BACKEND_SOFTWARE = 1,          // CPU framebuffer only: no window, display or GPU needed
+    RENDERER_BACKEND_SOFTWARE_WINDOWED = 2  // CPU framebuffer, shown in a window with one texture upload per frame
+} RendererBackend;
+
+struct RendererConfig {
+    int screenWidth = 800;
+    int screenHeight = 600;
+    const char* windowTitle = "Renderer";
+    RendererBackend backend = RENDERER_BACKEND_RAYLIB;
+    int workerThreads = 0; // Threads used for native raycasting, 0 = one per hardware thread, 1 = no worker threads
+    int framesInFlight = 0; // 0 = draw on the calling thread; N > 0 = pipelined on a render thread, up to N frames behind
+    int textureLoadThreads = 0; // Decoder threads for LoadTexturesAsync, 0 = one per hardware thread
+    bool frameReuse = true; // Initial SetRaycastFrameReuse
+    float renderScale = 1.0f; // Initial SetRenderScale
+    float frameBudgetMs = 0.0f; // > 0 starts the resolution controller: SetRenderScaleBudget(frameBudgetMs, minRenderScale, renderScale)
+    float minRenderScale = 0.5f;
+};
+
+// --- Renderer Contexts ---
+// A RendererContext holds one renderer: its window or framebuffer, textures, loaded map, lights,
+// worker threads and scratch buffers. Every other function in this header acts on the context
+// bound to the calling thread, which is the default context until BindRendererContext picks
+// another, so single-renderer callers need no changes. Contexts share nothing, so several of them
+// can render at once, each driven from its own thread (for example one headless renderer per core,
+// each with workerThreads = 1). A context must only be driven by one thread at a time.
+// raylib supports a single window per process: only one context at a time may use
+// RENDERER_BACKEND_RAYLIB or RENDERER_BACKEND_SOFTWARE_WINDOWED, and InitRenderer fails for any
+// other. SetRaycastSimdLevel and raylib's log level are process-wide.
+
+typedef struct RendererContext RendererContext;
+
+// A new, uninitialized context. Bind it and call InitRenderer to use it.
+RendererContext* CreateRendererContext();
+// Shuts the context down and frees it; threads still bound to it must bind another one first.
+// The default context cannot be destroyed.
+void DestroyRendererContext(RendererContext* context);
+RendererContext* GetDefaultRendererContext();
+// Makes the calling thread act on context (NULL = the default context) and returns the context it
+// was bound to before.
+RendererContext* BindRendererContext(RendererContext* context);
+RendererContext* GetBoundRendererContext();
+
+// --- Pipelined Submission ---
+// With framesInFlight > 0, BeginFrame, the Draw* calls, SubmitDrawCommands, RenderRaycastFrame and
+// DrawRaycastSprites only record their arguments into a command buffer; EndFrame hands the frame to
+// a render thread, which replays it while the caller records the next one. The caller blocks in the
+// first call of a frame once framesInFlight frames are still waiting to be rendered.
+// The render thread owns the window and the GPU context, so everything that needs them (InitRenderer,
+// ShutdownRenderer, texture loading, SetRendererWorkerThreads) runs there, after the frames already
+// submitted. Calls that read or change what frames in flight use (map edits, GetFramebuffer,
+// ReadFramebufferPlanar) first wait for them. Dense maps passed to RenderRaycastFrame are copied
+// into the frame; the loaded map is not. Stage timers then measure the replay on the render thread.
+
+#define RENDERER_MAX_FRAMES_IN_FLIGHT 3
+
 bool InitRenderer(int screenWidth, int screenHeight, const char* windowTitle);
+bool InitRenderer(const RendererConfig& config);
 void ShutdownRenderer();
 
 bool Renderer_WindowShouldClose();
@@ -12,9 +73,38 @@ void BeginFrame();
 void EndFrame();          
 TextureID LoadTextureFromPath(const char* filePath);
 void UnloadTextureByID(TextureID textureId);
+
+// --- Asynchronous Texture Loading ---
+// LoadTexturesAsync returns IDs at once and decodes the files on background threads
+// (RendererConfig::textureLoadThreads). Each decoded texture is uploaded at the next BeginFrame.
+// Until then its ID draws as the placeholder texture, or like an invalid ID if there is none.
+// Unloading a pending ID cancels it. When pipelined, the IDs are handed out by the render thread,
+// so the call first waits for the frames in flight.
+
+typedef enum TextureLoadStatus {
+    TEXTURE_STATUS_INVALID = 0, // Unknown or unloaded ID
+    TEXTURE_STATUS_PENDING = 1, // Queued, decoding, or decoded and waiting for BeginFrame
+    TEXTURE_STATUS_READY = 2,
+    TEXTURE_STATUS_FAILED = 3   // The file could not be read or decoded; draws like an invalid ID until unloaded
+} TextureLoadStatus;
+
+// Queues count files and writes their IDs to ids (0 where a path is NULL or no ID is left).
+// Returns the number queued.
+int LoadTexturesAsync(const char* const* filePaths, int count, TextureID* ids);
+TextureID LoadTextureFromPathAsync(const char* filePath);
+TextureLoadStatus GetTextureLoadStatus(TextureID textureId);
+// Files queued or decoding, plus decoded textures not uploaded yet.
+int GetPendingTextureCount();
+// Blocks until every queued file is decoded, then uploads them all without waiting for BeginFrame.
+void WaitForTextureLoads();
+// Texture drawn in place of pending ones; 0 (default) draws them like invalid IDs.
+void SetTexturePlaceholder(TextureID placeholder);
+TextureID GetTexturePlaceholder();
     
     
 void DrawWallSlice(int screenX, int drawStartY, int drawEndY, Color color);
+// With the GPU backend, textured slices are packed into wall atlas pages with mip levels chosen from the
+// span height, and are queued until the next non-slice draw or EndFrame, then drawn as one batch per page.
 void DrawTexturedWallSlice(int screenX, int drawStartY, int drawEndY, float drawWidth, TextureID textureId, float texCoordX, Color tint);
 void DrawSprite(TextureID textureId, Rectangle sourceRec, Rectangle destRec, Vector2 origin, float rotation, Color tint);
 void DrawScreenRectangle(int posX, int posY, int width, int height, Color color);
@@ -23,6 +113,460 @@ void DrawScreenText(const char* text, int posX, int posY, int fontSize, Color co
 
 int GetRendererScreenWidth();
 int GetRendererScreenHeight();
+RendererBackend GetRendererBackend();
+int GetRendererFramesInFlight();
+
+// Keyboard and mouse state as polled by the last presented frame. Use these instead of raylib's
+// IsKeyDown etc. when pipelined: raylib polls input on the render thread. ReadInputEvents also
+// returns the changes between frames.
+bool IsRendererKeyDown(int key);
+bool IsRendererMouseButtonDown(int button);
+Vector2 GetRendererMousePosition();
+
+// --- Frame Statistics ---
+// Stage timers are wall-clock milliseconds measured on the thread that calls the API, so work the
+// worker pool does in parallel counts once. Stages that run several times a frame accumulate.
+
+typedef struct RendererStats {
+    int drawCalls;            // Draw calls handed to raylib (textured slices count once per atlas page); 0 for headless software frames
+    int textureBinds;         // Times consecutive raylib draw calls switched texture
+    int texturedSlices;       // DrawTexturedWallSlice calls
+    int batchedQuads;         // Atlas quads the textured slices and sprites were merged into (GPU backend)
+    float floorMs;            // RenderRaycastFrame: casting textured floor/ceiling (including the upload)
+    float wallMs;             // RenderRaycastFrame: drawing flat halves and wall slices
+    int spritesDrawn;         // DrawRaycastSprites sprites with at least one column in front of the walls
+    uint64_t frameIndex;      // 1 for the first frame after InitRenderer
+    float frameMs;            // Start of BeginFrame to the end of EndFrame
+    float beginMs;            // BeginFrame: clearing the target
+    float lightingMs;         // RenderRaycastFrame: relighting lightmap chunks after lights or cells changed
+    float raycastMs;          // RenderRaycastFrame: DDA for every column
+    float spritesMs;          // DrawRaycastSprites
+    float textMs;             // DrawScreenText
+    float commandsMs;         // SubmitDrawCommands
+    float upscaleMs;          // Stretching a reduced-resolution native view to the screen (SetRenderScale)
+    float presentMs;          // EndFrame: flushing batches, uploading and presenting (includes any vsync wait and frame capture)
+    float waitMs;             // Pipelined: time the caller blocked before recording this frame, waiting for a free buffer
+    long long ddaSteps;       // DDA cell steps taken by RenderRaycastFrame
+    int raysCast;             // RenderRaycastFrame columns traced through the map
+    int raysReused;           // RenderRaycastFrame columns taken from the previous frame (SetRaycastFrameReuse)
+    long long textureLookups; // Texels sampled on the CPU (software rasterization, floor/ceiling casting)
+    float renderScale;        // Render scale of the native view this frame
+    int viewWidth;            // Columns and rows the native view was rendered at
+    int viewHeight;
+    int lightChunksRelit;     // Lightmap chunks RenderRaycastFrame relit (SetRaycastLights)
+} RendererStats;
+
+// Frames kept by the statistics history.
+#define RENDERER_STATS_HISTORY 256
+
+// Counters of the last frame completed by EndFrame.
+RendererStats GetRendererStats();
+// Copies up to maxFrames of the most recent completed frames into out, oldest first, and returns
+// how many were written. The history is a lock-free ring: any thread may read it while frames render.
+int GetRendererStatsHistory(RendererStats* out, int maxFrames);
+// Writes the frames in the history as a Chrome trace (JSON, open in chrome://tracing or Perfetto):
+// one span per stage plus per-frame counters. Returns false if the file cannot be written.
+bool WriteRendererTrace(const char* filePath);
+
+// Restarts the raycasting worker pool with a new thread count (same meaning as RendererConfig::workerThreads).
+void SetRendererWorkerThreads(int workerThreads);
+int GetRendererWorkerThreads();
+
+// --- Software Framebuffer ---
+// Only available with the software backends; both return nothing for RENDERER_BACKEND_RAYLIB.
+
+// Returns the live RGBA8 framebuffer (width * height * 4 bytes, row-major, top row first) without copying.
+// The pointer stays valid until ShutdownRenderer. When pipelined, both calls first wait for the frames
+// in flight; the contents then hold the last frame passed to EndFrame until the next EndFrame.
+const uint8_t* GetFramebuffer(int* width, int* height);
+// Writes the framebuffer to dst as an H x W x 4 column-major array (MATLAB image layout), height * width * 4 bytes.
+bool ReadFramebufferPlanar(uint8_t* dst);
+
+// --- Command Stream Submission ---
+// A frame's primitives can be submitted as one numeric table instead of one call each.
+// Every command is a row of fields: [opcode, p1 .. pN, R, G, B, A]. The first column is the
+// opcode, the last four are the color; parameters not present in the table read as 0.
+//   DRAW_CMD_RECT           x, y, width, height
+//   DRAW_CMD_LINE           x1, y1, x2, y2
+//   DRAW_CMD_WALL_SLICE     screenX, drawStartY, drawEndY
+//   DRAW_CMD_TEXTURED_SLICE screenX, drawStartY, drawEndY, drawWidth, textureId, texCoordX (color is the tint)
+// Opcodes that are not one of the integers below are skipped, as are commands with a NaN parameter.
+// Coordinates saturate at +-2^29 and texCoordX at [0, 1].
+
+enum DrawCommandOpcode {
+    DRAW_CMD_NOP = 0,
+    DRAW_CMD_RECT = 1,
+    DRAW_CMD_LINE = 2,
+    DRAW_CMD_WALL_SLICE = 3,
+    DRAW_CMD_TEXTURED_SLICE = 4
+};
+
+#define DRAW_CMD_MIN_FIELDS 9 // opcode + 4 params + RGBA
+#define DRAW_CMD_MAX_FIELDS 11 // opcode + 6 params + RGBA
+
+// Executes commandCount commands read in place from data. Field f of command i is
+// data[i * commandStride + f * fieldStride], so row-major C arrays (commandStride = fieldCount,
+// fieldStride = 1) and MATLAB column-major matrices (commandStride = 1, fieldStride = rows)
+// are both decoded without copying. Returns the number of commands drawn.
+int SubmitDrawCommands(const double* data, int commandCount, int fieldCount, size_t commandStride, size_t fieldStride);
+int SubmitDrawCommands(const float* data, int commandCount, int fieldCount, size_t commandStride, size_t fieldStride);
+
+// --- Native Raycasting ---
+// Map cells are row-major (map[y * mapW + x]); 0 is empty, any other value is a wall type.
+// Cell (x, y) covers [x, x+1) x [y, y+1) in world units.
+
+typedef struct RaycastCamera {
+    float posX;
+    float posY;
+    float angle; // View direction in radians (0 = +X, pi/2 = +Y)
+    float fov;   // Horizontal field of view in radians
+} RaycastCamera;
+
+typedef struct RaycastPalette {
+    const Color* wallColors; // wallColors[cell - 1] is used for map value 'cell'
+    int wallColorCount;
+    Color defaultWallColor;  // Used for wall types outside wallColors
+    Color ceilingColor;
+    Color floorColor;
+    float sideShade;         // Brightness multiplier applied to Y-side (N/S) hits
+    TextureID ceilingTexture; // Optional: textured ceiling and floor, repeated once per map cell.
+    TextureID floorTexture;   // 0 (or an unloaded ID) draws the flat color instead.
+} RaycastPalette;
+
+// Runs the DDA for every screen column and draws ceiling, floor and wall slices.
+// palette may be NULL to use the built-in demo colors.
+// Textured floors and ceilings are cast scanline by scanline on the CPU; with the GPU backend the
+// result is uploaded as one texture per frame.
+// Columns are cast in tiles on the worker pool. With a software backend the workers also
+// rasterize their own tiles; with the GPU backend the calling thread issues the draw calls.
+// A camera pose that is not finite or has a coordinate beyond +-2^30 skips the frame with a warning.
+void RenderRaycastFrame(const uint8_t* map, int mapW, int mapH, RaycastCamera camera, const RaycastPalette* palette);
+
+// --- Loaded Map ---
+// Instead of passing the map every frame, the engine can hold one. It is stored in square tiles
+// (32 x 32 cells by default) and identical tiles are kept once, so open space costs almost nothing.
+// Rays cross empty squares of 8, 64, 512 or 4096 cells per side in a single DDA step.
+// Map files (.rcmap) are memory-mapped: loading reads only the header and tile directory, and
+// tiles are paged in as rays first reach them. Cells are uint8 or uint16 (cellBytes 1 or 2).
+// The map stays loaded across InitRenderer and ShutdownRenderer.
+
+typedef struct RaycastMapInfo {
+    int width;
+    int height;
+    int cellBytes;        // 1 = uint8 cells, 2 = uint16 cells
+    int tileSize;         // Cells per tile side
+    int tileCount;        // Tiles covering the map
+    int storedTiles;      // Distinct tiles actually stored (including copies made by cell edits)
+    int emptyTiles;
+    bool memoryMapped;    // Cells are read from a mapped file rather than from memory
+    uint64_t version;     // Changes whenever the map is loaded, replaced, unloaded or edited
+} RaycastMapInfo;
+
+// Writes a dense row-major map (cells[y * width + x], each cellBytes wide) as a .rcmap file.
+bool SaveRaycastMap(const char* filePath, const void* cells, int width, int height, int cellBytes);
+// Replaces the loaded map with a memory-mapped .rcmap file. On failure no map is loaded.
+bool LoadRaycastMap(const char* filePath);
+// Replaces the loaded map with a copy of a dense row-major map, tiled in memory.
+bool SetRaycastMap(const void* cells, int width, int height, int cellBytes);
+void UnloadRaycastMap();
+// False if no map is loaded.
+bool GetRaycastMapInfo(RaycastMapInfo* info);
+// Returns -1 outside the map or when no map is loaded.
+int GetRaycastMapCell(int x, int y);
+// Edits one cell of the loaded map; the file behind a mapped map is never written.
+// Fails outside the map or for values that do not fit the cell width.
+bool SetRaycastMapCell(int x, int y, int value);
+// RenderRaycastFrame on the loaded map. Unlike the dense path it is not vectorised across
+// columns, but rays through open space take one step per empty square instead of one per cell.
+void RenderRaycastFrame(RaycastCamera camera, const RaycastPalette* palette);
+
+// --- Depth-Buffered Sprites ---
+
+typedef struct RaycastSprite {
+    float x;              // World position of the sprite's centre, same units as the map
+    float y;
+    TextureID textureId;
+    float scale;          // Height in wall heights (1 = as tall as a wall); width follows the texture's aspect
+    float verticalOffset; // Raises the centre above eye level, in wall heights (-(1 - scale) / 2 stands it on the floor)
+    Color tint;
+} RaycastSprite;
+
+// Draws camera-facing billboards into the view of the last RenderRaycastFrame of this frame,
+// hidden wherever that frame's walls are nearer. Sprites behind the camera or off screen are
+// culled, the rest are radix sorted far to near and drawn as the column runs the walls leave
+// visible. Scratch buffers are kept between frames, so steady-state submission does not allocate.
+// Software backends rasterize column tiles on the worker pool; the GPU backend batches the runs
+// of atlas textures into one quad batch per atlas page change.
+// Returns the number of sprites that had at least one visible column. When pipelined, the walls
+// are only cast when the frame is replayed, so it returns the number left after culling instead.
+int DrawRaycastSprites(const RaycastSprite* sprites, int spriteCount);
+
+// Instruction set used by the DDA packet kernels. Every level produces bit-identical output.
+typedef enum RaycastSimdLevel {
+    RAYCAST_SIMD_AUTO = -1,  // AVX2 if the CPU supports it, otherwise scalar (default)
+    RAYCAST_SIMD_SCALAR = 0, // One ray at a time
+    RAYCAST_SIMD_SSE2 = 1,   // 4 columns per packet; slower than scalar, never picked by AUTO
+    RAYCAST_SIMD_AVX2 = 2    // 8 columns per packet, gathered map fetches
+} RaycastSimdLevel;
+
+// Levels above what the CPU supports are clamped down. Mainly useful for benchmarking and validation.
+void SetRaycastSimdLevel(RaycastSimdLevel level);
+RaycastSimdLevel GetRaycastSimdLevel();
+
+// --- Frame Reuse ---
+// RenderRaycastFrame keeps the hits of its last frame. When the next one is rendered from the same
+// position, field of view, resolution and map, its DDA is skipped where possible: an unchanged
+// heading reuses every column, and a pure rotation rebuilds each column whose ray falls between two
+// previous rays that met the same wall face (no wall fits in such a sliver). Only the other columns
+// are cast. Rebuilt distances are computed in closed form and may differ from a cast in the last bit.
+// Edits to the loaded map discard the hits through its version. A dense map is compared with a copy
+// of the last one, so dense maps above RAYCAST_REUSE_MAX_DENSE_CELLS are never reused; hand large
+// maps to SetRaycastMap instead. The reuse rate is raysReused / (raysCast + raysReused) in
+// RendererStats. Enabled by default.
+
+#define RAYCAST_REUSE_MAX_DENSE_CELLS (1 << 20)
+
+void SetRaycastFrameReuse(bool enabled);
+bool GetRaycastFrameReuse();
+
+// --- Dynamic Resolution ---
+// The native view (RenderRaycastFrame and DrawRaycastSprites) can be rendered at a fraction of the
+// screen size: columns and rows both shrink by the render scale, and the view is stretched back to
+// the screen (nearest neighbour) by the next other draw or EndFrame. Wall slices, sprites, shapes,
+// text and command tables are always drawn at full resolution, so HUDs stay sharp. Call
+// DrawRaycastSprites right after its RenderRaycastFrame: once the view is stretched it fails (when
+// pipelined, at record time). A pipelined frame keeps the scale it had when BeginFrame recorded it.
+//
+// With a frame budget, a controller picks the scale of every frame from the render times of the
+// ones before: the engine's own stage times (everything in RendererStats but presentMs and
+// waitMs), so vsync and the caller's code between draw calls do not drive it. Above the budget
+// the scale drops at once to what should fit; with more than 15% headroom it climbs back by a few
+// percent a frame. The scale and view size of each frame are also in RendererStats.
+
+#define RENDER_SCALE_MIN 0.25f
+#define RENDER_SCALE_WINDOW 120 // Frames RenderScaleStatus::withinBudget looks back over
+
+typedef struct RenderScaleStatus {
+    float scale;           // Scale the next frame will use
+    int viewWidth;         // Native view size at that scale
+    int viewHeight;
+    float frameBudgetMs;   // 0 while the controller is off
+    float minScale;
+    float maxScale;
+    float smoothedMs;      // Moving average of the measured render times
+    float withinBudget;    // Fraction of the last measured frames (up to RENDER_SCALE_WINDOW) at or under the budget
+    int measuredFrames;
+} RenderScaleStatus;
+
+// Renders the native view at a fixed scale (clamped to RENDER_SCALE_MIN .. 1) and turns the controller off.
+void SetRenderScale(float scale);
+// Turns the controller on, keeping the scale within [minScale, maxScale]. budgetMs <= 0 turns it
+// off and keeps the current scale.
+void SetRenderScaleBudget(float budgetMs, float minScale, float maxScale);
+RenderScaleStatus GetRenderScaleStatus();
+
+// --- Lighting ---
+// Point lights and an ambient level shade the native view: walls, floor, ceiling and the sprites of
+// DrawRaycastSprites. Light is not evaluated per pixel. It is cached in a lightmap of 4 luxels along
+// every wall face and 4 x 4 per floor cell, so drawing costs one lookup per wall column and per floor
+// pixel however many lights there are. Walls cast shadows; lights hang at mid-wall height, so floor
+// and ceiling receive the same light. The palette's sideShade still applies on top.
+// The lightmap is kept in chunks of 16 x 16 cells, only where lights reach. When a light changes or a
+// cell of the rendered map changes (SetRaycastMapCell, or a dense map passed with other cells), the
+// next RenderRaycastFrame relights just the chunks of the lights concerned (lightingMs and
+// lightChunksRelit in RendererStats). Rendering a map of another size, or switching between a dense
+// map and the loaded one, relights everything. ShutdownRenderer clears the lights and turns lighting off.
+
+#define RAYCAST_LIGHT_MAX_RADIUS 64.0f
+
+typedef struct RaycastLight {
+    float x;         // World position, same units as the map
+    float y;
+    float radius;    // Cells; the light fades out at this distance. Clamped to RAYCAST_LIGHT_MAX_RADIUS
+    float intensity; // 1 gives a wall facing the light at point-blank range the light's full color
+    Color color;     // Alpha is ignored
+} RaycastLight;
+
+// Off by default. Places no light reaches show the ambient level; WHITE leaves colors unchanged.
+void SetRaycastLighting(bool enabled, Color ambient);
+// Replaces every light. A light equal to the one at the same index before costs nothing, so keep the
+// order stable and only the lights that moved or changed are relit.
+void SetRaycastLights(const RaycastLight* lights, int count);
+
+// --- Batch Rendering ---
+// Renders many camera poses of one map in a single call, for simulations and dataset generation,
+// without a window or the frame loop. Views are spread over the worker pool, one view per worker at
+// a time, so a batch of at least as many views as workers keeps every core busy. Each view is drawn
+// like RenderRaycastFrame with the same palette and lighting (no sprites, no render scale) straight
+// into the caller's buffers; the workers' scratch is kept between calls, so once a batch has run at
+// a resolution the next one allocates nothing. Works with any backend and leaves the framebuffer,
+// frame statistics and frame reuse alone. With frames in flight it runs after the submitted frames,
+// so settings recorded since the last EndFrame (SetRaycastLights, ...) do not apply to it yet.
+
+typedef enum RaycastBatchLayout {
+    RAYCAST_BATCH_ROW_MAJOR,   // Top row first, RGBA interleaved, like GetFramebuffer
+    RAYCAST_BATCH_COLUMN_MAJOR // height x width arrays, RGBA as four of them (MATLAB's image layout)
+} RaycastBatchLayout;
+
+// Each output holds viewCount images of width x height values, view after view; NULL skips it.
+typedef struct RaycastBatchOutput {
+    int width;
+    int height;
+    RaycastBatchLayout layout;
+    uint8_t* rgba;  // 4 bytes per pixel
+    float* depth;   // Distance along the view direction to the wall, floor or ceiling point shown
+    int32_t* cells; // y * mapW + x of the wall cell shown, -1 on the floor and ceiling; maps of at most INT32_MAX cells
+} RaycastBatchOutput;
+
+typedef struct RaycastBatchStats {
+    int viewCount;        // Of the last batch
+    int width;
+    int height;
+    float batchMs;        // Whole call, relighting included
+    float viewsPerSecond;
+    long long ddaSteps;
+} RaycastBatchStats;
+
+// Renders cameras[0..viewCount). Returns viewCount, or 0 with a warning (and nothing written) if an
+// argument is invalid, a camera pose is not finite or has a coordinate beyond +-2^30, or cells is
+// set for a map of more than INT32_MAX cells. palette may be NULL, as for RenderRaycastFrame.
+int RenderRaycastBatch(const uint8_t* map, int mapW, int mapH, const RaycastCamera* cameras, int viewCount,
+    const RaycastPalette* palette, const RaycastBatchOutput* output);
+// Same against the loaded map.
+int RenderRaycastBatch(const RaycastCamera* cameras, int viewCount, const RaycastPalette* palette, const RaycastBatchOutput* output);
+RaycastBatchStats GetRaycastBatchStats();
+
+// --- Ray Queries ---
+// Casts arbitrary rays through a map and reports what each one hits, without drawing anything: depth
+// sensors, LIDAR sweeps, line-of-sight tests. Rays are split over the worker pool. On a dense map they
+// run through the SIMD packet kernels (SetRaycastSimdLevel), 4 or 8 rays at a time; on the loaded map
+// they cross empty squares in one step. A ray starts in the cell holding its origin and reports the first
+// wall cell it enters after it, so a ray starting inside a wall does not see that wall. Rays whose origin
+// lies outside the map, or whose direction is zero or not finite, hit nothing.
+// Ray i is a row of fields read in place like SubmitDrawCommands: field f is
+// rays[i * rayStride + f * fieldStride]. Three fields are [x, y, angle] (radians, 0 = +X, pi/2 = +Y),
+// four are [x, y, dirX, dirY] (any length other than 0).
+
+// Each output holds rayCount values; NULL skips it. Rays that hit nothing report INFINITY, -1, -1 and NaN.
+typedef struct RaycastRayOutput {
+    float* distances; // From the origin to the wall along the ray, in cells
+    int32_t* cells;   // y * mapW + x of the wall cell hit; maps of at most INT32_MAX cells
+    int8_t* sides;    // 0 = hit an X face (E/W), 1 = hit a Y face (N/S)
+    float* texCoords; // Hit position along the wall face, [0, 1), as the texCoordX of a wall slice
+} RaycastRayOutput;
+
+// Returns the number of rays that hit a wall, or -1 with a warning (and nothing written) if an
+// argument is invalid or cells is set for a map of more than INT32_MAX cells. Runs after the frames in flight, like RenderRaycastBatch.
+int CastRaycastRays(const uint8_t* map, int mapW, int mapH, const double* rays, int rayCount, int fieldCount,
+    size_t rayStride, size_t fieldStride, const RaycastRayOutput* output);
+int CastRaycastRays(const uint8_t* map, int mapW, int mapH, const float* rays, int rayCount, int fieldCount,
+    size_t rayStride, size_t fieldStride, const RaycastRayOutput* output);
+// Same against the loaded map.
+int CastRaycastRays(const double* rays, int rayCount, int fieldCount, size_t rayStride, size_t fieldStride, const RaycastRayOutput* output);
+int CastRaycastRays(const float* rays, int rayCount, int fieldCount, size_t rayStride, size_t fieldStride, const RaycastRayOutput* output);
+
+// --- Frame Capture ---
+// Records every frame EndFrame presents to a file without holding up the render loop. Each frame is
+// copied into a ring of ringFrames preallocated frame buffers, and a background thread converts and
+// writes them to disk in order. If the disk falls behind and every buffer is still waiting, the new
+// frame is dropped (framesDropped) instead of stalling, so memory stays at ringFrames frames. The
+// copy is counted in presentMs: a memcpy with the software backends. With RENDERER_BACKEND_RAYLIB the
+// frame is read back into one of 3 preallocated pixel buffers and copied into the ring once the GPU
+// has finished it, a few frames later; only when all 3 are still in flight does EndFrame wait for the
+// oldest. Contexts without pixel buffers fall back to a blocking readback. Frames are captured at the
+// screen size after the native view is stretched, HUD included. With frames in flight, starting and
+// stopping take effect after the frames already submitted, and the counters may trail EndFrame.
+
+typedef enum FrameCaptureFormat {
+    FRAME_CAPTURE_Y4M = 0, // YUV4MPEG2 video, 4:2:0 BT.601 (ffmpeg, VLC and mpv read it as is)
+    FRAME_CAPTURE_RAW = 1  // Headerless RGBA8 frames back to back, width * height * 4 bytes each, top row first
+} FrameCaptureFormat;
+
+typedef struct FrameCaptureStats {
+    bool active;               // A capture is running
+    FrameCaptureFormat format; // Of the current or last capture
+    int width;
+    int height;
+    int ringFrames;
+    int queuedFrames;          // Copied into the ring, not written yet
+    uint64_t framesWritten;
+    uint64_t framesDropped;    // Presented while the ring was full, or after a write failed
+    uint64_t bytesWritten;     // Y4M header excluded
+    float writeMs;             // Writer thread: converting and writing the last frame
+    bool writeFailed;          // The file could not be written (disk full, ...); later frames are dropped
+} FrameCaptureStats;
+
+#define RENDERER_CAPTURE_MAX_FRAMES 256
+
+// Creates filePath and captures every frame presented from now on, stopping any capture first.
+// ringFrames <= 0 keeps 8 frames; more than RENDERER_CAPTURE_MAX_FRAMES, or than fit in 1 GiB, are
+// capped with a warning. fps only goes into the Y4M header; <= 0 writes 30. Returns false with a
+// warning if the renderer is not initialized or the file cannot be created.
+bool StartFrameCapture(const char* filePath, FrameCaptureFormat format, int ringFrames, int fps);
+// Writes the frames still being read back or in the ring, closes the file and returns the final counters.
+FrameCaptureStats StopFrameCapture();
+// Counters of the running capture, or of the last one once stopped. Any thread may call it.
+FrameCaptureStats GetFrameCaptureStats();
+
+// --- Input Events and Frame Pacing ---
+// Every time the engine polls input it turns the changes since the last poll into timestamped
+// events in a ring of RENDERER_INPUT_EVENT_CAPACITY events, which ReadInputEvents drains. raylib
+// queues key presses between polls, so a key pressed and released within one frame still yields
+// both events. A full ring overwrites its oldest events (inputEventsDropped). Input is polled when
+// EndFrame presents and, with frame pacing, every pollMs while waiting for the next frame, so
+// timestamps are at most one poll late. Only the windowed backends produce events. The engine
+// empties raylib's GetKeyPressed queue to do this.
+//
+// Frame pacing presents at most targetFps frames a second. Instead of sleeping before the present,
+// EndFrame returns late: it waits after the present until the next frame's work, predicted from the
+// frames before, is due to finish on the next present slot. The caller reads input after that wait,
+// so it is as fresh as possible when the frame shows. The last millisecond of a wait spins, for
+// sleep granularity. With frames in flight the waits run on the render thread and the caller is held
+// back by the full pipeline instead. Extra polls call raylib's PollInputEvents, so raylib's own
+// IsKeyPressed etc. see one poll per pollMs rather than one per frame.
+
+#define RENDERER_INPUT_EVENT_CAPACITY 1024
+
+typedef enum InputEventType {
+    INPUT_EVENT_KEY_DOWN = 0,    // code: raylib KeyboardKey
+    INPUT_EVENT_KEY_UP = 1,
+    INPUT_EVENT_MOUSE_DOWN = 2,  // code: raylib MouseButton; x, y: mouse position
+    INPUT_EVENT_MOUSE_UP = 3,
+    INPUT_EVENT_MOUSE_MOVE = 4,  // x, y: new mouse position
+    INPUT_EVENT_MOUSE_WHEEL = 5  // x, y: wheel movement
+} InputEventType;
+
+typedef struct InputEvent {
+    double time;          // GetRendererTime() of the poll that saw the change
+    InputEventType type;
+    int code;             // 0 for moves and the wheel
+    float x;
+    float y;
+    uint64_t frameIndex;  // RendererStats::frameIndex of the last frame presented before the poll
+} InputEvent;
+
+typedef struct FramePacingStats {
+    float targetFps;          // 0 while pacing is off
+    float pollMs;
+    uint64_t framesPresented; // Since InitRenderer
+    double lastPresentTime;   // GetRendererTime() when the last present finished
+    float presentIntervalMs;  // Between the last two presents
+    float presentJitterMs;    // Moving average of how far present intervals stray from 1000 / targetFps
+    uint64_t missedSlots;     // Presents more than half a period after their slot
+    float predictedWorkMs;    // Time from the end of a wait to the next present the schedule allows for
+    float waitMs;             // Time EndFrame waited after the last present
+    float inputLatencyMs;     // From the oldest event ReadInputEvents returned before an EndFrame to that frame's present; < 0 before any
+    int inputEventsQueued;
+    uint64_t inputEventsDropped;
+} FramePacingStats;
+
+// Seconds since InitRenderer on a steady clock, the time base of InputEvent::time.
+double GetRendererTime();
+// Moves up to maxEvents of the oldest queued events into events and returns how many. Any thread may call it.
+int ReadInputEvents(InputEvent* events, int maxEvents);
+// targetFps <= 0 turns pacing off; InitRenderer starts with it off. pollMs <= 0 polls input only when presenting.
+void SetFramePacing(float targetFps, float pollMs);
+FramePacingStats GetFramePacingStats();
 
 #endif
 
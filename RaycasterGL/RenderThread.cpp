@@ -0,0 +1,152 @@
+// RenderThread.cpp
+#include "RenderThread.h"
+#include <chrono>
+
+// --- Frame Arena ---
+
+void* FrameArena::Allocate(size_t bytes) {
+    bytes = (bytes + 15) & ~(size_t)15;
+    while (m_block < m_blocks.size() && m_offset + bytes > m_blocks[m_block].size) {
+        ++m_block;
+        m_offset = 0;
+    }
+    if (m_block == m_blocks.size()) {
+        // Oversized payloads (e.g. a copied map) get a block of their own size
+        const size_t size = (bytes > kBlockSize) ? bytes : kBlockSize;
+        m_blocks.push_back(Block{ std::unique_ptr<uint8_t[]>(new uint8_t[size]), size });
+        m_offset = 0;
+    }
+    void* data = m_blocks[m_block].data.get() + m_offset;
+    m_offset += bytes;
+    m_usedBytes += bytes;
+    return data;
+}
+
+void FrameArena::Reset() {
+    m_block = 0;
+    m_offset = 0;
+    m_usedBytes = 0;
+}
+
+// --- Render Thread ---
+
+RenderThread::~RenderThread() {
+    Stop();
+}
+
+void RenderThread::Start(int framesInFlight, ReplayFn replay, void* replayContext) {
+    Stop();
+    m_framesInFlight = (framesInFlight > 0) ? framesInFlight : 1;
+    m_replay = replay;
+    m_replayContext = replayContext;
+    m_buffers.clear();
+    m_free.clear();
+    for (int i = 0; i <= m_framesInFlight; ++i) {
+        m_buffers.emplace_back(new CommandBuffer());
+        m_free.push_back(m_buffers.back().get());
+    }
+    m_recording = nullptr;
+    m_waitMs = 0.0f;
+    m_stopping = false;
+    m_thread = std::thread(&RenderThread::ThreadMain, this);
+    m_threadId = m_thread.get_id();
+}
+
+void RenderThread::Stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    m_threadId = std::thread::id();
+    m_recording = nullptr;
+    m_buffers.clear();
+    m_free.clear();
+    m_framesInFlight = 0;
+}
+
+CommandBuffer& RenderThread::GetRecordBuffer() {
+    if (m_recording == nullptr) {
+        const auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this] { return !m_free.empty(); });
+        m_recording = m_free.back();
+        m_free.pop_back();
+        lock.unlock();
+        m_waitMs += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return *m_recording;
+}
+
+float RenderThread::TakeWaitMs() {
+    const float waitMs = m_waitMs;
+    m_waitMs = 0.0f;
+    return waitMs;
+}
+
+void RenderThread::Submit() {
+    if (m_recording == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(Item{ m_recording, nullptr, nullptr, nullptr });
+    }
+    m_recording = nullptr;
+    m_wake.notify_one();
+}
+
+void RenderThread::Run(Task task, void* context) {
+    if (!m_thread.joinable() || IsRenderThread()) {
+        task(context);
+        return;
+    }
+    bool done = false;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_queue.push_back(Item{ nullptr, task, context, &done });
+    m_wake.notify_one();
+    m_finished.wait(lock, [&] { return done; });
+}
+
+void RenderThread::WaitIdle() {
+    if (!m_thread.joinable() || IsRenderThread()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this] { return m_queue.empty(); });
+}
+
+// Stopping lets the queue run dry first, so every submitted frame is presented
+void RenderThread::ThreadMain() {
+    for (;;) {
+        Item item;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            item = m_queue.front();
+        }
+
+        if (item.frame != nullptr) {
+            m_replay(*item.frame, m_replayContext);
+            item.frame->Reset();
+        }
+        else {
+            item.task(item.context);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.pop_front();
+            if (item.frame != nullptr) m_free.push_back(item.frame);
+            if (item.done != nullptr) *item.done = true;
+        }
+        m_finished.notify_all();
+    }
+}
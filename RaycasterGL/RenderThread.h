@@ -0,0 +1,127 @@
+// RenderThread.h
+// Internal dedicated render thread for pipelined submission (RendererConfig::framesInFlight).
+//
+// The caller's thread records each frame into a CommandBuffer: command payloads live in a frame
+// arena and the buffer only keeps (opcode, payload) pairs. EndFrame hands the buffer over and the
+// render thread replays it, while the caller records the next frame into another buffer. There
+// are framesInFlight + 1 buffers, so the caller waits once it is framesInFlight frames ahead.
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// Bump allocator for the payloads of one frame. Blocks are kept across Reset, so once a steady
+// frame has been recorded a few times recording stops allocating.
+class FrameArena {
+public:
+    FrameArena() = default;
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 16-byte aligned storage, valid until Reset.
+    void* Allocate(size_t bytes);
+    void Reset();
+    size_t GetUsedBytes() const { return m_usedBytes; }
+
+private:
+    static const size_t kBlockSize = 64 * 1024;
+
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_block = 0;  // Block being filled
+    size_t m_offset = 0; // Bytes used in m_blocks[m_block]
+    size_t m_usedBytes = 0;
+};
+
+struct RecordedCommand {
+    int opcode;
+    const void* payload; // In the buffer's arena
+};
+
+struct CommandBuffer {
+    FrameArena arena;
+    std::vector<RecordedCommand> commands;
+
+    void Reset() {
+        arena.Reset();
+        commands.clear();
+    }
+};
+
+class RenderThread {
+public:
+    // Replays one submitted buffer, on the render thread.
+    typedef void (*ReplayFn)(const CommandBuffer& buffer, void* context);
+    typedef void (*Task)(void* context);
+
+    RenderThread() = default;
+    ~RenderThread();
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Starts the thread with framesInFlight + 1 command buffers, stopping any previous one first.
+    // replayContext is passed to every call of replay.
+    void Start(int framesInFlight, ReplayFn replay, void* replayContext);
+    // Waits for the submitted frames, then joins the thread. A frame still being recorded is dropped.
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+    bool IsRenderThread() const { return std::this_thread::get_id() == m_threadId; }
+    int GetFramesInFlight() const { return m_framesInFlight; }
+
+    // The buffer being recorded. Acquiring a new one waits while framesInFlight frames are queued;
+    // the time spent waiting is returned by the next TakeWaitMs.
+    CommandBuffer& GetRecordBuffer();
+    float TakeWaitMs();
+    // Queues the recorded buffer for replay. Does nothing if nothing was recorded.
+    void Submit();
+
+    // Runs task on the render thread after every submitted frame and blocks until it returns.
+    // Called on the render thread itself, it runs the task directly.
+    void Run(Task task, void* context);
+    template <typename Fn>
+    void RunOnThread(Fn& fn) {
+        Run([](void* context) { (*(Fn*)context)(); }, &fn);
+    }
+    // Blocks until every submitted frame has been replayed.
+    void WaitIdle();
+
+private:
+    struct Item {
+        CommandBuffer* frame; // Either a frame to replay...
+        Task task;            // ...or a task with its context
+        void* context;
+        bool* done;
+    };
+
+    void ThreadMain();
+
+    std::thread m_thread;
+    std::thread::id m_threadId;
+    ReplayFn m_replay = nullptr;
+    void* m_replayContext = nullptr;
+    int m_framesInFlight = 0;
+
+    std::vector<std::unique_ptr<CommandBuffer>> m_buffers;
+    CommandBuffer* m_recording = nullptr; // Owned by the caller's thread until Submit
+    float m_waitMs = 0.0f;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;     // Render thread: work queued or stopping
+    std::condition_variable m_finished; // Caller: an item finished
+    std::deque<Item> m_queue;           // Front is being replayed until it is popped
+    std::vector<CommandBuffer*> m_free;
+    bool m_stopping = false;
+};
+
+#endif
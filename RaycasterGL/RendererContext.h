@@ -0,0 +1,469 @@
+// RendererContext.h
+// Internal state of one renderer, shared by the engine's translation units: RaycasterEngine.cpp
+// (setup, frames, textures, raycasting), BatchRendering.cpp, RayQueries.cpp, Sprites.cpp and
+// CommandRecording.cpp (replay of pipelined frames). Only the engine includes it.
+#ifndef RENDERER_CONTEXT_H
+#define RENDERER_CONTEXT_H
+
+#include "RaycasterEngine.h"
+#include "FrameCapture.h"
+#include "FramePacer.h"
+#include "FrameProfiler.h"
+#include "InputEventRing.h"
+#include "Lightmap.h"
+#include "PixelReadback.h"
+#include "RaycastKernel.h"
+#include "RenderThread.h"
+#include "ResolutionController.h"
+#include "SoftwareRenderer.h"
+#include "TextureAtlas.h"
+#include "TextureLoader.h"
+#include "TiledMap.h"
+#include "WorkerPool.h"
+#include "raylib.h"
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <mutex>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+// --- Renderer Context ---
+// Everything one renderer owns lives in a RendererContext, so several renderers can run side by
+// side. The API functions act on the context bound to the calling thread (BindRendererContext),
+// g_defaultContext unless another one was bound. A pipelined context's render thread is bound to
+// it, so replayed frames go through the same functions. Everything else takes the context as an
+// argument, since the worker and loader threads are not bound to any.
+
+// Texture management: IDs handed to the EXE index a dense slot array.
+// An ID packs the slot index with the slot's generation, which is bumped whenever the slot is
+// freed, so a stale ID never resolves to a texture loaded later into the same slot.
+// Every texture keeps its mip chain as a column-major RGBA8 copy in CPU memory, so a software wall
+// slice reads one contiguous run of texels and floor casting can sample it on any backend.
+// GPU backends also keep a raylib Texture2D and place the chain in an atlas page so slices from
+// different textures batch together.
+struct TextureSlot {
+    Texture2D gpu = {};
+    std::vector<Color> columns; // Level l is columns[mipOffsets[l] + x * levelHeight + y]
+    int width = 0;
+    int height = 0;
+    int mipCount = 1;
+    size_t mipOffsets[kMaxMipLevels] = {};
+    int atlasPage = -1; // GPU only, -1 if the texture did not fit and is drawn on its own
+    int atlasX = 0;
+    int atlasY = 0;
+    unsigned int generation = 1; // Never 0, so no valid ID is 0 (0 signifies invalid/none)
+    bool live = false;
+    TextureLoadStatus status = TEXTURE_STATUS_INVALID; // READY once the fields above are filled in
+};
+
+static const int kTextureIndexBits = 20; // Up to ~1M live textures, 4096 generations per slot
+static const unsigned int kTextureIndexMask = (1u << kTextureIndexBits) - 1;
+
+// Wall texture atlas pages (GPU backend). Textured slices are queued per frame and drawn as one
+// quad batch per page, so switching wall textures between columns no longer breaks batching.
+struct AtlasPage {
+    Texture2D texture = {};
+    AtlasPacker packer;
+};
+
+struct QueuedSlice {
+    float x, y, width, height;
+    float u0, u1, v0, v1;
+    Color tint;
+    int page;
+};
+
+// What the hits of the last RenderRaycastFrame were cast from, so the next frame can reuse them
+// (SetRaycastFrameReuse). Kept across BeginFrame, unlike raycastViewReady.
+struct RaycastReuseState {
+    bool valid = false;
+    RaycastCamera camera = {};
+    CameraRaySetup setup = {};
+    bool tiled = false;
+    uint64_t mapVersion = 0;       // Loaded map: its version
+    int mapW = 0;                  // Dense map: its size and a copy of its cells
+    int mapH = 0;
+    std::vector<uint8_t> mapCells;
+};
+
+// RenderRaycastBatch: what the views one worker renders reuse, so only the first batch at a
+// resolution allocates
+struct BatchScratch {
+    CameraRayTable rays;
+    std::vector<RaycastHit> hits;
+    std::vector<Color> pixels; // RAYCAST_BATCH_COLUMN_MAJOR images are drawn here, then transposed
+    long long ddaSteps = 0;
+};
+
+// A sprite that survived culling, projected into the view of the last raycast frame
+struct ProjectedSprite {
+    const TextureSlot* slot;
+    Rectangle dest;  // Screen rectangle of the whole billboard
+    float depth;     // Distance along the view direction, compared against the walls' perpDist
+    int colBegin;    // Screen columns whose pixel centres the billboard covers, clipped to the screen
+    int colEnd;
+    int level;       // Mip level matching the on-screen height
+    Color tint;
+    int visible;     // Set once any column is drawn
+};
+
+struct SpriteSortEntry {
+    uint32_t key;
+    uint32_t index;
+};
+
+// Input and window state published by the render thread after every presented frame, so the
+// caller never reads raylib state the render thread is updating
+static const int kInputKeyCount = 512;    // raylib's MAX_KEYBOARD_KEYS
+static const int kInputMouseButtons = 7;  // MOUSE_BUTTON_LEFT .. MOUSE_BUTTON_BACK
+struct InputSnapshot {
+    bool keys[kInputKeyCount];
+    bool mouseButtons[kInputMouseButtons];
+    Vector2 mousePosition;
+};
+
+struct RendererContext {
+    int screenWidth = 0;
+    int screenHeight = 0;
+    RendererBackend backend = RENDERER_BACKEND_RAYLIB;
+
+    std::vector<TextureSlot> textureSlots;
+    std::vector<unsigned int> freeTextureSlots;
+    // The slot table is only changed by the thread that renders, and only under this mutex, so
+    // another thread (the caller's, when pipelined) may read it while holding the lock
+    std::mutex textureMutex;
+
+    // Background decoding for LoadTexturesAsync; results are uploaded by InstallLoadedTextures
+    TextureLoader textureLoader;
+    std::vector<DecodedTexture> decodedTextures;
+    int textureLoadThreads = 0;
+    std::atomic<TextureID> texturePlaceholder{ 0 };
+
+    std::vector<AtlasPage> atlasPages;
+    std::vector<QueuedSlice> sliceBatch;
+
+    // Frame counters: frameStats accumulates between BeginFrame and EndFrame, which hands it to
+    // profiler together with the stage timers
+    RendererStats frameStats = {};
+    FrameProfiler profiler;
+    unsigned int boundTexture = 0; // Texture the last counted draw call used, 0 = raylib's default
+
+    // Software backends: the frame is rasterized into this tightly packed RGBA8 buffer
+    std::vector<Color> framebuffer;
+    SoftwareTarget softwareTarget;
+    Texture2D presentTexture = {}; // SOFTWARE_WINDOWED only: receives one upload of framebuffer per frame
+
+    // Textured floor/ceiling with the GPU backend: rows are cast into planeBuffer and uploaded
+    // to planeTexture once per frame
+    std::vector<Color> planeBuffer;
+    Texture2D planeTexture = {};
+
+    // Dynamic resolution: the native view of the frame is viewWidth x viewHeight. Below the screen
+    // size it is drawn into viewBuffer (software) or the top-left corner of viewTexture (GPU), and
+    // FinishScaledView stretches it to the screen
+    ResolutionController resolution;
+    std::mutex resolutionMutex; // resolution is set from the caller's thread and fed by the renderer's
+    int viewWidth = 0;
+    int viewHeight = 0;
+    bool viewActive = false; // The view target is bound and not stretched yet
+    std::vector<Color> viewBuffer;
+    std::vector<int> stretchColumns; // Software: view column shown in each screen column
+    RenderTexture2D viewTexture = {};
+
+    // Map held by the engine (LoadRaycastMap / SetRaycastMap), independent of InitRenderer
+    TiledMap loadedMap;
+
+    // Persistent threads for column-parallel raycasting
+    WorkerPool workerPool;
+
+    // Camera of the last RenderRaycastFrame; its per-column hits double as the depth buffer for
+    // DrawRaycastSprites until the next BeginFrame.
+    CameraRaySetup raycastView = {};
+    bool raycastViewReady = false;
+    bool raycastViewLit = false; // That frame was lit, so its sprites are too
+
+    // Lights of the native view (SetRaycastLights), relit on the renderer's thread as they change
+    Lightmap lightmap;
+    std::vector<int> dirtyLightChunks;
+
+    RaycastReuseState raycastReuse;
+    std::atomic<bool> raycastReuseEnabled{ true };
+
+    std::vector<BatchScratch> batchScratch; // One per worker
+    std::vector<float> batchPlaneDepth;     // Distance of the floor or ceiling shown on each row
+    RaycastBatchStats batchStats = {};
+
+    // Pipelined submission (RendererConfig::framesInFlight > 0): the caller's thread records frames
+    // that renderThread replays. recordedView is the caller's copy of raycastView, and
+    // recordedViewOpen its copy of viewActive: nothing but raycasts and sprites recorded since the
+    // last RenderRaycastFrame of a frame with a view of recordedViewWidth x recordedViewHeight.
+    RenderThread renderThread;
+    CameraRaySetup recordedView = {};
+    bool recordedViewReady = false;
+    bool recordedViewOpen = false;
+    int recordedViewWidth = 0;
+    int recordedViewHeight = 0;
+
+    std::mutex inputMutex;
+    InputSnapshot inputSnapshot = {};
+    std::atomic<bool> windowCloseRequested{ false };
+
+    // ReadInputEvents: after every poll, the thread that owns the window compares raylib's input
+    // state with the polled* copies of what it saw last and pushes the differences into inputEvents
+    InputEventRing inputEvents;
+    std::vector<InputEvent> polledEvents; // Scratch of one poll, reserved for the most one can produce
+    bool polledKeys[kInputKeyCount] = {};
+    bool polledMouseButtons[kInputMouseButtons] = {};
+    Vector2 polledMousePosition = {};
+    double inputReadTime = -1.0; // Under inputMutex: oldest event ReadInputEvents returned since the last EndFrame
+
+    // Frame pacing runs on the thread that presents; GetFramePacingStats reads it under pacingMutex
+    FramePacer pacer;
+    std::mutex pacingMutex;
+    std::chrono::steady_clock::time_point timeBase; // GetRendererTime() == 0, set by InitRenderer
+
+    // StartFrameCapture: EndFrame copies each presented frame into its ring on the thread that renders.
+    // With RENDERER_BACKEND_RAYLIB, frames reach the ring through captureReadback a few frames late.
+    FrameCapture frameCapture;
+    PixelReadback captureReadback;
+
+    // Per-column hit buffer, reused across frames so steady-state rendering does not allocate.
+    // Each worker writes only the columns of the tiles it claimed.
+    std::vector<RaycastHit> raycastHits;
+    // The previous frame's hits while a rotated frame is rebuilt from them
+    std::vector<RaycastHit> previousRaycastHits;
+    // cameraX of every column, rebuilt only when the resolution or field of view changes
+    CameraRayTable cameraRayTable;
+    // Shaded wall colors of the frame's palette, see BuildWallColorTable
+    std::vector<Color> wallColorTable;
+
+    // Per-frame sprite scratch, grown on demand and never shrunk
+    std::vector<ProjectedSprite> projectedSprites;
+    std::vector<SpriteSortEntry> spriteOrder;
+    std::vector<SpriteSortEntry> spriteSortScratch;
+    std::vector<int> spriteTileStart;  // Software: sprites overlapping tile t are spriteTileList[start[t] .. start[t + 1])
+    std::vector<int> spriteTileList;
+    std::vector<QueuedSlice> spriteQuads;
+};
+
+extern RendererContext g_defaultContext;
+extern thread_local RendererContext* t_boundContext;
+
+inline RendererContext& CurrentContext() {
+    RendererContext* context = t_boundContext;
+    return context ? *context : g_defaultContext;
+}
+
+inline TextureID MakeTextureID(unsigned int index, unsigned int generation) {
+    return (generation << kTextureIndexBits) | index;
+}
+
+// The slot an ID refers to, whatever its load status
+inline TextureSlot* FindTextureSlot(RendererContext& ctx, TextureID textureId) {
+    const unsigned int index = textureId & kTextureIndexMask;
+    if (index >= ctx.textureSlots.size()) {
+        return nullptr;
+    }
+    TextureSlot& slot = ctx.textureSlots[index];
+    return (slot.live && MakeTextureID(index, slot.generation) == textureId) ? &slot : nullptr;
+}
+
+// The texture to draw for an ID: the texture itself once ready, the placeholder while pending
+inline TextureSlot* FindTexture(RendererContext& ctx, TextureID textureId) {
+    TextureSlot* slot = FindTextureSlot(ctx, textureId);
+    if (slot != nullptr && slot->status == TEXTURE_STATUS_PENDING) {
+        slot = FindTextureSlot(ctx, ctx.texturePlaceholder.load(std::memory_order_relaxed));
+    }
+    return (slot != nullptr && slot->status == TEXTURE_STATUS_READY) ? slot : nullptr;
+}
+
+inline bool IsSoftwareBackend(RendererContext& ctx) {
+    return ctx.backend != RENDERER_BACKEND_RAYLIB;
+}
+
+inline bool HasWindow(RendererContext& ctx) {
+    return ctx.backend != RENDERER_BACKEND_SOFTWARE;
+}
+
+// True on the caller's thread of a pipelined renderer, where API calls record instead of drawing
+inline bool IsRecording(RendererContext& ctx) {
+    return ctx.renderThread.IsRunning() && !ctx.renderThread.IsRenderThread();
+}
+
+inline SoftwareTexture SoftwareTextureFromSlot(const TextureSlot& slot, int level = 0) {
+    const int height = MipLevelHeight(slot.height, level);
+    // Column-major: each texture column is contiguous
+    return SoftwareTexture{ slot.columns.data() + slot.mipOffsets[level], MipLevelWidth(slot.width, level), height, height, 1 };
+}
+
+// GPU backends: counts one raylib draw call and whether it switches the bound texture
+inline void CountGpuDraw(RendererContext& ctx, unsigned int textureId) {
+    ++ctx.frameStats.drawCalls;
+    if (textureId != ctx.boundTexture) {
+        ++ctx.frameStats.textureBinds;
+        ctx.boundTexture = textureId;
+    }
+}
+
+// --- Command Recording ---
+// Payloads of the commands recorded while pipelined. Pointers in them point into the same frame's
+// arena, so the caller's arrays may change as soon as the recording call returns.
+
+enum RecordedOpcode {
+    REC_BEGIN_FRAME,
+    REC_END_FRAME,
+    REC_WALL_SLICE,
+    REC_TEXTURED_SLICE,
+    REC_SPRITE,
+    REC_RECT,
+    REC_LINE,
+    REC_TEXT,
+    REC_DRAW_COMMANDS,
+    REC_RAYCAST,
+    REC_RAYCAST_SPRITES,
+    REC_LIGHTING,
+    REC_LIGHTS
+};
+
+struct RecBeginFrame {
+    float waitMs;
+    float renderScale; // Read when recording, so the frame replays at the size recordedView assumed
+};
+
+struct RecEndFrame {
+    double inputTime; // Oldest input event the frame was built from, < 0 if none
+};
+
+struct RecTexturedSlice {
+    int screenX, drawStartY, drawEndY;
+    float drawWidth;
+    TextureID textureId;
+    float texCoordX;
+    Color tint;
+};
+
+struct RecSprite {
+    TextureID textureId;
+    Rectangle sourceRec;
+    Rectangle destRec;
+    Vector2 origin;
+    float rotation;
+    Color tint;
+};
+
+// Rectangles, lines (x1, y1, x2, y2) and wall slices (screenX, drawStartY, drawEndY)
+struct RecShape {
+    int a, b, c, d;
+    Color color;
+};
+
+struct RecText {
+    const char* text;
+    int posX, posY, fontSize;
+    Color color;
+};
+
+struct RecDrawCommands {
+    const double* data; // Row-major, fieldCount per command
+    int commandCount;
+    int fieldCount;
+};
+
+struct RecRaycast {
+    RaycastCamera camera;
+    RaycastPalette palette;
+    bool hasPalette;
+    const uint8_t* map; // nullptr draws the loaded map
+    int mapW, mapH;
+};
+
+struct RecRaycastSprites {
+    const RaycastSprite* sprites;
+    int spriteCount;
+};
+
+struct RecLighting {
+    bool enabled;
+    Color ambient;
+};
+
+struct RecLights {
+    const RaycastLight* lights;
+    int count;
+};
+
+// Appends a command with an uninitialised payload of type T (nullptr for void) to the frame being recorded
+template <typename T>
+inline T* RecordCommand(RendererContext& ctx, RecordedOpcode opcode) {
+    CommandBuffer& buffer = ctx.renderThread.GetRecordBuffer();
+    T* payload = nullptr;
+    if constexpr (!std::is_void_v<T>) {
+        payload = (T*)buffer.arena.Allocate(sizeof(T));
+    }
+    buffer.commands.push_back(RecordedCommand{ opcode, payload });
+    // Anything else drawn stretches a scaled view to the screen on replay (FinishScaledView)
+    if (opcode != REC_RAYCAST_SPRITES && opcode != REC_LIGHTING && opcode != REC_LIGHTS) {
+        ctx.recordedViewOpen = false;
+    }
+    return payload;
+}
+
+// Copies bytes into the arena of the frame being recorded
+inline void* RecordBytes(RendererContext& ctx, const void* data, size_t bytes) {
+    void* copy = ctx.renderThread.GetRecordBuffer().arena.Allocate(bytes);
+    if (data != nullptr && bytes > 0) memcpy(copy, data, bytes);
+    return copy;
+}
+
+
+// --- Shared Engine Functions ---
+// Defined in RaycasterEngine.cpp unless noted.
+
+// Columns per work-stealing tile: a whole number of AVX2 packets and of 64-byte pixel rows
+constexpr int kRaycastTileColumns = 32;
+
+// Cell IDs y * width + x are int32_t, so only maps of up to INT32_MAX cells can report them
+inline bool HasInt32CellIds(int width, int height) {
+    return (int64_t)width * height <= INT32_MAX;
+}
+
+// The DDA floors camera positions to int map cells, so a usable pose is finite with both
+// coordinates within +-2^30
+constexpr float kMaxCameraCoordinate = 1073741824.0f;
+
+inline bool IsUsableCameraPose(const RaycastCamera& camera) {
+    return fabsf(camera.posX) <= kMaxCameraCoordinate && fabsf(camera.posY) <= kMaxCameraCoordinate &&
+        isfinite(camera.angle) && isfinite(camera.fov);
+}
+
+extern const RaycastPalette g_defaultPalette;
+
+// Texture atlas batching (GPU backends)
+void EmitQuad(RendererContext& ctx, const QueuedSlice& quad);
+void FlushSliceBatch(RendererContext& ctx);
+
+// Dynamic resolution
+bool IsViewScaled(RendererContext& ctx);
+
+// Frames
+void BeginFrameAtScale(RendererContext& ctx, float renderScale);
+void PresentFrame(RendererContext& ctx, double inputTime);
+void PublishInputState(RendererContext& ctx);
+void ReplayFrame(const CommandBuffer& buffer, void* context); // CommandRecording.cpp
+
+// Native raycasting
+void BuildWallColorTable(const RaycastPalette& palette, std::vector<Color>& table);
+bool IsOpaqueRaycastPalette(const RaycastPalette& palette, bool flatCeiling, bool flatFloor);
+long long CastPlaneRows(const CameraRaySetup& setup, const RaycastPalette& palette, const TextureSlot* ceiling,
+    const TextureSlot* floor, const Lightmap* lightmap, Color* pixels, int rowBegin, int rowEnd);
+void RasterizeRaycastColumns(SoftwareTarget& target, const CameraRaySetup& setup, const RaycastPalette& palette,
+    const Color* wallColors, const RaycastHit* hits, const Lightmap* lightmap, bool castCeiling, bool castFloor,
+    int colBegin, int colEnd);
+// MapView is RaycastMapView or TiledMapView
+template <typename MapView>
+int UpdateLightmap(RendererContext& ctx, const MapView& view);
+
+
+#endif
@@ -0,0 +1,78 @@
+// ResolutionController.cpp
+#include "ResolutionController.h"
+#include <algorithm>
+#include <math.h>
+
+static const float kSmoothing = 0.25f;   // Weight of the newest frame in the moving average
+static const float kTargetFill = 0.9f;   // Scale changes aim at this fraction of the budget
+static const float kHeadroom = 0.85f;    // Climb back only below this fraction of the budget
+static const float kMaxStepDown = 0.7f;  // Per-frame bounds of the scale change
+static const float kMaxStepUp = 1.03f;
+
+static float ClampScale(float scale, float minScale, float maxScale) {
+    return isfinite(scale) ? std::clamp(scale, minScale, maxScale) : maxScale;
+}
+
+void ResolutionController::ResetHistory() {
+    m_smoothedMs = 0.0f;
+    m_measured = 0;
+    m_next = 0;
+}
+
+void ResolutionController::SetFixed(float scale) {
+    m_budgetMs = 0.0f;
+    m_minScale = RENDER_SCALE_MIN;
+    m_maxScale = 1.0f;
+    m_scale = ClampScale(scale, RENDER_SCALE_MIN, 1.0f);
+    ResetHistory();
+}
+
+void ResolutionController::SetBudget(float budgetMs, float minScale, float maxScale) {
+    if (!(budgetMs > 0.0f) || !isfinite(budgetMs)) {
+        m_budgetMs = 0.0f;
+        return;
+    }
+    m_minScale = ClampScale(minScale, RENDER_SCALE_MIN, 1.0f);
+    m_maxScale = ClampScale(maxScale, m_minScale, 1.0f);
+    m_budgetMs = budgetMs;
+    m_scale = ClampScale(m_scale, m_minScale, m_maxScale);
+    ResetHistory();
+}
+
+// Render time is taken to grow with the pixel count, i.e. with the square of the scale
+void ResolutionController::Update(float renderMs) {
+    if (!(renderMs >= 0.0f) || !isfinite(renderMs)) {
+        return;
+    }
+    m_smoothedMs = (m_measured == 0) ? renderMs : m_smoothedMs + kSmoothing * (renderMs - m_smoothedMs);
+    m_within[m_next] = (m_budgetMs > 0.0f && renderMs <= m_budgetMs) ? 1 : 0;
+    m_next = (m_next + 1) % RENDER_SCALE_WINDOW;
+    m_measured = std::min(m_measured + 1, RENDER_SCALE_WINDOW);
+    if (m_budgetMs <= 0.0f || m_smoothedMs <= 0.0f) {
+        return;
+    }
+
+    const float fit = m_scale * sqrtf(kTargetFill * m_budgetMs / m_smoothedMs);
+    float scale = m_scale;
+    if (m_smoothedMs > m_budgetMs) scale = std::max(fit, m_scale * kMaxStepDown);
+    else if (m_smoothedMs < kHeadroom * m_budgetMs) scale = std::min(fit, m_scale * kMaxStepUp);
+    scale = ClampScale(scale, m_minScale, m_maxScale);
+    if (scale != m_scale) {
+        // Predict the average at the new scale, so the frames still in it do not push it further
+        const float ratio = scale / m_scale;
+        m_smoothedMs *= ratio * ratio;
+        m_scale = scale;
+    }
+}
+
+void ResolutionController::GetStatus(RenderScaleStatus& status) const {
+    status.scale = m_scale;
+    status.frameBudgetMs = m_budgetMs;
+    status.minScale = m_minScale;
+    status.maxScale = m_maxScale;
+    status.smoothedMs = m_smoothedMs;
+    status.measuredFrames = m_measured;
+    int within = 0;
+    for (int i = 0; i < m_measured; ++i) within += m_within[i];
+    status.withinBudget = (m_measured > 0 && m_budgetMs > 0.0f) ? (float)within / (float)m_measured : 0.0f;
+}
@@ -0,0 +1,36 @@
+// ResolutionController.h
+// Internal frame-time budget controller behind SetRenderScaleBudget. Fed the render time of each
+// finished frame, it picks the render scale of the next one. Not thread-safe: the engine guards it.
+#ifndef RESOLUTION_CONTROLLER_H
+#define RESOLUTION_CONTROLLER_H
+
+#include "RaycasterEngine.h"
+#include <stdint.h>
+
+class ResolutionController {
+public:
+    // Fixed scale with the controller off; also forgets the measurements.
+    void SetFixed(float scale);
+    // budgetMs <= 0 turns the controller off and keeps the current scale.
+    void SetBudget(float budgetMs, float minScale, float maxScale);
+    // Records a finished frame and adjusts the scale if the controller is on.
+    void Update(float renderMs);
+
+    float GetScale() const { return m_scale; }
+    // Everything but the view size.
+    void GetStatus(RenderScaleStatus& status) const;
+
+private:
+    void ResetHistory();
+
+    float m_scale = 1.0f;
+    float m_budgetMs = 0.0f;
+    float m_minScale = RENDER_SCALE_MIN;
+    float m_maxScale = 1.0f;
+    float m_smoothedMs = 0.0f; // Valid once m_measured > 0
+    uint8_t m_within[RENDER_SCALE_WINDOW] = {};
+    int m_measured = 0;        // Frames in m_within, up to RENDER_SCALE_WINDOW
+    int m_next = 0;
+};
+
+#endif
@@ -0,0 +1,322 @@
+// SoftwareRenderer.cpp
+#include "SoftwareRenderer.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+// --- Pixel Helpers ---
+
+static inline Color BlendOver(Color dst, Color src) {
+    const unsigned int a = src.a;
+    const unsigned int ia = 255 - a;
+    return Color{
+        (unsigned char)((src.r * a + dst.r * ia + 127) / 255),
+        (unsigned char)((src.g * a + dst.g * ia + 127) / 255),
+        (unsigned char)((src.b * a + dst.b * ia + 127) / 255),
+        (unsigned char)(a + (dst.a * ia + 127) / 255)
+    };
+}
+
+static inline void PutPixel(Color& dst, Color src) {
+    if (src.a == 255) dst = src;
+    else if (src.a != 0) dst = BlendOver(dst, src);
+}
+
+static inline Color Modulate(Color color, Color tint) {
+    if (tint.r == 255 && tint.g == 255 && tint.b == 255 && tint.a == 255) return color;
+    return Color{
+        (unsigned char)((color.r * tint.r + 127) / 255),
+        (unsigned char)((color.g * tint.g + 127) / 255),
+        (unsigned char)((color.b * tint.b + 127) / 255),
+        (unsigned char)((color.a * tint.a + 127) / 255)
+    };
+}
+
+// --- Primitives ---
+
+void SwClear(SoftwareTarget& target, Color color) {
+    std::fill_n(target.pixels, (size_t)target.width * target.height, color);
+}
+
+void SwFillRect(SoftwareTarget& target, int x, int y, int width, int height, Color color) {
+    // 64-bit edges: callers pass coordinates from MATLAB, anywhere in the int range
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = (int)std::min((int64_t)x + width, (int64_t)target.width);
+    const int y1 = (int)std::min((int64_t)y + height, (int64_t)target.height);
+    if (x0 >= x1 || y0 >= y1 || color.a == 0) return;
+
+    for (int row = y0; row < y1; ++row) {
+        Color* dst = target.pixels + (size_t)row * target.width;
+        if (color.a == 255) {
+            std::fill(dst + x0, dst + x1, color);
+        }
+        else {
+            for (int col = x0; col < x1; ++col) dst[col] = BlendOver(dst[col], color);
+        }
+    }
+}
+
+template <bool FlatPlane>
+void SwDrawWallRows(SoftwareTarget& target, int colBegin, int colEnd, int rowBegin, int rowEnd,
+    const int* top, const int* bottom, const Color* wallColors, Color plane) {
+    const int x0 = std::max(colBegin, 0);
+    const int x1 = std::min(colEnd, target.width);
+    rowBegin = std::max(rowBegin, 0);
+    rowEnd = std::min(rowEnd, target.height);
+    if (x0 >= x1) return;
+    top -= colBegin;
+    bottom -= colBegin;
+    wallColors -= colBegin;
+
+    // Row by row as packed 32-bit pixels: each row is a branch-free select the compiler can vectorize
+    uint32_t planeBits;
+    memcpy(&planeBits, &plane, sizeof(planeBits));
+    const uint32_t* wallBits = (const uint32_t*)wallColors;
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        uint32_t* dst = (uint32_t*)(target.pixels + (size_t)row * target.width);
+        for (int col = x0; col < x1; ++col) {
+            const uint32_t wall = 0u - (uint32_t)((top[col] <= row) & (row <= bottom[col]));
+            dst[col] = (wallBits[col] & wall) | ((FlatPlane ? planeBits : dst[col]) & ~wall);
+        }
+    }
+}
+
+template void SwDrawWallRows<true>(SoftwareTarget&, int, int, int, int, const int*, const int*, const Color*, Color);
+template void SwDrawWallRows<false>(SoftwareTarget&, int, int, int, int, const int*, const int*, const Color*, Color);
+
+void SwStretchRows(SoftwareTarget& target, const SoftwareTarget& source, const int* sourceColumns, int rowBegin, int rowEnd) {
+    rowBegin = std::max(rowBegin, 0);
+    rowEnd = std::min(rowEnd, target.height);
+    int previousRow = -1;
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        const int sourceRow = (int)((2LL * row + 1) * source.height / (2LL * target.height));
+        Color* dst = target.pixels + (size_t)row * target.width;
+        if (sourceRow == previousRow) {
+            // Magnified rows repeat: copy the row just written
+            memcpy(dst, dst - target.width, sizeof(Color) * target.width);
+            continue;
+        }
+        const Color* src = source.pixels + (size_t)sourceRow * source.width;
+        for (int x = 0; x < target.width; ++x) dst[x] = src[sourceColumns[x]];
+        previousRow = sourceRow;
+    }
+}
+
+void SwDrawColumn(SoftwareTarget& target, int x, int y0, int y1, Color color) {
+    if (x < 0 || x >= target.width || color.a == 0) return;
+    if (y0 > y1) std::swap(y0, y1);
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, target.height - 1);
+
+    Color* dst = target.pixels + (size_t)y0 * target.width + x;
+    for (int row = y0; row <= y1; ++row, dst += target.width) {
+        PutPixel(*dst, color);
+    }
+}
+
+// Clips the segment to the pixel centres of the target with Liang-Barsky. Doubles hold any int
+// endpoint exactly. Returns false if no part of the segment is on the target.
+static bool ClipLine(const SoftwareTarget& target, double& x0, double& y0, double& x1, double& y1) {
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    double t0 = 0.0, t1 = 1.0;
+    // Each edge as p * t <= q
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] = { x0, (double)(target.width - 1) - x0, y0, (double)(target.height - 1) - y0 };
+    for (int edge = 0; edge < 4; ++edge) {
+        if (p[edge] == 0.0) {
+            if (q[edge] < 0.0) return false; // Parallel to the edge and outside it
+            continue;
+        }
+        const double t = q[edge] / p[edge];
+        if (p[edge] < 0.0) t0 = std::max(t0, t);
+        else t1 = std::min(t1, t);
+        if (t0 > t1) return false;
+    }
+    const double startX = x0, startY = y0;
+    x0 = startX + t0 * dx;
+    y0 = startY + t0 * dy;
+    x1 = startX + t1 * dx;
+    y1 = startY + t1 * dy;
+    return true;
+}
+
+void SwDrawLine(SoftwareTarget& target, int x0, int y0, int x1, int y1, Color color) {
+    if (x0 == x1) {
+        SwDrawColumn(target, x0, y0, y1, color);
+        return;
+    }
+    const bool inside = x0 >= 0 && x0 < target.width && y0 >= 0 && y0 < target.height &&
+        x1 >= 0 && x1 < target.width && y1 >= 0 && y1 < target.height;
+    if (!inside) {
+        // Rasterize only the visible part, so far-off endpoints cost nothing and cannot overflow
+        double cx0 = x0, cy0 = y0, cx1 = x1, cy1 = y1;
+        if (target.width <= 0 || target.height <= 0 || !ClipLine(target, cx0, cy0, cx1, cy1)) return;
+        x0 = std::clamp((int)lround(cx0), 0, target.width - 1);
+        y0 = std::clamp((int)lround(cy0), 0, target.height - 1);
+        x1 = std::clamp((int)lround(cx1), 0, target.width - 1);
+        y1 = std::clamp((int)lround(cy1), 0, target.height - 1);
+    }
+    // Bresenham between on-target endpoints
+    int dx = abs(x1 - x0), sx = (x0 < x1) ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = (y0 < y1) ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        PutPixel(target.pixels[(size_t)y0 * target.width + x0], color);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+int SwDrawTexturedColumn(SoftwareTarget& target, int screenX, int drawStartY, int drawEndY, float drawWidth,
+    const SoftwareTexture& texture, float texCoordX, Color tint) {
+    const int spanHeight = drawEndY - drawStartY;
+    const int columns = (int)(drawWidth + 0.5f);
+    if (texture.pixels == nullptr || spanHeight <= 0 || columns <= 0) return 0;
+
+    int texX = (int)(texCoordX * texture.width);
+    texX = std::clamp(texX, 0, texture.width - 1);
+
+    const int x0 = std::max(screenX, 0);
+    const int x1 = (int)std::min((int64_t)screenX + columns, (int64_t)target.width);
+    const int y0 = std::max(drawStartY, 0);
+    const int y1 = std::min(drawEndY, target.height);
+    if (x0 >= x1 || y0 >= y1) return 0;
+
+    // Texture rows are stepped with the unclipped span so partially visible walls keep their mapping
+    const float vStep = (float)texture.height / (float)spanHeight;
+    float v = ((float)(y0 - drawStartY) + 0.5f) * vStep;
+    const Color* column = texture.pixels + (size_t)texX * texture.xStride;
+    for (int row = y0; row < y1; ++row, v += vStep) {
+        int texY = std::min((int)v, texture.height - 1);
+        Color texel = Modulate(column[(size_t)texY * texture.yStride], tint);
+        Color* dst = target.pixels + (size_t)row * target.width;
+        for (int col = x0; col < x1; ++col) PutPixel(dst[col], texel);
+    }
+    return y1 - y0; // One texel per row, shared by the columns
+}
+
+int SwDrawTexturePro(SoftwareTarget& target, const SoftwareTexture& texture, Rectangle source, Rectangle dest,
+    Vector2 origin, float rotation, Color tint) {
+    if (texture.pixels == nullptr || dest.width <= 0.0f || dest.height <= 0.0f) return 0;
+
+    const bool flipX = source.width < 0.0f;
+    const bool flipY = source.height < 0.0f;
+    if (flipX) source.width = -source.width;
+    if (flipY) source.height = -source.height;
+
+    // raylib rotates clockwise (screen space, y down) around dest.x/y, which is where origin lands
+    const float radians = rotation * (3.14159265358979f / 180.0f);
+    const float c = cosf(radians);
+    const float s = sinf(radians);
+
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+    const float cornersX[4] = { -origin.x, dest.width - origin.x, -origin.x, dest.width - origin.x };
+    const float cornersY[4] = { -origin.y, -origin.y, dest.height - origin.y, dest.height - origin.y };
+    for (int i = 0; i < 4; ++i) {
+        float px = dest.x + cornersX[i] * c - cornersY[i] * s;
+        float py = dest.y + cornersX[i] * s + cornersY[i] * c;
+        minX = std::min(minX, px); maxX = std::max(maxX, px);
+        minY = std::min(minY, py); maxY = std::max(maxY, py);
+    }
+    const int x0 = std::max((int)floorf(minX), 0);
+    const int y0 = std::max((int)floorf(minY), 0);
+    const int x1 = std::min((int)ceilf(maxX), target.width);
+    const int y1 = std::min((int)ceilf(maxY), target.height);
+
+    const float uScale = source.width / dest.width;
+    const float vScale = source.height / dest.height;
+    int sampled = 0;
+    for (int row = y0; row < y1; ++row) {
+        Color* dst = target.pixels + (size_t)row * target.width;
+        const float dy = (float)row + 0.5f - dest.y;
+        for (int col = x0; col < x1; ++col) {
+            const float dx = (float)col + 0.5f - dest.x;
+            // Inverse rotation back into the destination rectangle's local space
+            const float lx = dx * c + dy * s + origin.x;
+            const float ly = -dx * s + dy * c + origin.y;
+            if (lx < 0.0f || ly < 0.0f || lx >= dest.width || ly >= dest.height) continue;
+
+            float u = lx * uScale;
+            float v = ly * vScale;
+            if (flipX) u = source.width - u;
+            if (flipY) v = source.height - v;
+            int texX = std::clamp((int)(source.x + u), 0, texture.width - 1);
+            int texY = std::clamp((int)(source.y + v), 0, texture.height - 1);
+            PutPixel(dst[col], Modulate(texture.pixels[(size_t)texX * texture.xStride + (size_t)texY * texture.yStride], tint));
+            ++sampled;
+        }
+    }
+    return sampled;
+}
+
+int SwDrawSpriteColumns(SoftwareTarget& target, const SoftwareTexture& texture, Rectangle dest,
+    int colBegin, int colEnd, Color tint) {
+    if (texture.pixels == nullptr || dest.width <= 0.0f || dest.height <= 0.0f) return 0;
+
+    // Pixels are covered when their centre lies inside dest
+    const int x0 = std::max({ colBegin, (int)ceilf(dest.x - 0.5f), 0 });
+    const int x1 = std::min({ colEnd, (int)ceilf(dest.x + dest.width - 0.5f), target.width });
+    const int y0 = std::max((int)ceilf(dest.y - 0.5f), 0);
+    const int y1 = std::min((int)ceilf(dest.y + dest.height - 0.5f), target.height);
+    if (x0 >= x1 || y0 >= y1) return 0;
+
+    const float uScale = (float)texture.width / dest.width;
+    const float vScale = (float)texture.height / dest.height;
+    for (int col = x0; col < x1; ++col) {
+        const int texX = std::clamp((int)(((float)col + 0.5f - dest.x) * uScale), 0, texture.width - 1);
+        const Color* column = texture.pixels + (size_t)texX * texture.xStride;
+        Color* dst = target.pixels + (size_t)y0 * target.width + col;
+        float v = ((float)y0 + 0.5f - dest.y) * vScale;
+        for (int row = y0; row < y1; ++row, v += vScale, dst += target.width) {
+            const Color texel = column[(size_t)std::min((int)v, texture.height - 1) * texture.yStride];
+            if (texel.a != 0) PutPixel(*dst, Modulate(texel, tint));
+        }
+    }
+    return (x1 - x0) * (y1 - y0);
+}
+
+// --- Readback ---
+
+void SwReadPlanar(const SoftwareTarget& target, uint8_t* dst) {
+    const size_t rows = (size_t)target.height;
+    const size_t plane = rows * target.width;
+    // Transpose in blocks of 16 columns: each source row segment is one cache line and
+    // each destination column stays sequential across the inner row loop. Four rows are
+    // gathered at a time, so every channel of a column is written 4 bytes at once.
+    const int block = 16;
+    const size_t rows4 = rows & ~(size_t)3;
+    for (int bx = 0; bx < target.width; bx += block) {
+        const int bxEnd = std::min(bx + block, target.width);
+        for (size_t y = 0; y < rows4; y += 4) {
+            const Color* src0 = target.pixels + y * target.width;
+            const Color* src1 = src0 + target.width;
+            const Color* src2 = src1 + target.width;
+            const Color* src3 = src2 + target.width;
+            for (int x = bx; x < bxEnd; ++x) {
+                const size_t i = (size_t)x * rows + y;
+                const uint8_t r[4] = { src0[x].r, src1[x].r, src2[x].r, src3[x].r };
+                const uint8_t g[4] = { src0[x].g, src1[x].g, src2[x].g, src3[x].g };
+                const uint8_t b[4] = { src0[x].b, src1[x].b, src2[x].b, src3[x].b };
+                const uint8_t a[4] = { src0[x].a, src1[x].a, src2[x].a, src3[x].a };
+                memcpy(dst + i, r, 4);
+                memcpy(dst + plane + i, g, 4);
+                memcpy(dst + 2 * plane + i, b, 4);
+                memcpy(dst + 3 * plane + i, a, 4);
+            }
+        }
+        for (size_t y = rows4; y < rows; ++y) {
+            const Color* src = target.pixels + y * target.width;
+            for (int x = bx; x < bxEnd; ++x) {
+                const size_t i = (size_t)x * rows + y;
+                dst[i] = src[x].r;
+                dst[plane + i] = src[x].g;
+                dst[2 * plane + i] = src[x].b;
+                dst[3 * plane + i] = src[x].a;
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+// SoftwareRenderer.h
+// Internal CPU rasterizer used by the software backends. All functions draw into an explicit
+// target, so they hold no state of their own and can run on any thread.
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include "raylib.h"
+#include <stdint.h>
+
+// Non-owning view of a tightly packed RGBA8 image, row-major, top row first.
+struct SoftwareTarget {
+    Color* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+};
+
+// Non-owning view of an RGBA8 texture in CPU memory. Texel (x, y) is pixels[x * xStride + y * yStride]:
+// row-major images use (1, width), column-major copies use (height, 1) so one texture column is contiguous.
+// There is no default layout: build it with all five fields.
+struct SoftwareTexture {
+    const Color* pixels;
+    int width;
+    int height;
+    int xStride;
+    int yStride;
+};
+
+void SwClear(SoftwareTarget& target, Color color);
+void SwFillRect(SoftwareTarget& target, int x, int y, int width, int height, Color color);
+// Fills rows [y0, y1] (inclusive, either order) of column x.
+void SwDrawColumn(SoftwareTarget& target, int x, int y0, int y1, Color color);
+void SwDrawLine(SoftwareTarget& target, int x0, int y0, int x1, int y1, Color color);
+// Writes every pixel of columns [colBegin, colEnd) x rows [rowBegin, rowEnd) once: column x is
+// wallColors[x] on rows top[x]..bottom[x] (an empty span when top > bottom) and elsewhere 'plane'
+// if FlatPlane, or keeps the pixel already there (a textured floor or ceiling) if not.
+// The per-column arrays are indexed from colBegin. Colors are written as is, with no blending.
+template <bool FlatPlane>
+void SwDrawWallRows(SoftwareTarget& target, int colBegin, int colEnd, int rowBegin, int rowEnd,
+    const int* top, const int* bottom, const Color* wallColors, Color plane);
+// The textured draws return the number of texels they sampled.
+
+// Same mapping as DrawTexturePro with a one texel wide source column at texCoordX (0..1).
+int SwDrawTexturedColumn(SoftwareTarget& target, int screenX, int drawStartY, int drawEndY, float drawWidth,
+    const SoftwareTexture& texture, float texCoordX, Color tint);
+// Same semantics as raylib's DrawTexturePro (origin, rotation in degrees, negative source size flips).
+int SwDrawTexturePro(SoftwareTarget& target, const SoftwareTexture& texture, Rectangle source, Rectangle dest,
+    Vector2 origin, float rotation, Color tint);
+
+// Draws 'texture' stretched over dest, but only the screen columns [colBegin, colEnd). Used for
+// billboard sprites split into the column runs left visible by the walls in front of them.
+int SwDrawSpriteColumns(SoftwareTarget& target, const SoftwareTexture& texture, Rectangle dest,
+    int colBegin, int colEnd, Color tint);
+
+// Nearest-neighbour stretch of 'source' over rows [rowBegin, rowEnd) of 'target'. Target column x
+// shows source column sourceColumns[x]; target row y shows source row (2y + 1) * source.height / (2 * target.height).
+void SwStretchRows(SoftwareTarget& target, const SoftwareTarget& source, const int* sourceColumns, int rowBegin, int rowEnd);
+
+// Writes the target as an H x W x 4 column-major array (MATLAB's image layout).
+void SwReadPlanar(const SoftwareTarget& target, uint8_t* dst);
+
+#endif
@@ -0,0 +1,288 @@
+// Sprites.cpp
+// DrawRaycastSprites: billboards depth-tested against the walls of the last raycast frame.
+#include "RendererContext.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <math.h>
+
+// --- Depth-Buffered Sprites ---
+
+// Stable LSD radix sort on 32-bit keys, one byte per pass. Passes where every key shares the
+// byte are skipped, which for float depths usually leaves two or three.
+static void RadixSortByKey(std::vector<SpriteSortEntry>& entries, std::vector<SpriteSortEntry>& scratch) {
+    const size_t count = entries.size();
+    if (scratch.size() < count) {
+        scratch.resize(count);
+    }
+    uint32_t histogram[4][256] = {};
+    for (const SpriteSortEntry& entry : entries) {
+        for (int pass = 0; pass < 4; ++pass) {
+            ++histogram[pass][(entry.key >> (pass * 8)) & 0xFF];
+        }
+    }
+
+    SpriteSortEntry* src = entries.data();
+    SpriteSortEntry* dst = scratch.data();
+    for (int pass = 0; pass < 4; ++pass) {
+        uint32_t* counts = histogram[pass];
+        if (counts[(src[0].key >> (pass * 8)) & 0xFF] == count) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            const uint32_t digitCount = counts[digit];
+            counts[digit] = offset;
+            offset += digitCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            dst[counts[(src[i].key >> (pass * 8)) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != entries.data()) {
+        std::copy(src, src + count, entries.data());
+    }
+}
+
+// Transforms a sprite into camera space and computes its screen footprint.
+// Returns false if it is behind the camera, off screen or has no texture.
+static bool ProjectSprite(RendererContext& ctx, const CameraRaySetup& view, const RaycastSprite& sprite, ProjectedSprite& out) {
+    const TextureSlot* slot = FindTexture(ctx, sprite.textureId);
+    if (slot == nullptr || !(sprite.scale > 0.0f) || !isfinite(sprite.x) || !isfinite(sprite.y) || !isfinite(sprite.verticalOffset)) {
+        return false;
+    }
+
+    // Solve rel = depth * dir + cameraX * depth * plane: depth matches the walls' perpDist and
+    // cameraX the column mapping of the ray setup
+    const float relX = sprite.x - view.posX;
+    const float relY = sprite.y - view.posY;
+    const float invDet = 1.0f / (view.planeX * view.dirY - view.dirX * view.planeY);
+    const float lateral = invDet * (view.dirY * relX - view.dirX * relY);
+    const float depth = invDet * (view.planeX * relY - view.planeY * relX);
+    if (!(depth >= kRaycastMinDistance)) {
+        return false;
+    }
+
+    // Column coordinates put pixel centres on integers, like the rays
+    const float centerColumn = (lateral / depth - view.columnOffset) / view.columnScale;
+    const float planeLength = sqrtf(view.planeX * view.planeX + view.planeY * view.planeY);
+    const float worldWidth = sprite.scale * (float)slot->width / (float)slot->height;
+    const float screenWidth = worldWidth / (depth * planeLength * view.columnScale);
+    const float screenHeight = sprite.scale * (float)view.screenHeight / depth;
+    const float left = centerColumn - 0.5f * screenWidth;
+    const float right = left + screenWidth;
+    if (!(right > 0.0f) || !(left < (float)view.screenWidth) || !isfinite(screenHeight)) {
+        return false;
+    }
+    const float centerY = 0.5f * (float)view.screenHeight - sprite.verticalOffset * (float)view.screenHeight / depth;
+
+    out.slot = slot;
+    out.dest = Rectangle{ left + 0.5f, centerY - 0.5f * screenHeight, screenWidth, screenHeight };
+    out.depth = depth;
+    out.colBegin = std::max((int)ceilf(left), 0);
+    out.colEnd = std::min((int)ceilf(right), view.screenWidth);
+    out.level = SelectMipLevel(slot->height, (int)std::min(screenHeight, 1.0e6f), slot->mipCount);
+    out.tint = sprite.tint;
+    out.visible = 0;
+    return out.colBegin < out.colEnd;
+}
+
+// Calls drawRun(runBegin, runEnd) for each run of columns in [colBegin, colEnd) where the
+// sprite is nearer than the wall
+template <typename DrawRun>
+static bool ForEachVisibleRun(const ProjectedSprite& sprite, const RaycastHit* hits, int colBegin, int colEnd, DrawRun drawRun) {
+    bool any = false;
+    int x = colBegin;
+    while (x < colEnd) {
+        while (x < colEnd && hits[x].perpDist <= sprite.depth) ++x;
+        const int runBegin = x;
+        while (x < colEnd && hits[x].perpDist > sprite.depth) ++x;
+        if (runBegin < x) {
+            drawRun(runBegin, x);
+            any = true;
+        }
+    }
+    return any;
+}
+
+// Emits quads in order, starting a new batch only when the atlas page changes
+static void DrawQuadsInOrder(RendererContext& ctx, const std::vector<QueuedSlice>& quads) {
+    int page = -1;
+    for (const QueuedSlice& quad : quads) {
+        if (quad.page != page) {
+            if (page >= 0) {
+                rlEnd();
+            }
+            page = quad.page;
+            CountGpuDraw(ctx, ctx.atlasPages[page].texture.id);
+            rlSetTexture(ctx.atlasPages[page].texture.id);
+            rlBegin(RL_QUADS);
+        }
+        EmitQuad(ctx, quad);
+    }
+    if (page >= 0) {
+        rlEnd();
+        rlSetTexture(0);
+    }
+}
+
+int DrawRaycastSprites(const RaycastSprite* sprites, int spriteCount) {
+    RendererContext& ctx = CurrentContext();
+    if (sprites == nullptr || spriteCount <= 0) {
+        return 0;
+    }
+    if (IsRecording(ctx)) {
+        if (!ctx.recordedViewReady) {
+            TraceLog(LOG_WARNING, "RENDER DLL: DrawRaycastSprites needs a RenderRaycastFrame earlier in the same frame");
+            return 0;
+        }
+        if (!ctx.recordedViewOpen && (ctx.recordedViewWidth != ctx.screenWidth || ctx.recordedViewHeight != ctx.screenHeight)) {
+            TraceLog(LOG_WARNING, "RENDER DLL: DrawRaycastSprites must directly follow RenderRaycastFrame while the render scale is below 1");
+            return 0;
+        }
+        RecRaycastSprites* command = RecordCommand<RecRaycastSprites>(ctx, REC_RAYCAST_SPRITES);
+        *command = RecRaycastSprites{ (const RaycastSprite*)RecordBytes(ctx, sprites, sizeof(RaycastSprite) * spriteCount), spriteCount };
+        // The depth test against the walls happens during replay: report the sprites that survive culling
+        int inView = 0;
+        ProjectedSprite projected;
+        std::lock_guard<std::mutex> lock(ctx.textureMutex); // Textures may finish loading meanwhile
+        for (int i = 0; i < spriteCount; ++i) {
+            inView += ProjectSprite(ctx, ctx.recordedView, sprites[i], projected) ? 1 : 0;
+        }
+        return inView;
+    }
+    if (!ctx.raycastViewReady) {
+        TraceLog(LOG_WARNING, "RENDER DLL: DrawRaycastSprites needs a RenderRaycastFrame earlier in the same frame");
+        return 0;
+    }
+    if (IsViewScaled(ctx) && !ctx.viewActive) {
+        TraceLog(LOG_WARNING, "RENDER DLL: DrawRaycastSprites must directly follow RenderRaycastFrame while the render scale is below 1");
+        return 0;
+    }
+    const auto start = FrameProfiler::Clock::now();
+    const CameraRaySetup& view = ctx.raycastView;
+    const RaycastHit* hits = ctx.raycastHits.data();
+
+    // Cull and project. Depths are positive floats, whose bit patterns sort like the values;
+    // inverting them sorts far to near so nearer sprites are painted over farther ones.
+    if (ctx.projectedSprites.size() < (size_t)spriteCount) {
+        ctx.projectedSprites.resize(spriteCount);
+    }
+    ctx.spriteOrder.clear();
+    for (int i = 0; i < spriteCount; ++i) {
+        ProjectedSprite& projected = ctx.projectedSprites[ctx.spriteOrder.size()];
+        if (ProjectSprite(ctx, view, sprites[i], projected)) {
+            if (ctx.raycastViewLit) projected.tint = ApplyLight(projected.tint, ctx.lightmap.PlaneLight(sprites[i].x, sprites[i].y));
+            uint32_t depthBits;
+            memcpy(&depthBits, &projected.depth, sizeof(depthBits));
+            ctx.spriteOrder.push_back(SpriteSortEntry{ ~depthBits, (uint32_t)ctx.spriteOrder.size() });
+        }
+    }
+    if (ctx.spriteOrder.empty()) {
+        ctx.profiler.EndStage(PROFILE_STAGE_SPRITES, start);
+        return 0;
+    }
+    RadixSortByKey(ctx.spriteOrder, ctx.spriteSortScratch);
+
+    int drawn = 0;
+    if (IsSoftwareBackend(ctx)) {
+        // Bucket the sorted sprites by column tile, keeping their order inside each bucket, then let
+        // the workers rasterize whole tiles: tiles own disjoint columns, so no two touch a pixel
+        const int tileCount = (view.screenWidth + kRaycastTileColumns - 1) / kRaycastTileColumns;
+        ctx.spriteTileStart.assign(tileCount + 1, 0);
+        for (const SpriteSortEntry& entry : ctx.spriteOrder) {
+            const ProjectedSprite& sprite = ctx.projectedSprites[entry.index];
+            for (int t = sprite.colBegin / kRaycastTileColumns; t <= (sprite.colEnd - 1) / kRaycastTileColumns; ++t) {
+                ++ctx.spriteTileStart[t + 1];
+            }
+        }
+        for (int t = 0; t < tileCount; ++t) {
+            ctx.spriteTileStart[t + 1] += ctx.spriteTileStart[t];
+        }
+        if (ctx.spriteTileList.size() < (size_t)ctx.spriteTileStart[tileCount]) {
+            ctx.spriteTileList.resize(ctx.spriteTileStart[tileCount]);
+        }
+        for (const SpriteSortEntry& entry : ctx.spriteOrder) {
+            const ProjectedSprite& sprite = ctx.projectedSprites[entry.index];
+            for (int t = sprite.colBegin / kRaycastTileColumns; t <= (sprite.colEnd - 1) / kRaycastTileColumns; ++t) {
+                ctx.spriteTileList[ctx.spriteTileStart[t]++] = (int)entry.index;
+            }
+        }
+        // The fill pass advanced every start to the next tile's start; shift them back
+        for (int t = tileCount; t > 0; --t) {
+            ctx.spriteTileStart[t] = ctx.spriteTileStart[t - 1];
+        }
+        ctx.spriteTileStart[0] = 0;
+
+        std::atomic<long long> sampled{ 0 };
+        auto drawTiles = [&](int tileBegin, int tileEnd, int) {
+            long long tileSampled = 0;
+            for (int t = tileBegin; t < tileEnd; ++t) {
+                const int colBegin = t * kRaycastTileColumns;
+                const int colEnd = std::min(colBegin + kRaycastTileColumns, view.screenWidth);
+                for (int i = ctx.spriteTileStart[t]; i < ctx.spriteTileStart[t + 1]; ++i) {
+                    ProjectedSprite& sprite = ctx.projectedSprites[ctx.spriteTileList[i]];
+                    const SoftwareTexture texture = SoftwareTextureFromSlot(*sprite.slot, sprite.level);
+                    const bool any = ForEachVisibleRun(sprite, hits, std::max(colBegin, sprite.colBegin), std::min(colEnd, sprite.colEnd),
+                        [&](int runBegin, int runEnd) {
+                            tileSampled += SwDrawSpriteColumns(ctx.softwareTarget, texture, sprite.dest, runBegin, runEnd, sprite.tint);
+                        });
+                    if (any) std::atomic_ref<int>(sprite.visible).store(1, std::memory_order_relaxed);
+                }
+            }
+            sampled.fetch_add(tileSampled, std::memory_order_relaxed);
+        };
+        ctx.workerPool.ParallelFor(tileCount, 1, drawTiles);
+        ctx.frameStats.textureLookups += sampled.load();
+        for (const SpriteSortEntry& entry : ctx.spriteOrder) {
+            drawn += ctx.projectedSprites[entry.index].visible;
+        }
+    }
+    else {
+        FlushSliceBatch(ctx);
+        ctx.spriteQuads.clear();
+        const float texel = 1.0f / (float)kAtlasPageSize;
+        for (const SpriteSortEntry& entry : ctx.spriteOrder) {
+            const ProjectedSprite& sprite = ctx.projectedSprites[entry.index];
+            const TextureSlot& slot = *sprite.slot;
+            const bool any = ForEachVisibleRun(sprite, hits, sprite.colBegin, sprite.colEnd, [&](int runBegin, int runEnd) {
+                // Run edges in screen space, with the billboard's own edges at the ends
+                const float x0 = std::max((float)runBegin, sprite.dest.x);
+                const float x1 = std::min((float)runEnd, sprite.dest.x + sprite.dest.width);
+                const float u0 = (x0 - sprite.dest.x) / sprite.dest.width;
+                const float u1 = (x1 - sprite.dest.x) / sprite.dest.width;
+                if (slot.atlasPage < 0) {
+                    // Not in an atlas: draw the run on its own, after the quads queued before it
+                    DrawQuadsInOrder(ctx, ctx.spriteQuads);
+                    ctx.spriteQuads.clear();
+                    Rectangle source = { u0 * (float)slot.width, 0.0f, (u1 - u0) * (float)slot.width, (float)slot.height };
+                    Rectangle dest = { x0, sprite.dest.y, x1 - x0, sprite.dest.height };
+                    DrawTexturePro(slot.gpu, source, dest, Vector2{ 0.0f, 0.0f }, 0.0f, sprite.tint);
+                    CountGpuDraw(ctx, slot.gpu.id);
+                    return;
+                }
+                int offsetX, offsetY;
+                MipLevelOffset(slot.width, slot.height, sprite.level, offsetX, offsetY);
+                const float levelWidth = (float)MipLevelWidth(slot.width, sprite.level);
+                QueuedSlice quad;
+                quad.x = x0;
+                quad.y = sprite.dest.y;
+                quad.width = x1 - x0;
+                quad.height = sprite.dest.height;
+                quad.u0 = ((float)(slot.atlasX + offsetX) + u0 * levelWidth) * texel;
+                quad.u1 = ((float)(slot.atlasX + offsetX) + u1 * levelWidth) * texel;
+                quad.v0 = (float)(slot.atlasY + offsetY) * texel;
+                quad.v1 = (float)(slot.atlasY + offsetY + MipLevelHeight(slot.height, sprite.level)) * texel;
+                quad.tint = sprite.tint;
+                quad.page = slot.atlasPage;
+                ctx.spriteQuads.push_back(quad);
+            });
+            if (any) ++drawn;
+        }
+        DrawQuadsInOrder(ctx, ctx.spriteQuads);
+        ctx.spriteQuads.clear();
+    }
+    ctx.frameStats.spritesDrawn += drawn;
+    ctx.profiler.EndStage(PROFILE_STAGE_SPRITES, start);
+    return drawn;
+}
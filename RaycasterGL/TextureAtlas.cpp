@@ -0,0 +1,177 @@
+// TextureAtlas.cpp
+#include "TextureAtlas.h"
+#include <algorithm>
+
+int MipLevelCount(int width, int height) {
+    int levels = 1;
+    while (levels < kMaxMipLevels && ((width >> levels) > 0 || (height >> levels) > 0)) {
+        ++levels;
+    }
+    return levels;
+}
+
+int MipChainBlockWidth(int width, int levelCount) {
+    return (levelCount > 1) ? width + MipLevelWidth(width, 1) : width;
+}
+
+void MipLevelOffset(int width, int height, int level, int& x, int& y) {
+    x = 0;
+    y = 0;
+    if (level == 0) {
+        return;
+    }
+    x = width;
+    for (int l = 1; l < level; ++l) {
+        y += MipLevelHeight(height, l);
+    }
+}
+
+void BuildMipChain(const Color* pixels, int width, int height, int levelCount, std::vector<Color>& levels, size_t* offsets) {
+    size_t total = 0;
+    for (int l = 0; l < levelCount; ++l) {
+        offsets[l] = total;
+        total += (size_t)MipLevelWidth(width, l) * MipLevelHeight(height, l);
+    }
+    levels.resize(total);
+    std::copy(pixels, pixels + (size_t)width * height, levels.begin());
+
+    for (int l = 1; l < levelCount; ++l) {
+        const Color* src = levels.data() + offsets[l - 1];
+        Color* dst = levels.data() + offsets[l];
+        const int srcW = MipLevelWidth(width, l - 1), srcH = MipLevelHeight(height, l - 1);
+        const int dstW = MipLevelWidth(width, l), dstH = MipLevelHeight(height, l);
+        for (int y = 0; y < dstH; ++y) {
+            // Odd sizes drop the last row/column; a 1-texel axis is not halved
+            const int y0 = (srcH > 1) ? 2 * y : y;
+            const int y1 = (srcH > 1) ? y0 + 1 : y0;
+            for (int x = 0; x < dstW; ++x) {
+                const int x0 = (srcW > 1) ? 2 * x : x;
+                const int x1 = (srcW > 1) ? x0 + 1 : x0;
+                const Color a = src[(size_t)y0 * srcW + x0], b = src[(size_t)y0 * srcW + x1];
+                const Color c = src[(size_t)y1 * srcW + x0], d = src[(size_t)y1 * srcW + x1];
+                dst[(size_t)y * dstW + x] = Color{
+                    (unsigned char)((a.r + b.r + c.r + d.r + 2) / 4),
+                    (unsigned char)((a.g + b.g + c.g + d.g + 2) / 4),
+                    (unsigned char)((a.b + b.b + c.b + d.b + 2) / 4),
+                    (unsigned char)((a.a + b.a + c.a + d.a + 2) / 4)
+                };
+            }
+        }
+    }
+}
+
+int SelectMipLevel(int textureHeight, int spanHeight, int levelCount) {
+    if (spanHeight <= 0) {
+        return levelCount - 1;
+    }
+    int level = 0;
+    while (level + 1 < levelCount && (textureHeight >> (level + 1)) >= spanHeight) {
+        ++level;
+    }
+    return level;
+}
+
+bool AtlasPacker::Allocate(int width, int height, int& x, int& y) {
+    if (width <= 0 || height <= 0 || width > m_size || height > m_size) {
+        return false;
+    }
+    // Best-fitting shelf that is tall enough, then the tightest gap on it; the tail is the
+    // fallback when no gap fits
+    size_t best = m_shelves.size();
+    int bestGap = -1;
+    for (size_t s = 0; s < m_shelves.size(); ++s) {
+        const Shelf& shelf = m_shelves[s];
+        if (shelf.height < height || (best < m_shelves.size() && shelf.height >= m_shelves[best].height)) {
+            continue;
+        }
+        int gap = -1;
+        for (size_t g = 0; g < shelf.gaps.size(); ++g) {
+            if (shelf.gaps[g].width >= width && (gap < 0 || shelf.gaps[g].width < shelf.gaps[gap].width)) {
+                gap = (int)g;
+            }
+        }
+        if (gap >= 0 || m_size - shelf.used >= width) {
+            best = s;
+            bestGap = gap;
+        }
+    }
+    if (best == m_shelves.size()) {
+        if (m_size - m_nextShelfY < height) {
+            return false;
+        }
+        m_shelves.push_back(Shelf{ m_nextShelfY, height, 0, {} });
+        m_nextShelfY += height;
+    }
+    else if (m_shelves[best].used == 0 && m_shelves[best].height > height) {
+        // An empty shelf is cut down to this height; the rows below stay free for other heights
+        const Shelf rest{ m_shelves[best].y + height, m_shelves[best].height - height, 0, {} };
+        m_shelves[best].height = height;
+        m_shelves.insert(m_shelves.begin() + best + 1, rest);
+    }
+    Shelf& shelf = m_shelves[best];
+    y = shelf.y;
+    if (bestGap >= 0) {
+        Span& gap = shelf.gaps[bestGap];
+        x = gap.x;
+        gap.x += width;
+        gap.width -= width;
+        if (gap.width == 0) {
+            shelf.gaps.erase(shelf.gaps.begin() + bestGap);
+        }
+    }
+    else {
+        x = shelf.used;
+        shelf.used += width;
+    }
+    return true;
+}
+
+void AtlasPacker::Free(int x, int y, int width, int height) {
+    auto it = std::find_if(m_shelves.begin(), m_shelves.end(), [y](const Shelf& shelf) { return shelf.y == y; });
+    if (it == m_shelves.end() || width <= 0 || height > it->height || x < 0 || x + width > it->used) {
+        return;
+    }
+    // Insert the span in x order and merge it with touching gaps
+    std::vector<Span>& gaps = it->gaps;
+    auto pos = std::lower_bound(gaps.begin(), gaps.end(), x, [](const Span& gap, int value) { return gap.x < value; });
+    pos = gaps.insert(pos, Span{ x, width });
+    if (pos + 1 != gaps.end() && pos->x + pos->width == (pos + 1)->x) {
+        pos->width += (pos + 1)->width;
+        gaps.erase(pos + 1);
+    }
+    if (pos != gaps.begin() && (pos - 1)->x + (pos - 1)->width == pos->x) {
+        (pos - 1)->width += pos->width;
+        gaps.erase(pos);
+    }
+    // A gap that reaches the tail gives its width back to the tail
+    if (!gaps.empty() && gaps.back().x + gaps.back().width == it->used) {
+        it->used = gaps.back().x;
+        gaps.pop_back();
+    }
+    if (it->used > 0) {
+        return;
+    }
+    // The shelf is empty: merge it with empty neighbours so the rows can be split again
+    size_t s = (size_t)(it - m_shelves.begin());
+    if (s + 1 < m_shelves.size() && m_shelves[s + 1].used == 0) {
+        m_shelves[s].height += m_shelves[s + 1].height;
+        m_shelves.erase(m_shelves.begin() + s + 1);
+    }
+    if (s > 0 && m_shelves[s - 1].used == 0) {
+        m_shelves[s - 1].height += m_shelves[s].height;
+        m_shelves.erase(m_shelves.begin() + s);
+    }
+    ReleaseEmptyTopShelves();
+}
+
+void AtlasPacker::ReleaseEmptyTopShelves() {
+    while (!m_shelves.empty() && m_shelves.back().used == 0) {
+        m_nextShelfY = m_shelves.back().y;
+        m_shelves.pop_back();
+    }
+}
+
+void AtlasPacker::Reset() {
+    m_nextShelfY = 0;
+    m_shelves.clear();
+}
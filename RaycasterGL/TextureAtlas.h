@@ -0,0 +1,64 @@
+// TextureAtlas.h
+// Internal helpers for wall texture mip chains and atlas packing.
+//
+// A texture's mip chain occupies one (width + width / 2) x height block of an atlas page:
+// level 0 on the left, levels 1..n stacked top to bottom in the right-hand column.
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "raylib.h"
+#include <stddef.h>
+#include <vector>
+
+constexpr int kAtlasPageSize = 2048;
+constexpr int kMaxAtlasPages = 4;
+constexpr int kMaxMipLevels = 12;
+
+// Number of levels down to a 1 x 1 (or 1 x n) level, capped at kMaxMipLevels.
+int MipLevelCount(int width, int height);
+inline int MipLevelWidth(int width, int level) { return (width >> level) > 0 ? (width >> level) : 1; }
+inline int MipLevelHeight(int height, int level) { return (height >> level) > 0 ? (height >> level) : 1; }
+
+// Size of the block holding a whole mip chain.
+int MipChainBlockWidth(int width, int levelCount);
+// Position of 'level' inside the chain's block.
+void MipLevelOffset(int width, int height, int level, int& x, int& y);
+
+// Box-filters a row-major RGBA8 image into all its mip levels. levels receives the level
+// images back to back (row-major each), offsets[l] the start of level l.
+void BuildMipChain(const Color* pixels, int width, int height, int levelCount, std::vector<Color>& levels, size_t* offsets);
+
+// Coarsest level that still has at least one texel per screen pixel along the span,
+// i.e. floor(log2(textureHeight / spanHeight)) clamped to the available levels.
+int SelectMipLevel(int textureHeight, int spanHeight, int levelCount);
+
+// Shelf packer for one atlas page. Freed blocks leave gaps that later blocks of their shelf's
+// height or less fill; a shelf left empty merges with empty neighbours, so its rows can be split
+// again for blocks of another height, and empty shelves at the top give their rows back.
+class AtlasPacker {
+public:
+    explicit AtlasPacker(int size = kAtlasPageSize) : m_size(size) {}
+    bool Allocate(int width, int height, int& x, int& y);
+    // Gives back a block from Allocate
+    void Free(int x, int y, int width, int height);
+    void Reset();
+
+private:
+    struct Span {
+        int x;
+        int width;
+    };
+    struct Shelf {
+        int y;
+        int height;
+        int used;               // Blocks and gaps cover [0, used)
+        std::vector<Span> gaps; // Freed spans inside [0, used), sorted by x, never touching
+    };
+    void ReleaseEmptyTopShelves();
+
+    int m_size;
+    int m_nextShelfY = 0;
+    std::vector<Shelf> m_shelves; // Sorted by y, covering [0, m_nextShelfY) without holes
+};
+
+#endif
@@ -0,0 +1,89 @@
+// TextureLoader.cpp
+#include "TextureLoader.h"
+
+TextureLoader::~TextureLoader() {
+    Stop();
+}
+
+void TextureLoader::Start(int threadCount, DecodeFn decode) {
+    Stop();
+    if (threadCount <= 0) {
+        threadCount = (int)std::thread::hardware_concurrency();
+    }
+    if (threadCount <= 0) {
+        threadCount = 1;
+    }
+    m_decode = decode;
+    m_stopping = false;
+    m_threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&TextureLoader::ThreadMain, this);
+    }
+}
+
+void TextureLoader::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+    m_finished.clear();
+    m_decoding = 0;
+}
+
+void TextureLoader::Enqueue(unsigned int textureId, const char* path) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(Job{ textureId, path });
+    }
+    m_wake.notify_one();
+}
+
+void TextureLoader::TakeFinished(std::vector<DecodedTexture>& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (DecodedTexture& texture : m_finished) {
+        out.push_back(std::move(texture));
+    }
+    m_finished.clear();
+}
+
+void TextureLoader::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_queue.empty() && m_decoding == 0; });
+}
+
+int TextureLoader::GetPendingCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (int)m_queue.size() + m_decoding + (int)m_finished.size();
+}
+
+void TextureLoader::ThreadMain() {
+    for (;;) {
+        DecodedTexture texture;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            texture.textureId = m_queue.front().textureId;
+            texture.path = std::move(m_queue.front().path);
+            m_queue.pop_front();
+            ++m_decoding;
+        }
+
+        m_decode(texture);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_decoding;
+            if (!m_stopping) m_finished.push_back(std::move(texture));
+        }
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,72 @@
+// TextureLoader.h
+// Internal background decoder behind LoadTexturesAsync. Worker threads read, decode and mip-map
+// image files; the engine collects the results at BeginFrame and uploads them on the thread that
+// owns the GPU context.
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include "TextureAtlas.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct DecodedTexture {
+    unsigned int textureId = 0; // TextureID reserved for the file
+    std::string path;
+    bool ok = false;
+    int width = 0;
+    int height = 0;
+    int mipCount = 1;
+    size_t mipOffsets[kMaxMipLevels] = {};
+    std::vector<Color> levels;  // Row-major mip chain as laid out by BuildMipChain, for GPU upload
+    std::vector<Color> columns; // The same levels transposed to column-major
+};
+
+class TextureLoader {
+public:
+    // Fills everything after 'path' from the file; runs on a loader thread.
+    typedef void (*DecodeFn)(DecodedTexture& texture);
+
+    TextureLoader() = default;
+    ~TextureLoader();
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // Starts threadCount threads (0 = one per hardware thread), stopping any previous ones first.
+    void Start(int threadCount, DecodeFn decode);
+    // Drops queued files, waits for the ones being decoded and forgets every result.
+    void Stop();
+    bool IsRunning() const { return !m_threads.empty(); }
+
+    void Enqueue(unsigned int textureId, const char* path);
+    // Moves the textures decoded so far to the end of 'out'.
+    void TakeFinished(std::vector<DecodedTexture>& out);
+    // Blocks until every queued file has been decoded (the results still wait for TakeFinished).
+    void WaitIdle();
+    // Files queued, being decoded, or decoded but not yet taken.
+    int GetPendingCount();
+
+private:
+    struct Job {
+        unsigned int textureId;
+        std::string path;
+    };
+
+    void ThreadMain();
+
+    std::vector<std::thread> m_threads;
+    DecodeFn m_decode = nullptr;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake; // Loader threads: a job was queued or stopping
+    std::condition_variable m_idle; // WaitIdle: a job finished
+    std::deque<Job> m_queue;
+    std::vector<DecodedTexture> m_finished;
+    int m_decoding = 0;
+    bool m_stopping = false;
+};
+
+#endif
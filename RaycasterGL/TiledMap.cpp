@@ -0,0 +1,413 @@
+// TiledMap.cpp
+#define _CRT_SECURE_NO_WARNINGS // fopen: SDL checks reject it otherwise, and fopen_s is MSVC only
+#include "TiledMap.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+
+static const char kMapFileMagic[4] = { 'R', 'C', 'M', 'P' };
+// Tile data starts on a page boundary, so each page fault brings in whole tiles
+static const uint64_t kMapDataAlignment = 4096;
+
+// FNV-1a over 64-bit words; tile sizes are always a multiple of 8 bytes
+static uint64_t HashTile(const uint8_t* data, size_t size) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 1099511628211ull;
+    }
+    return h;
+}
+
+static bool IsAllZero(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] != 0) return false;
+    }
+    return true;
+}
+
+bool TiledMap::BuildImage(const void* cells, int width, int height, int cellBytes, int tileShift, std::vector<uint8_t>& image) {
+    if (cells == nullptr || width <= 0 || height <= 0 || width > kMapMaxSize || height > kMapMaxSize ||
+        (cellBytes != 1 && cellBytes != 2) || tileShift < kMapMinTileShift || tileShift > kMapMaxTileShift) {
+        return false;
+    }
+    const int tileSize = 1 << tileShift;
+    const int tilesX = (width + tileSize - 1) >> tileShift;
+    const int tilesY = (height + tileSize - 1) >> tileShift;
+    const size_t tileBytes = (size_t)tileSize * tileSize * cellBytes;
+    const size_t rowBytes = (size_t)tileSize * cellBytes;
+    const uint8_t* src = (const uint8_t*)cells;
+
+    // Distinct tiles in first-seen order, block 0 being the empty tile
+    std::vector<uint8_t> blocks(tileBytes, 0);
+    std::unordered_multimap<uint64_t, uint32_t> blocksByHash;
+    blocksByHash.emplace(HashTile(blocks.data(), tileBytes), 0);
+    std::vector<uint32_t> directory((size_t)tilesX * tilesY);
+    std::vector<uint8_t> tile(tileBytes);
+
+    const int groupSize = 1 << kMapGroupShift;
+    const int groupsX = (width + groupSize - 1) >> kMapGroupShift;
+    const int groupsY = (height + groupSize - 1) >> kMapGroupShift;
+    std::vector<uint8_t> occupancy(((size_t)groupsX * groupsY + 7) / 8, 0);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = src + (size_t)y * width * cellBytes;
+        for (int x = 0; x < width; ++x) {
+            const bool wall = (cellBytes == 1) ? row[x] != 0 : (row[2 * x] | row[2 * x + 1]) != 0;
+            if (wall) {
+                const size_t group = (size_t)(y >> kMapGroupShift) * groupsX + (x >> kMapGroupShift);
+                occupancy[group >> 3] |= (uint8_t)(1u << (group & 7));
+            }
+        }
+    }
+
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            const int x0 = tx << tileShift;
+            const int y0 = ty << tileShift;
+            const int copyWidth = std::min(tileSize, width - x0);
+            const int copyHeight = std::min(tileSize, height - y0);
+            std::fill(tile.begin(), tile.end(), (uint8_t)0);
+            for (int y = 0; y < copyHeight; ++y) {
+                memcpy(tile.data() + y * rowBytes, src + ((size_t)(y0 + y) * width + x0) * cellBytes, (size_t)copyWidth * cellBytes);
+            }
+
+            const uint64_t hash = HashTile(tile.data(), tileBytes);
+            uint32_t block = UINT32_MAX;
+            const auto candidates = blocksByHash.equal_range(hash);
+            for (auto it = candidates.first; it != candidates.second; ++it) {
+                if (memcmp(blocks.data() + it->second * tileBytes, tile.data(), tileBytes) == 0) {
+                    block = it->second;
+                    break;
+                }
+            }
+            if (block == UINT32_MAX) {
+                block = (uint32_t)(blocks.size() / tileBytes);
+                blocks.insert(blocks.end(), tile.begin(), tile.end());
+                blocksByHash.emplace(hash, block);
+            }
+            directory[(size_t)ty * tilesX + tx] = block;
+        }
+    }
+
+    MapFileHeader header = {};
+    memcpy(header.magic, kMapFileMagic, sizeof(header.magic));
+    header.version = kMapFileVersion;
+    header.width = (uint32_t)width;
+    header.height = (uint32_t)height;
+    header.cellBytes = (uint32_t)cellBytes;
+    header.tileShift = (uint32_t)tileShift;
+    header.storedTiles = (uint32_t)(blocks.size() / tileBytes);
+    header.groupShift = kMapGroupShift;
+    header.directoryOffset = sizeof(MapFileHeader);
+    header.occupancyOffset = header.directoryOffset + directory.size() * sizeof(uint32_t);
+    const uint64_t occupancyEnd = header.occupancyOffset + occupancy.size();
+    header.dataOffset = (occupancyEnd + kMapDataAlignment - 1) / kMapDataAlignment * kMapDataAlignment;
+
+    image.assign((size_t)header.dataOffset + blocks.size(), 0);
+    memcpy(image.data(), &header, sizeof(header));
+    memcpy(image.data() + header.directoryOffset, directory.data(), directory.size() * sizeof(uint32_t));
+    memcpy(image.data() + header.occupancyOffset, occupancy.data(), occupancy.size());
+    memcpy(image.data() + header.dataOffset, blocks.data(), blocks.size());
+    return true;
+}
+
+bool TiledMap::Save(const char* filePath, const void* cells, int width, int height, int cellBytes, int tileShift) {
+    std::vector<uint8_t> image;
+    if (filePath == nullptr || !BuildImage(cells, width, height, cellBytes, tileShift, image)) {
+        return false;
+    }
+    FILE* file = fopen(filePath, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool written = fwrite(image.data(), 1, image.size(), file) == image.size();
+    return fclose(file) == 0 && written;
+}
+
+bool TiledMap::Load(const char* filePath) {
+    Clear();
+    if (filePath == nullptr || !m_file.Open(filePath)) {
+        return false;
+    }
+    if (!Attach(m_file.GetData(), m_file.GetSize())) {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+bool TiledMap::Assign(std::vector<uint8_t>&& image) {
+    Clear();
+    m_memory = std::move(image);
+    if (!Attach(m_memory.data(), m_memory.size())) {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+void TiledMap::Clear() {
+    m_file.Close();
+    m_memory.clear();
+    m_memory.shrink_to_fit();
+    m_image = nullptr;
+    m_imageSize = 0;
+    m_emptyTile = nullptr;
+    m_width = 0;
+    m_height = 0;
+    m_tilesX = 0;
+    m_tilesY = 0;
+    m_storedTiles = 0;
+    m_tiles.clear();
+    m_ownedTiles.clear();
+    for (int l = 0; l < kMapSkipLevels; ++l) {
+        m_empty[l].clear();
+        m_levelBlocksX[l] = 0;
+        m_levelBlocksY[l] = 0;
+    }
+    m_skip.clear();
+    ++m_version;
+}
+
+bool TiledMap::Attach(const uint8_t* image, size_t size) {
+    MapFileHeader header;
+    if (image == nullptr || size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, image, sizeof(header));
+    if (memcmp(header.magic, kMapFileMagic, sizeof(header.magic)) != 0 || header.version != kMapFileVersion ||
+        (header.cellBytes != 1 && header.cellBytes != 2) ||
+        header.tileShift < (uint32_t)kMapMinTileShift || header.tileShift > (uint32_t)kMapMaxTileShift ||
+        header.width == 0 || header.height == 0 || header.width > (uint32_t)kMapMaxSize || header.height > (uint32_t)kMapMaxSize ||
+        header.storedTiles == 0 || header.groupShift != (uint32_t)kMapGroupShift || header.directoryOffset % sizeof(uint32_t) != 0 ||
+        header.dataOffset % kMapDataAlignment != 0) {
+        return false; // An aligned data section also keeps uint16 cells aligned
+    }
+    const int tileShift = (int)header.tileShift;
+    const uint64_t tileSize = 1ull << tileShift;
+    const uint64_t tileBytes = tileSize * tileSize * header.cellBytes;
+    const uint64_t tilesX = (header.width + tileSize - 1) >> tileShift;
+    const uint64_t tilesY = (header.height + tileSize - 1) >> tileShift;
+    const uint64_t groupsX = (header.width + (1u << kMapGroupShift) - 1) >> kMapGroupShift;
+    const uint64_t groupsY = (header.height + (1u << kMapGroupShift) - 1) >> kMapGroupShift;
+    if (header.directoryOffset > size || (size - header.directoryOffset) / sizeof(uint32_t) < tilesX * tilesY ||
+        header.occupancyOffset > size || size - header.occupancyOffset < (groupsX * groupsY + 7) / 8 ||
+        header.dataOffset > size || (size - header.dataOffset) / tileBytes < header.storedTiles) {
+        return false;
+    }
+    const uint8_t* blocks = image + header.dataOffset;
+    if (!IsAllZero(blocks, (size_t)tileBytes)) {
+        return false; // Block 0 must be the empty tile: the directory marks empty space with it
+    }
+
+    const uint32_t* directory = (const uint32_t*)(image + header.directoryOffset);
+    m_tiles.resize((size_t)(tilesX * tilesY));
+    for (size_t i = 0; i < m_tiles.size(); ++i) {
+        if (directory[i] >= header.storedTiles) {
+            return false;
+        }
+        m_tiles[i] = blocks + directory[i] * tileBytes;
+    }
+
+    // The skip tables cross groups the occupancy bits call empty without looking at them, so the bits
+    // must match the tiles. Each stored block is scanned once, however many tiles share it.
+    const int tileGroupShift = tileShift - kMapGroupShift;
+    const int tileGroups = 1 << tileGroupShift; // Per side
+    std::vector<uint8_t> blockWalls((size_t)header.storedTiles << (2 * tileGroupShift), 0); // Per group of each block
+    for (uint32_t block = 1; block < header.storedTiles; ++block) {
+        const uint8_t* cells = blocks + block * tileBytes;
+        uint8_t* walls = blockWalls.data() + ((size_t)block << (2 * tileGroupShift));
+        for (uint64_t y = 0; y < tileSize; ++y) {
+            for (uint64_t x = 0; x < tileSize; ++x) {
+                const uint64_t cell = y * tileSize + x;
+                const bool wall = (header.cellBytes == 1) ? cells[cell] != 0 : (cells[2 * cell] | cells[2 * cell + 1]) != 0;
+                if (wall) walls[(y >> kMapGroupShift) * tileGroups + (x >> kMapGroupShift)] = 1;
+            }
+        }
+    }
+    const uint8_t* occupancy = image + header.occupancyOffset;
+    m_empty[0].resize((size_t)(groupsX * groupsY));
+    for (uint64_t gy = 0; gy < groupsY; ++gy) {
+        for (uint64_t gx = 0; gx < groupsX; ++gx) {
+            const uint32_t block = directory[(gy >> tileGroupShift) * tilesX + (gx >> tileGroupShift)];
+            const uint8_t wall = blockWalls[((size_t)block << (2 * tileGroupShift)) + (gy & (tileGroups - 1)) * tileGroups + (gx & (tileGroups - 1))];
+            const size_t group = (size_t)(gy * groupsX + gx);
+            if (wall != ((occupancy[group >> 3] >> (group & 7)) & 1)) {
+                return false;
+            }
+            m_empty[0][group] = !wall;
+        }
+    }
+
+    m_image = image;
+    m_imageSize = size;
+    m_emptyTile = blocks;
+    m_width = (int)header.width;
+    m_height = (int)header.height;
+    m_cellBytes = (int)header.cellBytes;
+    m_tileShift = tileShift;
+    m_tilesX = (int)tilesX;
+    m_tilesY = (int)tilesY;
+    m_storedTiles = (int)header.storedTiles;
+
+    // Level 0 is the checked occupancy bits; each level above ANDs 8 x 8 blocks of the one below
+    m_levelBlocksX[0] = (int)groupsX;
+    m_levelBlocksY[0] = (int)groupsY;
+    for (int l = 1; l < kMapSkipLevels; ++l) {
+        const int childBlocksX = m_levelBlocksX[l - 1];
+        const int childBlocksY = m_levelBlocksY[l - 1];
+        m_levelBlocksX[l] = (childBlocksX + 7) >> kMapSkipLevelShift;
+        m_levelBlocksY[l] = (childBlocksY + 7) >> kMapSkipLevelShift;
+        m_empty[l].assign((size_t)m_levelBlocksX[l] * m_levelBlocksY[l], 1);
+        for (int y = 0; y < childBlocksY; ++y) {
+            for (int x = 0; x < childBlocksX; ++x) {
+                if (!m_empty[l - 1][(size_t)y * childBlocksX + x]) {
+                    m_empty[l][(size_t)(y >> kMapSkipLevelShift) * m_levelBlocksX[l] + (x >> kMapSkipLevelShift)] = 0;
+                }
+            }
+        }
+    }
+    m_skip.resize(m_empty[0].size());
+    for (int gy = 0; gy < (int)groupsY; ++gy) {
+        for (int gx = 0; gx < (int)groupsX; ++gx) {
+            m_skip[(size_t)gy * groupsX + gx] = (uint8_t)SkipShift(gx, gy);
+        }
+    }
+    ++m_version;
+    return true;
+}
+
+int TiledMap::SkipShift(int groupX, int groupY) const {
+    for (int l = kMapSkipLevels - 1; l >= 0; --l) {
+        const int shift = l * kMapSkipLevelShift;
+        if (m_empty[l][(size_t)(groupY >> shift) * m_levelBlocksX[l] + (groupX >> shift)]) {
+            return kMapGroupShift + shift;
+        }
+    }
+    return 0;
+}
+
+void TiledMap::UpdateEmptySpace(int groupX, int groupY) {
+    const int x0 = groupX << kMapGroupShift;
+    const int y0 = groupY << kMapGroupShift;
+    const int x1 = std::min(x0 + (1 << kMapGroupShift), m_width);
+    const int y1 = std::min(y0 + (1 << kMapGroupShift), m_height);
+    uint8_t empty = 1;
+    for (int y = y0; y < y1 && empty; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            if (GetCell(x, y) != 0) {
+                empty = 0;
+                break;
+            }
+        }
+    }
+
+    // Walk up while the flags change; every group under the highest changed block needs a new skip distance
+    int changedLevel = -1;
+    for (int l = 0; l < kMapSkipLevels; ++l) {
+        const int shift = l * kMapSkipLevelShift;
+        const int blockX = groupX >> shift;
+        const int blockY = groupY >> shift;
+        if (l > 0) {
+            const int childX0 = blockX << kMapSkipLevelShift;
+            const int childY0 = blockY << kMapSkipLevelShift;
+            const int childX1 = std::min(childX0 + 8, m_levelBlocksX[l - 1]);
+            const int childY1 = std::min(childY0 + 8, m_levelBlocksY[l - 1]);
+            empty = 1;
+            for (int y = childY0; y < childY1 && empty; ++y) {
+                for (int x = childX0; x < childX1; ++x) {
+                    if (!m_empty[l - 1][(size_t)y * m_levelBlocksX[l - 1] + x]) {
+                        empty = 0;
+                        break;
+                    }
+                }
+            }
+        }
+        uint8_t& flag = m_empty[l][(size_t)blockY * m_levelBlocksX[l] + blockX];
+        if (flag == empty) {
+            break;
+        }
+        flag = empty;
+        changedLevel = l;
+    }
+    if (changedLevel < 0) {
+        return;
+    }
+
+    const int shift = changedLevel * kMapSkipLevelShift;
+    const int gx0 = (groupX >> shift) << shift;
+    const int gy0 = (groupY >> shift) << shift;
+    const int gx1 = std::min(gx0 + (1 << shift), m_levelBlocksX[0]);
+    const int gy1 = std::min(gy0 + (1 << shift), m_levelBlocksY[0]);
+    for (int gy = gy0; gy < gy1; ++gy) {
+        for (int gx = gx0; gx < gx1; ++gx) {
+            m_skip[(size_t)gy * m_levelBlocksX[0] + gx] = (uint8_t)SkipShift(gx, gy);
+        }
+    }
+}
+
+int TiledMap::GetEmptyTileCount() const {
+    return (int)std::count(m_tiles.begin(), m_tiles.end(), m_emptyTile);
+}
+
+int TiledMap::GetCell(int x, int y) const {
+    if (!IsLoaded() || x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return -1;
+    }
+    const uint8_t* tile = m_tiles[(size_t)(y >> m_tileShift) * m_tilesX + (x >> m_tileShift)];
+    const int mask = (1 << m_tileShift) - 1;
+    const size_t index = ((size_t)(y & mask) << m_tileShift) | (size_t)(x & mask);
+    return (m_cellBytes == 1) ? tile[index] : ((const uint16_t*)tile)[index];
+}
+
+bool TiledMap::SetCell(int x, int y, int value) {
+    if (!IsLoaded() || x < 0 || y < 0 || x >= m_width || y >= m_height || value < 0 || value >= (1 << (8 * m_cellBytes))) {
+        return false;
+    }
+    if (GetCell(x, y) == value) {
+        return true;
+    }
+    const int tileX = x >> m_tileShift;
+    const int tileY = y >> m_tileShift;
+    const size_t tile = (size_t)tileY * m_tilesX + tileX;
+    const size_t tileBytes = ((size_t)1 << (2 * m_tileShift)) * m_cellBytes;
+
+    // Stored tiles may be shared with other tiles or live in a read-only mapping: copy on first write
+    const uint8_t* data = m_tiles[tile];
+    if (data >= m_image && data < m_image + m_imageSize) {
+        std::unique_ptr<uint8_t[]> copy(new uint8_t[tileBytes]);
+        memcpy(copy.get(), data, tileBytes);
+        m_tiles[tile] = copy.get();
+        m_ownedTiles.push_back(std::move(copy));
+    }
+    uint8_t* cells = (uint8_t*)m_tiles[tile];
+    const int mask = (1 << m_tileShift) - 1;
+    const size_t index = ((size_t)(y & mask) << m_tileShift) | (size_t)(x & mask);
+    if (m_cellBytes == 1) cells[index] = (uint8_t)value;
+    else ((uint16_t*)cells)[index] = (uint16_t)value;
+
+    // Writing a wall into empty space, or clearing what may be a group's last wall
+    const int groupX = x >> kMapGroupShift;
+    const int groupY = y >> kMapGroupShift;
+    if (m_empty[0][(size_t)groupY * m_levelBlocksX[0] + groupX] != 0 || value == 0) {
+        UpdateEmptySpace(groupX, groupY);
+    }
+    ++m_version;
+    return true;
+}
+
+TiledMapView TiledMap::GetView() const {
+    TiledMapView view;
+    view.tiles = m_tiles.data();
+    view.skip = m_skip.data();
+    view.width = m_width;
+    view.height = m_height;
+    view.tilesX = m_tilesX;
+    view.tileShift = m_tileShift;
+    view.groupsX = m_levelBlocksX[0];
+    view.groupShift = kMapGroupShift;
+    view.cellBytes = m_cellBytes;
+    return view;
+}
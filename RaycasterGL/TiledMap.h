@@ -0,0 +1,117 @@
+// TiledMap.h
+// Internal storage of the engine's loaded map (LoadRaycastMap / SetRaycastMap).
+//
+// Cells are kept in square tiles of (1 << tileShift) cells per side, read straight from a memory
+// mapped .rcmap file or from an in-memory image of one. Identical tiles share their storage, so
+// open space and repeated patterns cost one tile each. Edited tiles are copied on first write.
+// Next to the tiles the file carries one occupancy bit per 8 x 8 group of cells, from which the
+// loader builds the empty-space hierarchy once it has checked them against the stored tiles.
+//
+// .rcmap layout (little-endian):
+//   MapFileHeader
+//   uint32 directory[tilesY * tilesX]    Stored block of each tile, row-major. Block 0 is all empty.
+//   Occupancy bits from occupancyOffset  Bit gy * groupsX + gx, LSB first: group (gx, gy) has a wall
+//   Tile blocks from dataOffset          storedTiles blocks of tileSize * tileSize cells, row-major
+//                                        within the tile; cells past the map edge are 0. dataOffset
+//                                        is a multiple of 4096.
+#ifndef TILED_MAP_H
+#define TILED_MAP_H
+
+#include "MappedFile.h"
+#include "RaycastKernel.h"
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+struct MapFileHeader {
+    char magic[4];            // "RCMP"
+    uint32_t version;         // kMapFileVersion
+    uint32_t width;
+    uint32_t height;
+    uint32_t cellBytes;       // 1 = uint8 cells, 2 = uint16 cells
+    uint32_t tileShift;       // Tiles are (1 << tileShift) cells square
+    uint32_t storedTiles;     // Blocks in the data section
+    uint32_t groupShift;      // Occupancy groups are (1 << groupShift) cells square
+    uint64_t directoryOffset;
+    uint64_t occupancyOffset;
+    uint64_t dataOffset;
+};
+
+constexpr uint32_t kMapFileVersion = 1;
+constexpr int kMapDefaultTileShift = 5;  // 32 x 32 cells: 1 KiB (uint8) or 2 KiB (uint16) per tile
+constexpr int kMapMinTileShift = 3;
+constexpr int kMapMaxTileShift = 8;
+constexpr int kMapGroupShift = 3;
+constexpr int kMapMaxSize = 1 << 16;     // Cells per side
+// Empty squares of 8, 64, 512 and 4096 cells are each crossed in one step
+constexpr int kMapSkipLevels = 4;
+constexpr int kMapSkipLevelShift = 3;
+
+class TiledMap {
+public:
+    TiledMap() = default;
+    TiledMap(const TiledMap&) = delete;
+    TiledMap& operator=(const TiledMap&) = delete;
+
+    // Encodes a dense row-major map (cells[y * width + x], cellBytes wide) as a .rcmap image.
+    static bool BuildImage(const void* cells, int width, int height, int cellBytes, int tileShift, std::vector<uint8_t>& image);
+    // BuildImage written to filePath.
+    static bool Save(const char* filePath, const void* cells, int width, int height, int cellBytes, int tileShift);
+
+    // Memory-maps a .rcmap file. Every distinct tile is read once to check the occupancy bits;
+    // repeated and empty tiles cost nothing.
+    bool Load(const char* filePath);
+    // Takes ownership of an image made by BuildImage.
+    bool Assign(std::vector<uint8_t>&& image);
+    void Clear();
+
+    bool IsLoaded() const { return m_image != nullptr; }
+    bool IsMapped() const { return m_file.GetData() != nullptr; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    int GetCellBytes() const { return m_cellBytes; }
+    int GetTileSize() const { return 1 << m_tileShift; }
+    int GetTileCount() const { return (int)m_tiles.size(); }
+    int GetStoredTileCount() const { return m_storedTiles + (int)m_ownedTiles.size(); }
+    int GetEmptyTileCount() const;
+    // Bumped by every Load, Assign, Clear and effective SetCell, never reset.
+    uint64_t GetVersion() const { return m_version; }
+
+    // -1 outside the map
+    int GetCell(int x, int y) const;
+    bool SetCell(int x, int y, int value);
+
+    TiledMapView GetView() const;
+
+private:
+    bool Attach(const uint8_t* image, size_t size);
+    // log2 of the side of the largest empty square holding group (groupX, groupY), 0 if the group may hold walls
+    int SkipShift(int groupX, int groupY) const;
+    // Refreshes the empty flags above group (groupX, groupY) and the skip distances they affect
+    void UpdateEmptySpace(int groupX, int groupY);
+
+    MappedFile m_file;
+    std::vector<uint8_t> m_memory;
+    const uint8_t* m_image = nullptr;
+    size_t m_imageSize = 0;
+    const uint8_t* m_emptyTile = nullptr; // Block 0 of the image
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_cellBytes = 1;
+    int m_tileShift = kMapDefaultTileShift;
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+    int m_storedTiles = 0;
+    uint64_t m_version = 0;
+
+    std::vector<const uint8_t*> m_tiles;                 // Cells of each tile, in the image or in m_ownedTiles
+    std::vector<std::unique_ptr<uint8_t[]>> m_ownedTiles; // Copies made by SetCell
+    // m_empty[l][by * m_levelBlocksX[l] + bx]: the block of 8^l x 8^l groups holds no wall
+    std::vector<uint8_t> m_empty[kMapSkipLevels];
+    int m_levelBlocksX[kMapSkipLevels] = {};
+    int m_levelBlocksY[kMapSkipLevels] = {};
+    std::vector<uint8_t> m_skip;                          // TiledMapView::skip, one per group
+};
+
+#endif
@@ -0,0 +1,102 @@
+// WorkerPool.cpp
+#include "WorkerPool.h"
+
+WorkerPool::~WorkerPool() {
+    Stop();
+}
+
+void WorkerPool::Start(int workerCount) {
+    Stop();
+    if (workerCount <= 0) {
+        workerCount = (int)std::thread::hardware_concurrency();
+    }
+    m_workerCount = (workerCount > 0) ? workerCount : 1;
+    m_ranges.reset(new TileRange[m_workerCount]);
+    m_stopping = false;
+    if (m_workerCount == 1) {
+        return; // Jobs run inline
+    }
+    m_threads.reserve(m_workerCount);
+    for (int i = 0; i < m_workerCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::WorkerMain, this, i, m_generation);
+    }
+}
+
+void WorkerPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+    m_workerCount = 1;
+}
+
+void WorkerPool::Run(int itemCount, int grain, Task task, void* context) {
+    if (itemCount <= 0) {
+        return;
+    }
+    if (grain < 1) grain = 1;
+    if (m_threads.empty()) {
+        task(context, 0, itemCount, 0);
+        return;
+    }
+
+    const int tileCount = (itemCount + grain - 1) / grain;
+    for (int i = 0; i < m_workerCount; ++i) {
+        m_ranges[i].next.store((int)((long long)tileCount * i / m_workerCount), std::memory_order_relaxed);
+        m_ranges[i].end = (int)((long long)tileCount * (i + 1) / m_workerCount);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task = task;
+    m_context = context;
+    m_itemCount = itemCount;
+    m_grain = grain;
+    m_pending = m_workerCount;
+    ++m_generation;
+    m_wake.notify_all();
+    m_finished.wait(lock, [this] { return m_pending == 0; });
+}
+
+// 'seen' starts at the generation current when the thread was created, so a job published
+// before the thread first takes the lock is still picked up.
+void WorkerPool::WorkerMain(int worker, unsigned int seen) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        Execute(worker);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0) {
+            m_finished.notify_one();
+        }
+    }
+}
+
+void WorkerPool::Execute(int worker) {
+    // Own share first, then walk the other shares and steal whatever tiles are left.
+    // A worker only reports back once no tile is unclaimed anywhere.
+    for (int k = 0; k < m_workerCount; ++k) {
+        TileRange& range = m_ranges[(worker + k) % m_workerCount];
+        for (;;) {
+            const int tile = range.next.fetch_add(1, std::memory_order_relaxed);
+            if (tile >= range.end) {
+                break;
+            }
+            const int begin = tile * m_grain;
+            const int end = (begin + m_grain < m_itemCount) ? begin + m_grain : m_itemCount;
+            m_task(m_context, begin, end, worker);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+// WorkerPool.h
+// Internal persistent thread pool used to split a frame's columns across cores.
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+public:
+    // Processes items [begin, end) on worker 'worker' (0 .. GetWorkerCount() - 1).
+    typedef void (*Task)(void* context, int begin, int end, int worker);
+
+    WorkerPool() = default;
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Starts workerCount threads, stopping any previous ones first. 0 uses one per hardware thread.
+    // With a single worker no thread is created and jobs run on the calling thread.
+    void Start(int workerCount);
+    void Stop();
+    int GetWorkerCount() const { return m_workerCount; }
+
+    // Splits [0, itemCount) into tiles of 'grain' items and blocks until every tile has run.
+    // Each worker starts on its own contiguous share of tiles and steals from the others'
+    // shares once it runs out. Only one thread may submit jobs at a time.
+    void Run(int itemCount, int grain, Task task, void* context);
+
+    template <typename Fn>
+    void ParallelFor(int itemCount, int grain, Fn& fn) {
+        Run(itemCount, grain, [](void* context, int begin, int end, int worker) { (*(Fn*)context)(begin, end, worker); }, &fn);
+    }
+
+private:
+    // Tiles [next, end) not yet claimed from one worker's share; own cache line to avoid false sharing
+    struct alignas(64) TileRange {
+        std::atomic<int> next{ 0 };
+        int end = 0;
+    };
+
+    void WorkerMain(int worker, unsigned int seen);
+    void Execute(int worker);
+
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<TileRange[]> m_ranges;
+    int m_workerCount = 1;
+
+    // Current job, published under m_mutex by bumping m_generation
+    Task m_task = nullptr;
+    void* m_context = nullptr;
+    int m_itemCount = 0;
+    int m_grain = 1;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+    unsigned int m_generation = 0;
+    int m_pending = 0;
+    bool m_stopping = false;
+};
+
+#endif
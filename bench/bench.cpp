@@ -0,0 +1,736 @@
+// bench.cpp
+// Headless raycasting benchmark. Replays scripted camera paths over generated maps with the
+// software backend, so it needs no window or GPU, and reports per-frame costs as a table plus
+// optional JSON/CSV for comparing builds.
+//
+//   bench [--quick] [--frames N] [--warmup N] [--maps 16,256] [--res 320x200,1280x720]
+//         [--threads 1,8] [--simd auto|scalar|sse2|avx2] [--json out.json] [--csv out.csv]
+//         [--baseline old.csv] [--tolerance 10] [--tiled] [--reuse] [--batch] [--rays] [--atlas]
+//
+// With --tiled, every map is also saved as a tiled map file, loaded with LoadRaycastMap and
+// rendered from there; those cases carry a "/tiled" suffix.
+//
+// Frame reuse (SetRaycastFrameReuse) is off so that every frame runs the full DDA. With --reuse
+// it is on, the sweep path rebuilds most columns from the previous frame, and every case carries
+// a "/reuse" suffix.
+//
+// With --batch, every case is also rendered as one RenderRaycastBatch call of all its frames'
+// cameras (RGBA, depth and cell outputs); those cases carry a "/batch" suffix, their per-frame
+// figures are per view, and the views per second are printed below them.
+//
+// With --rays, every case is also run as CastRaycastRays sweeps: each frame casts width x height
+// rays from the frame's camera position, spread over a full turn. Those cases carry a "/rays"
+// suffix, their per-column figures are per ray, and the rays per second are printed below them.
+//
+// With --atlas, the wall atlas packer is run through a texture streaming pattern after the cases:
+// a working set of textures of mixed sizes where one texture is unloaded and another loaded per
+// cycle. Every load that finds no atlas block would draw unbatched, so any failed allocation is
+// reported and the exit code is 1.
+//
+// With --baseline, every case is compared against a CSV written by an earlier run: cases more
+// than --tolerance percent slower, or whose frame checksum changed, are listed and the exit code is 1.
+#define _CRT_SECURE_NO_WARNINGS // fopen/sscanf under MSVC SDL checks
+#include "../RaycasterGL/RaycasterEngine.h"
+#include "../RaycasterGL/TextureAtlas.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <math.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- Allocation Counting ---
+// The engine is linked statically, so replacing the global allocator sees its allocations too.
+
+static std::atomic<long long> g_allocations{ 0 };
+
+static void* CountedAlloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+static void* CountedAlignedAlloc(size_t size, std::align_val_t align) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const size_t alignment = (size_t)align;
+#if defined(_MSC_VER)
+    return _aligned_malloc(size ? size : 1, alignment);
+#else
+    // aligned_alloc wants a size that is a multiple of the alignment
+    return aligned_alloc(alignment, ((size ? size : 1) + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void AlignedFree(void* p) {
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// GCC pairs the replaced operators with each other, not with the malloc/free inside them
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new(size_t size, std::align_val_t align) {
+    if (void* p = CountedAlignedAlloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t align) {
+    if (void* p = CountedAlignedAlloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, align); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// --- Scenes ---
+
+// Deterministic integer hash, so every build and platform generates the same maps
+static uint32_t Hash(uint32_t x, uint32_t y, uint32_t seed) {
+    uint32_t h = x * 0x8da6b343u ^ y * 0xd8163841u ^ seed * 0xcb1ab31fu;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
+}
+
+enum CameraPath {
+    PATH_ORBIT, // Walks a circle around the map centre, looking along it
+    PATH_SWEEP, // Stands at the centre and turns a full circle
+    PATH_COUNT
+};
+static const char* const kPathNames[PATH_COUNT] = { "orbit", "sweep" };
+
+static float OrbitRadius(int size) {
+    return 0.3f * (float)size;
+}
+
+static RaycastCamera CameraAt(CameraPath path, int size, float t) {
+    const float twoPi = 6.28318530718f;
+    const float center = 0.5f * (float)size;
+    RaycastCamera camera;
+    camera.fov = 1.0471976f; // 60 degrees
+    if (path == PATH_ORBIT) {
+        const float a = t * twoPi;
+        camera.posX = center + OrbitRadius(size) * cosf(a);
+        camera.posY = center + OrbitRadius(size) * sinf(a);
+        camera.angle = a + 0.25f * twoPi; // Tangent to the circle
+    }
+    else {
+        camera.posX = center + 0.5f;
+        camera.posY = center + 0.5f;
+        camera.angle = t * twoPi;
+    }
+    return camera;
+}
+
+// City-block layout: 4x4 blocks of wall at ~18% density plus scattered pillars, closed by a
+// border. The orbit circle and the centre are carved out so both paths stay in open space.
+static std::vector<uint8_t> GenerateMap(int size) {
+    std::vector<uint8_t> map((size_t)size * size, 0);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const uint32_t block = Hash((uint32_t)x / 4, (uint32_t)y / 4, 1);
+            const uint32_t cell = Hash((uint32_t)x, (uint32_t)y, 2);
+            bool wall = (block % 100) < 18 || (cell % 100) < 2;
+            wall = wall || x == 0 || y == 0 || x == size - 1 || y == size - 1;
+            map[(size_t)y * size + x] = wall ? (uint8_t)(1 + cell % 4) : 0;
+        }
+    }
+
+    const float center = 0.5f * (float)size;
+    const float radius = OrbitRadius(size);
+    for (int y = 1; y < size - 1; ++y) {
+        for (int x = 1; x < size - 1; ++x) {
+            const float dx = (float)x + 0.5f - center;
+            const float dy = (float)y + 0.5f - center;
+            const float r = sqrtf(dx * dx + dy * dy);
+            if (fabsf(r - radius) < 1.5f || (fabsf(dx) < 2.0f && fabsf(dy) < 2.0f)) {
+                map[(size_t)y * size + x] = 0;
+            }
+        }
+    }
+    return map;
+}
+
+// --- Measurement ---
+
+struct BenchCase {
+    int mapSize;
+    CameraPath path;
+    int width;
+    int height;
+    int threads;
+    bool tiled; // Rendered from the loaded map rather than the dense array
+    bool reuse; // Frame reuse enabled
+    bool batch; // Rendered by RenderRaycastBatch, one view per frame of the path
+    bool rays;  // CastRaycastRays sweeps instead of frames
+};
+
+struct BenchResult {
+    BenchCase config;
+    int frames;
+    double nsPerFrameMedian;
+    double nsPerFrameMean;
+    double nsPerFrameMin;
+    double nsPerColumn;
+    double ddaStepsPerRay;
+    double allocationsPerFrame;
+    double reuseRate;  // Columns taken from the previous frame, per column
+    uint64_t checksum; // FNV-1a of the last frame, detects output changes between builds
+};
+
+static std::string CaseName(const BenchCase& c) {
+    char name[96];
+    snprintf(name, sizeof(name), "map%d/%s/%dx%d/t%d%s%s%s%s", c.mapSize, kPathNames[c.path], c.width, c.height, c.threads,
+        c.tiled ? "/tiled" : "", c.reuse ? "/reuse" : "", c.batch ? "/batch" : "", c.rays ? "/rays" : "");
+    return name;
+}
+
+static uint64_t HashFramebuffer() {
+    int width = 0, height = 0;
+    const uint8_t* pixels = GetFramebuffer(&width, &height);
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; pixels != nullptr && i < (size_t)width * height * 4; ++i) {
+        h = (h ^ pixels[i]) * 1099511628211ull;
+    }
+    return h;
+}
+
+static BenchResult RunCase(const BenchCase& c, const std::vector<uint8_t>& map, int warmup, int frames) {
+    SetRendererWorkerThreads(c.threads);
+    std::vector<double> frameNs;
+    frameNs.reserve(frames);
+
+    long long ddaSteps = 0;
+    long long raysReused = 0;
+    long long allocations = 0;
+    for (int f = -warmup; f < frames; ++f) {
+        // Warm-up frames trace the start of the path; measured frames cover all of it
+        const float t = (f < 0) ? 0.0f : (float)f / (float)frames;
+        const RaycastCamera camera = CameraAt(c.path, c.mapSize, t);
+        const long long allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        BeginFrame();
+        if (c.tiled) RenderRaycastFrame(camera, nullptr);
+        else RenderRaycastFrame(map.data(), c.mapSize, c.mapSize, camera, nullptr);
+        EndFrame();
+        const auto end = std::chrono::steady_clock::now();
+        if (f < 0) {
+            continue;
+        }
+        allocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+        frameNs.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        const RendererStats stats = GetRendererStats();
+        ddaSteps += stats.ddaSteps;
+        raysReused += stats.raysReused;
+    }
+
+    BenchResult result = {};
+    result.config = c;
+    result.frames = frames;
+    double sum = 0.0;
+    for (double ns : frameNs) sum += ns;
+    result.nsPerFrameMean = sum / frames;
+    std::sort(frameNs.begin(), frameNs.end());
+    result.nsPerFrameMedian = frameNs[frames / 2];
+    result.nsPerFrameMin = frameNs[0];
+    result.nsPerColumn = result.nsPerFrameMedian / c.width;
+    result.ddaStepsPerRay = (double)ddaSteps / ((double)frames * c.width);
+    result.allocationsPerFrame = (double)allocations / frames;
+    result.reuseRate = (double)raysReused / ((double)frames * c.width);
+    result.checksum = HashFramebuffer();
+    return result;
+}
+
+// Renders every frame's camera as one view of a batch. Each warm-up or measured repetition is a
+// whole batch; the per-frame figures are per view.
+static BenchResult RunBatchCase(const BenchCase& c, const std::vector<uint8_t>& map, int warmup, int frames) {
+    SetRendererWorkerThreads(c.threads);
+    std::vector<RaycastCamera> cameras(frames);
+    for (int f = 0; f < frames; ++f) {
+        cameras[f] = CameraAt(c.path, c.mapSize, (float)f / (float)frames);
+    }
+    const size_t pixels = (size_t)c.width * c.height * frames;
+    std::vector<uint8_t> rgba(pixels * 4);
+    std::vector<float> depth(pixels);
+    std::vector<int32_t> cells(pixels);
+    RaycastBatchOutput output = { c.width, c.height, RAYCAST_BATCH_ROW_MAJOR, rgba.data(), depth.data(), cells.data() };
+
+    const int repetitions = 3;
+    std::vector<double> viewNs;
+    long long ddaSteps = 0;
+    long long allocations = 0;
+    for (int r = -std::max(warmup, 1); r < repetitions; ++r) {
+        const long long allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        if (c.tiled) RenderRaycastBatch(cameras.data(), frames, nullptr, &output);
+        else RenderRaycastBatch(map.data(), c.mapSize, c.mapSize, cameras.data(), frames, nullptr, &output);
+        const auto end = std::chrono::steady_clock::now();
+        if (r < 0) {
+            continue;
+        }
+        allocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+        viewNs.push_back(std::chrono::duration<double, std::nano>(end - start).count() / frames);
+        ddaSteps += GetRaycastBatchStats().ddaSteps;
+    }
+
+    BenchResult result = {};
+    result.config = c;
+    result.frames = frames;
+    double sum = 0.0;
+    for (double ns : viewNs) sum += ns;
+    result.nsPerFrameMean = sum / repetitions;
+    std::sort(viewNs.begin(), viewNs.end());
+    result.nsPerFrameMedian = viewNs[repetitions / 2];
+    result.nsPerFrameMin = viewNs[0];
+    result.nsPerColumn = result.nsPerFrameMedian / c.width;
+    result.ddaStepsPerRay = (double)ddaSteps / ((double)repetitions * frames * c.width);
+    result.allocationsPerFrame = (double)allocations / ((double)repetitions * frames);
+    // The last view, hashed like a framebuffer
+    uint64_t h = 1469598103934665603ull;
+    const uint8_t* last = rgba.data() + (pixels - (size_t)c.width * c.height) * 4;
+    for (size_t i = 0; i < (size_t)c.width * c.height * 4; ++i) {
+        h = (h ^ last[i]) * 1099511628211ull;
+    }
+    result.checksum = h;
+    return result;
+}
+
+// Casts one sweep of width x height rays per frame from the camera position of that frame.
+static BenchResult RunRaysCase(const BenchCase& c, const std::vector<uint8_t>& map, int warmup, int frames) {
+    SetRendererWorkerThreads(c.threads);
+    const int rayCount = c.width * c.height;
+    std::vector<float> rays((size_t)rayCount * 3);
+    std::vector<float> distances(rayCount);
+    std::vector<int32_t> cells(rayCount);
+    RaycastRayOutput output = { distances.data(), cells.data(), nullptr, nullptr };
+    std::vector<double> sweepNs;
+    sweepNs.reserve(frames);
+
+    long long allocations = 0;
+    for (int f = -warmup; f < frames; ++f) {
+        const float t = (f < 0) ? 0.0f : (float)f / (float)frames;
+        const RaycastCamera camera = CameraAt(c.path, c.mapSize, t);
+        for (int i = 0; i < rayCount; ++i) {
+            rays[(size_t)i * 3] = camera.posX;
+            rays[(size_t)i * 3 + 1] = camera.posY;
+            rays[(size_t)i * 3 + 2] = camera.angle + 6.2831853f * (float)i / (float)rayCount;
+        }
+        const long long allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        if (c.tiled) CastRaycastRays(rays.data(), rayCount, 3, 3, 1, &output);
+        else CastRaycastRays(map.data(), c.mapSize, c.mapSize, rays.data(), rayCount, 3, 3, 1, &output);
+        const auto end = std::chrono::steady_clock::now();
+        if (f < 0) {
+            continue;
+        }
+        allocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+        sweepNs.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    BenchResult result = {};
+    result.config = c;
+    result.frames = frames;
+    double sum = 0.0;
+    for (double ns : sweepNs) sum += ns;
+    result.nsPerFrameMean = sum / frames;
+    std::sort(sweepNs.begin(), sweepNs.end());
+    result.nsPerFrameMedian = sweepNs[frames / 2];
+    result.nsPerFrameMin = sweepNs[0];
+    result.nsPerColumn = result.nsPerFrameMedian / rayCount;
+    result.allocationsPerFrame = (double)allocations / frames;
+    // The last sweep's hit cells
+    uint64_t h = 1469598103934665603ull;
+    for (int32_t cell : cells) {
+        h = (h ^ (uint32_t)cell) * 1099511628211ull;
+    }
+    result.checksum = h;
+    return result;
+}
+
+// --- Atlas Churn ---
+
+static const int kAtlasChurnLiveTextures = 48;
+static const int kAtlasChurnCycles = 20000;
+
+struct AtlasBlock {
+    int page;
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// Packs the mip chain block of a texture with sides of 64, 128 or 256 texels picked by 'key'
+static bool AllocateChurnBlock(std::vector<AtlasPacker>& pages, uint32_t key, AtlasBlock& block) {
+    const int width = 64 << (Hash(key, 0, 7) % 3);
+    block.height = 64 << (Hash(key, 1, 7) % 3);
+    block.width = MipChainBlockWidth(width, MipLevelCount(width, block.height));
+    for (block.page = 0; block.page < (int)pages.size(); ++block.page) {
+        if (pages[block.page].Allocate(block.width, block.height, block.x, block.y)) return true;
+    }
+    return false;
+}
+
+// Unloads one texture of the working set and loads another, per cycle, over a full set of atlas
+// pages. Returns the number of loads that found no block.
+static int RunAtlasChurn() {
+    std::vector<AtlasPacker> pages(kMaxAtlasPages);
+    std::vector<AtlasBlock> live;
+    int failed = 0;
+    uint32_t key = 0;
+    AtlasBlock block;
+    for (int i = 0; i < kAtlasChurnLiveTextures; ++i) {
+        if (AllocateChurnBlock(pages, key++, block)) live.push_back(block);
+        else ++failed;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (int cycle = 0; cycle < kAtlasChurnCycles && !live.empty(); ++cycle) {
+        const size_t victim = Hash(cycle, 2, 7) % live.size();
+        const AtlasBlock& freed = live[victim];
+        pages[freed.page].Free(freed.x, freed.y, freed.width, freed.height);
+        live.erase(live.begin() + victim);
+        if (AllocateChurnBlock(pages, key++, block)) live.push_back(block);
+        else ++failed;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    printf("\n%-34s %d textures live, %d load/unload cycles, %.0f ns/cycle, %d unbatched loads\n", "atlas/churn",
+        kAtlasChurnLiveTextures, kAtlasChurnCycles,
+        std::chrono::duration<double, std::nano>(end - start).count() / kAtlasChurnCycles, failed);
+    return failed;
+}
+
+// --- Output ---
+
+static const char* SimdName(RaycastSimdLevel level) {
+    switch (level) {
+    case RAYCAST_SIMD_SCALAR: return "scalar";
+    case RAYCAST_SIMD_SSE2: return "sse2";
+    case RAYCAST_SIMD_AVX2: return "avx2";
+    default: return "auto";
+    }
+}
+
+static const char* CompilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+#define BENCH_STR2(x) #x
+#define BENCH_STR(x) BENCH_STR2(x)
+    return "msvc " BENCH_STR(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+static bool WriteJson(const char* path, const std::vector<BenchResult>& results) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) return false;
+    fprintf(file, "{\n  \"benchmark\": \"RaycasterGL\",\n  \"formatVersion\": 1,\n");
+    fprintf(file, "  \"compiler\": \"%s\",\n  \"simd\": \"%s\",\n  \"hardwareThreads\": %u,\n  \"cases\": [\n",
+        CompilerName(), SimdName(GetRaycastSimdLevel()), std::thread::hardware_concurrency());
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"map\": %d, \"path\": \"%s\", \"width\": %d, \"height\": %d, \"threads\": %d, "
+            "\"frames\": %d, \"nsPerFrameMedian\": %.0f, \"nsPerFrameMean\": %.0f, \"nsPerFrameMin\": %.0f, "
+            "\"nsPerColumn\": %.2f, \"ddaStepsPerRay\": %.3f, \"allocationsPerFrame\": %.3f, \"reuseRate\": %.3f, \"checksum\": \"%016llx\"}%s\n",
+            CaseName(r.config).c_str(), r.config.mapSize, kPathNames[r.config.path], r.config.width, r.config.height,
+            r.config.threads, r.frames, r.nsPerFrameMedian, r.nsPerFrameMean, r.nsPerFrameMin, r.nsPerColumn,
+            r.ddaStepsPerRay, r.allocationsPerFrame, r.reuseRate, (unsigned long long)r.checksum, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+static const char* const kCsvHeader = "name,map,path,width,height,threads,frames,ns_per_frame_median,ns_per_frame_mean,"
+    "ns_per_frame_min,ns_per_column,dda_steps_per_ray,allocations_per_frame,checksum";
+
+static bool WriteCsv(const char* path, const std::vector<BenchResult>& results) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) return false;
+    fprintf(file, "%s\n", kCsvHeader);
+    for (const BenchResult& r : results) {
+        fprintf(file, "%s,%d,%s,%d,%d,%d,%d,%.0f,%.0f,%.0f,%.2f,%.3f,%.3f,%016llx\n",
+            CaseName(r.config).c_str(), r.config.mapSize, kPathNames[r.config.path], r.config.width, r.config.height,
+            r.config.threads, r.frames, r.nsPerFrameMedian, r.nsPerFrameMean, r.nsPerFrameMin, r.nsPerColumn,
+            r.ddaStepsPerRay, r.allocationsPerFrame, (unsigned long long)r.checksum);
+    }
+    return fclose(file) == 0;
+}
+
+struct BaselineEntry {
+    double nsPerFrameMedian;
+    unsigned long long checksum;
+};
+
+// Reads name, median and checksum back from a CSV written by WriteCsv
+static bool ReadBaseline(const char* path, std::map<std::string, BaselineEntry>& baseline) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) return false;
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        char name[128];
+        double median = 0.0;
+        unsigned long long checksum = 0;
+        // name,map,path,width,height,threads,frames,median,mean,min,perColumn,steps,allocations,checksum
+        if (sscanf(line, "%127[^,],%*d,%*[^,],%*d,%*d,%*d,%*d,%lf,%*f,%*f,%*f,%*f,%*f,%llx", name, &median, &checksum) == 3) {
+            baseline[name] = BaselineEntry{ median, checksum };
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+// --- Command Line ---
+
+static std::vector<int> ParseIntList(const char* text) {
+    std::vector<int> values;
+    for (const char* p = text; *p; ) {
+        values.push_back(atoi(p));
+        p = strchr(p, ',');
+        if (p == nullptr) break;
+        ++p;
+    }
+    return values;
+}
+
+static std::vector<std::pair<int, int>> ParseResolutions(const char* text) {
+    std::vector<std::pair<int, int>> values;
+    for (const char* p = text; *p; ) {
+        int w = 0, h = 0;
+        if (sscanf(p, "%dx%d", &w, &h) == 2 && w > 0 && h > 0) values.push_back({ w, h });
+        p = strchr(p, ',');
+        if (p == nullptr) break;
+        ++p;
+    }
+    return values;
+}
+
+static void PrintUsage() {
+    printf("Usage: bench [--quick] [--frames N] [--warmup N] [--maps 16,256,...] [--res WxH,...]\n"
+           "             [--threads 1,8,...] [--simd auto|scalar|sse2|avx2] [--json FILE] [--csv FILE]\n"
+           "             [--baseline FILE.csv] [--tolerance PERCENT] [--tiled] [--reuse] [--batch] [--rays]\n"
+           "             [--atlas]\n");
+}
+
+int main(int argc, char** argv) {
+    const int hardwareThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<int> mapSizes = { 16, 64, 256, 1024, 4096 };
+    std::vector<std::pair<int, int>> resolutions = { { 320, 200 }, { 1280, 720 }, { 3840, 2160 } };
+    std::vector<int> threadCounts = { 1, hardwareThreads };
+    int frames = 60;
+    int warmup = 5;
+    const char* jsonPath = nullptr;
+    const char* csvPath = nullptr;
+    const char* baselinePath = nullptr;
+    double tolerance = 10.0;
+    RaycastSimdLevel simd = RAYCAST_SIMD_AUTO;
+    bool tiled = false;
+    bool reuse = false;
+    bool batch = false;
+    bool rays = false;
+    bool atlas = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--quick") == 0) {
+            mapSizes = { 16, 256 };
+            resolutions = { { 320, 200 } };
+            frames = 20;
+            continue;
+        }
+        if (strcmp(arg, "--tiled") == 0) {
+            tiled = true;
+            continue;
+        }
+        if (strcmp(arg, "--reuse") == 0) {
+            reuse = true;
+            continue;
+        }
+        if (strcmp(arg, "--batch") == 0) {
+            batch = true;
+            continue;
+        }
+        if (strcmp(arg, "--rays") == 0) {
+            rays = true;
+            continue;
+        }
+        if (strcmp(arg, "--atlas") == 0) {
+            atlas = true;
+            continue;
+        }
+        if (value == nullptr) {
+            PrintUsage();
+            return 2;
+        }
+        ++i;
+        if (strcmp(arg, "--frames") == 0) frames = std::max(1, atoi(value));
+        else if (strcmp(arg, "--warmup") == 0) warmup = std::max(0, atoi(value));
+        else if (strcmp(arg, "--maps") == 0) mapSizes = ParseIntList(value);
+        else if (strcmp(arg, "--res") == 0) resolutions = ParseResolutions(value);
+        else if (strcmp(arg, "--threads") == 0) threadCounts = ParseIntList(value);
+        else if (strcmp(arg, "--json") == 0) jsonPath = value;
+        else if (strcmp(arg, "--csv") == 0) csvPath = value;
+        else if (strcmp(arg, "--baseline") == 0) baselinePath = value;
+        else if (strcmp(arg, "--tolerance") == 0) tolerance = atof(value);
+        else if (strcmp(arg, "--simd") == 0) {
+            if (strcmp(value, "scalar") == 0) simd = RAYCAST_SIMD_SCALAR;
+            else if (strcmp(value, "sse2") == 0) simd = RAYCAST_SIMD_SSE2;
+            else if (strcmp(value, "avx2") == 0) simd = RAYCAST_SIMD_AVX2;
+            else simd = RAYCAST_SIMD_AUTO;
+        }
+        else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+    mapSizes.erase(std::remove_if(mapSizes.begin(), mapSizes.end(), [](int s) { return s < 8; }), mapSizes.end());
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetRaycastSimdLevel(simd);
+    printf("RaycasterGL bench: %s, SIMD %s, %d hardware threads, %d frames per case\n\n",
+        CompilerName(), SimdName(GetRaycastSimdLevel()), hardwareThreads, frames);
+    printf("%-34s %12s %12s %10s %10s %10s %10s\n", "case", "ms/frame", "min ms", "ns/column", "steps/ray", "allocs/fr", "reused %");
+
+    std::vector<BenchResult> results;
+    const std::string mapPath = (std::filesystem::temp_directory_path() / "raycaster_bench.rcmap").string();
+    for (int mapSize : mapSizes) {
+        const std::vector<uint8_t> map = GenerateMap(mapSize);
+        if (tiled) {
+            const auto start = std::chrono::steady_clock::now();
+            const bool saved = SaveRaycastMap(mapPath.c_str(), map.data(), mapSize, mapSize, 1);
+            const auto saveEnd = std::chrono::steady_clock::now();
+            RaycastMapInfo info = {};
+            if (!saved || !LoadRaycastMap(mapPath.c_str()) || !GetRaycastMapInfo(&info)) {
+                fprintf(stderr, "bench: failed to save and load %s\n", mapPath.c_str());
+                return 1;
+            }
+            const auto loadEnd = std::chrono::steady_clock::now();
+            printf("%-34s %.1f MiB, %d of %d tiles stored, saved in %.1f ms, loaded in %.1f ms\n",
+                ("map" + std::to_string(mapSize) + "/tiled").c_str(),
+                (double)std::filesystem::file_size(mapPath) / (1024.0 * 1024.0), info.storedTiles, info.tileCount,
+                std::chrono::duration<double, std::milli>(saveEnd - start).count(),
+                std::chrono::duration<double, std::milli>(loadEnd - saveEnd).count());
+        }
+        for (const std::pair<int, int>& resolution : resolutions) {
+            RendererConfig config;
+            config.screenWidth = resolution.first;
+            config.screenHeight = resolution.second;
+            config.backend = RENDERER_BACKEND_SOFTWARE;
+            config.workerThreads = threadCounts.empty() ? 1 : threadCounts[0];
+            config.frameReuse = reuse;
+            if (!InitRenderer(config)) {
+                fprintf(stderr, "bench: failed to initialize a %dx%d software renderer\n", resolution.first, resolution.second);
+                return 1;
+            }
+            for (int threads : threadCounts) {
+                for (int path = 0; path < PATH_COUNT; ++path) {
+                    for (int layout = 0; layout < (tiled ? 2 : 1); ++layout) {
+                        // Frames, then the same path as a batch, then as ray sweeps
+                        for (int mode = 0; mode < 3; ++mode) {
+                            if ((mode == 1 && !batch) || (mode == 2 && !rays)) {
+                                continue;
+                            }
+                            const BenchCase c = { mapSize, (CameraPath)path, resolution.first, resolution.second, threads, layout == 1, reuse, mode == 1, mode == 2 };
+                            const BenchResult r = c.batch ? RunBatchCase(c, map, warmup, frames) :
+                                c.rays ? RunRaysCase(c, map, warmup, frames) : RunCase(c, map, warmup, frames);
+                            printf("%-34s %12.3f %12.3f %10.2f %10.2f %10.2f %10.1f\n", CaseName(c).c_str(), r.nsPerFrameMedian * 1e-6,
+                                r.nsPerFrameMin * 1e-6, r.nsPerColumn, r.ddaStepsPerRay, r.allocationsPerFrame, 100.0 * r.reuseRate);
+                            if (c.batch) printf("%-34s %12.0f views/s\n", "", 1e9 / r.nsPerFrameMedian);
+                            if (c.rays) printf("%-34s %12.2f Mrays/s\n", "", 1e3 / r.nsPerColumn);
+                            fflush(stdout);
+                            results.push_back(r);
+                        }
+                    }
+                }
+            }
+            ShutdownRenderer();
+        }
+    }
+    if (tiled) {
+        UnloadRaycastMap();
+        std::error_code error;
+        std::filesystem::remove(mapPath, error);
+    }
+    if (atlas && RunAtlasChurn() > 0) {
+        fprintf(stderr, "bench: the wall atlas ran out of blocks while streaming textures\n");
+        return 1;
+    }
+
+    if (jsonPath != nullptr && !WriteJson(jsonPath, results)) {
+        fprintf(stderr, "bench: cannot write %s\n", jsonPath);
+        return 1;
+    }
+    if (csvPath != nullptr && !WriteCsv(csvPath, results)) {
+        fprintf(stderr, "bench: cannot write %s\n", csvPath);
+        return 1;
+    }
+
+    if (baselinePath != nullptr) {
+        std::map<std::string, BaselineEntry> baseline;
+        if (!ReadBaseline(baselinePath, baseline)) {
+            fprintf(stderr, "bench: cannot read baseline %s\n", baselinePath);
+            return 1;
+        }
+        int regressions = 0;
+        printf("\nAgainst %s (tolerance %.1f%%):\n", baselinePath, tolerance);
+        for (const BenchResult& r : results) {
+            const auto it = baseline.find(CaseName(r.config));
+            if (it == baseline.end()) continue;
+            const double change = 100.0 * (r.nsPerFrameMedian / it->second.nsPerFrameMedian - 1.0);
+            const bool slower = change > tolerance;
+            const bool changed = it->second.checksum != r.checksum;
+            if (slower || changed) {
+                printf("  %-34s %+7.1f%%%s\n", CaseName(r.config).c_str(), change, changed ? "  output changed" : "");
+                ++regressions;
+            }
+        }
+        printf("%d regression(s)\n", regressions);
+        return regressions > 0 ? 1 : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+function [rgba, depth, cellIds, info] = renderBatch(map, poses, width, height, wallColors, ceilingColor, floorColor, options)
+%renderBatch Renders many camera poses at once, without a window.
+%
+%   RGBA = renderBatch(MAP, POSES, WIDTH, HEIGHT) renders one WIDTH x
+%   HEIGHT view per row of POSES, an N x 4 matrix of [x y angle fov] poses
+%   in the 1-based cell coordinates of renderRaycast, and returns them as a
+%   HEIGHT x WIDTH x 4 x N uint8 array. Views are drawn like renderRaycast
+%   (colors, textures and lighting; no sprites) and are spread over the
+%   engine's worker threads, one view per thread at a time, so batches of
+%   at least as many poses as threads use every core.
+%
+%   [RGBA, DEPTH, CELLIDS, INFO] = renderBatch(...) also returns
+%       DEPTH   - HEIGHT x WIDTH x N single: distance along the view
+%                 direction to the wall, floor or ceiling point each pixel
+%                 shows
+%       CELLIDS - HEIGHT x WIDTH x N int32: linear index into MAP of the
+%                 wall cell each pixel shows (MAP(CELLIDS(k)) is its wall
+%                 type), 0 on the floor and ceiling
+%       INFO    - struct with viewCount, width, height, batchMs,
+%                 viewsPerSecond and ddaSteps
+%   Only the outputs asked for are computed.
+%
+%   renderBatch(MAP, POSES, WIDTH, HEIGHT, WALLCOLORS, CEILINGCOLOR,
+%   FLOORCOLOR, CeilingTexture=ID, FloorTexture=ID) uses the colors and
+%   textures of renderRaycast. MAP = [] renders the map held by the engine
+%   (see renderLoadMap).
+%
+%   Needs renderInit (Backend="software" opens no window) but not
+%   renderBeginFrame, and leaves the frame and renderGetStats untouched.
+%   Scratch memory is kept between calls, so repeated batches at one
+%   resolution only allocate their outputs.
+%
+%   Example: renderInit(640, 480, Backend="software");
+%            angles = linspace(0, 2*pi, 360)';
+%            poses = [repmat([5.5 5.5], 360, 1), angles, repmat(pi/3, 360, 1)];
+%            [rgba, depth, ~, info] = renderBatch(map, poses, 160, 120);
+%            fprintf('%.0f views/s\n', info.viewsPerSecond);
+%
+%   See also renderRaycast, renderInit, renderLoadMap.
+
+    arguments
+        map          (:,:) {mustBeNumeric, mustBeReal}
+        poses        (:,4) {mustBeNumeric, mustBeReal}
+        width        (1,1) {mustBeInteger, mustBePositive}
+        height       (1,1) {mustBeInteger, mustBePositive}
+        wallColors   (:,4) {mustBeA(wallColors,'uint8')} = uint8([200 0 0 255; 0 200 0 255; 0 0 200 255; 200 200 200 255])
+        ceilingColor (1,4) {mustBeA(ceilingColor,'uint8')} = uint8([120 120 120 255])
+        floorColor   (1,4) {mustBeA(floorColor,'uint8')} = uint8([80 80 80 255])
+        options.CeilingTexture (1,1) {mustBeNumeric, mustBeNonnegative} = 0
+        options.FloorTexture   (1,1) {mustBeNumeric, mustBeNonnegative} = 0
+    end
+
+    if ~isa(map, 'uint8')
+        map = double(map);
+    end
+
+    rgba = [];
+    depth = [];
+    cellIds = [];
+    info = [];
+    outputs = cell(1, max(nargout, 1));
+    try
+        % Call the MEX function with the 'batch' command
+        [outputs{:}] = renderMex('batch', map, double(poses), double(width), double(height), ...
+                                 wallColors, ceilingColor, floorColor, ...
+                                 double(options.CeilingTexture), double(options.FloorTexture));
+        rgba = outputs{1};
+        if nargout > 1, depth = outputs{2}; end
+        if nargout > 2, cellIds = outputs{3}; end
+        if nargout > 3, info = outputs{4}; end
+    catch ME
+        warning('renderBatch:FailedToCallMEX', ...
+                'Failed to call renderMex function for "batch": %s', ME.message);
+    end
+end
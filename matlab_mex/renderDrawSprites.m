@@ -0,0 +1,42 @@
+function numDrawn = renderDrawSprites(sprites)
+%renderDrawSprites Draws world-space billboard sprites occluded by the walls.
+%
+%   NUMDRAWN = renderDrawSprites(SPRITES) draws every row of SPRITES as a
+%   camera-facing billboard in the view of the last renderRaycast call of
+%   the current frame. Columns where a wall is nearer than the sprite are
+%   hidden. SPRITES is an N x K double matrix (3 <= K <= 9):
+%
+%       [x, y, textureID, scale, verticalOffset, R, G, B, A]
+%
+%   x and y use the same 1-based cell coordinates as the raycast pose.
+%   scale is the height in wall heights (default 1); the width follows the
+%   texture's aspect ratio. verticalOffset raises the centre above eye
+%   level in wall heights (default 0; -(1 - scale)/2 stands the sprite on
+%   the floor). R, G, B, A is the tint (default white). Missing columns use
+%   the defaults.
+%
+%   Sprites behind the camera or off screen are culled and the rest are
+%   drawn far to near, so thousands of sprites cost one MEX call.
+%   Returns the number of sprites with at least one visible column. With
+%   renderInit(..., FramesInFlight=N > 0) the walls are only cast later on
+%   the render thread, so it returns the number left after culling.
+%
+%   Example: renderRaycast(map, pose);
+%            renderDrawSprites([5.5 4.5 barrelTex 0.5 -0.25;
+%                               9.5 7.5 lampTex  1.0  0]);
+%
+%   See also renderRaycast, renderLoadTexture.
+
+    arguments
+        sprites (:,:) {mustBeA(sprites,'double'), mustBeReal}
+    end
+
+    numDrawn = 0;
+    try
+        % Call the MEX function with the 'drawSprites' command
+        numDrawn = renderMex('drawSprites', sprites);
+    catch ME
+        warning('renderDrawSprites:FailedToCallMEX', ...
+                'Failed to call renderMex function for "drawSprites": %s', ME.message);
+    end
+end
@@ -0,0 +1,34 @@
+function stats = renderGetCaptureStats()
+%renderGetCaptureStats Reports the progress of the frame capture.
+%
+%   STATS = renderGetCaptureStats() returns a struct with the fields
+%       active        - true while a capture is running
+%       format        - 'y4m' or 'raw'
+%       width         - frame size, the screen size
+%       height
+%       ringFrames    - frames of buffer
+%       queuedFrames  - frames copied but not written yet
+%       framesWritten - frames on disk
+%       framesDropped - frames skipped because every buffer was still
+%                       waiting for the disk, or after a write failed
+%       bytesWritten  - frame data written (the .y4m header excluded)
+%       writeMs       - time the writer took for the last frame
+%       writeFailed   - true if the file could not be written (disk full)
+%
+%   Once a capture stops, the fields describe it until the next one
+%   starts. Returns [] if the call fails.
+%
+%   Example: s = renderGetCaptureStats();
+%            if s.framesDropped > 0, disp('Disk is falling behind'); end
+%
+%   See also renderStartCapture, renderStopCapture.
+
+    stats = [];
+    try
+        % Call the MEX function with the 'getCaptureStats' command
+        stats = renderMex('getCaptureStats');
+    catch ME
+        warning('renderGetCaptureStats:FailedToCallMEX', ...
+                'Failed to call renderMex function for "getCaptureStats": %s', ME.message);
+    end
+end
@@ -0,0 +1,37 @@
+function stats = renderGetFramePacingStats()
+%renderGetFramePacingStats Reports present timing and input latency.
+%
+%   STATS = renderGetFramePacingStats() returns a struct with the fields
+%       targetFps          - 0 while pacing is off
+%       pollMs             - input check interval while waiting
+%       framesPresented    - frames presented since renderInit
+%       lastPresentTime    - seconds since renderInit of the last present
+%       presentIntervalMs  - time between the last two presents
+%       presentJitterMs    - average distance of the intervals from
+%                            1000 / targetFps
+%       missedSlots        - presents more than half a frame late
+%       predictedWorkMs    - time the pacer allows from renderEndFrame
+%                            returning to the next present
+%       waitMs             - time the last renderEndFrame waited
+%       inputLatencyMs     - from the oldest event renderGetInputEvents
+%                            returned before a renderEndFrame to that
+%                            frame's present; -1 before any
+%       inputEventsQueued  - events waiting for renderGetInputEvents
+%       inputEventsDropped - events lost because the queue was full
+%
+%   Returns [] if the call fails.
+%
+%   Example: s = renderGetFramePacingStats();
+%            fprintf('%.1f ms input to present\n', s.inputLatencyMs);
+%
+%   See also renderSetFramePacing, renderGetInputEvents.
+
+    stats = [];
+    try
+        % Call the MEX function with the 'getFramePacingStats' command
+        stats = renderMex('getFramePacingStats');
+    catch ME
+        warning('renderGetFramePacingStats:FailedToCallMEX', ...
+                'Failed to call renderMex function for "getFramePacingStats": %s', ME.message);
+    end
+end
@@ -0,0 +1,24 @@
+function frame = renderGetFramebuffer()
+%renderGetFramebuffer Returns the software renderer's current frame.
+%
+%   FRAME = renderGetFramebuffer() returns the frame as an H x W x 4 uint8
+%   array [R G B A], ready for image/imshow (use FRAME(:,:,1:3)) or
+%   imwrite. Requires renderInit(..., Backend="software") or
+%   Backend="softwareWindow". Returns [] if the call fails.
+%
+%   Example: renderInit(640, 480, Backend="software");
+%            renderBeginFrame(); renderRaycast(map, pose); renderEndFrame();
+%            frame = renderGetFramebuffer();
+%            imshow(frame(:,:,1:3));
+%
+%   See also renderInit, renderEndFrame.
+
+    frame = [];
+    try
+        % Call the MEX function with the 'getFramebuffer' command
+        frame = renderMex('getFramebuffer');
+    catch ME
+        warning('renderGetFramebuffer:FailedToCallMEX', ...
+                'Failed to call renderMex function for "getFramebuffer": %s', ME.message);
+    end
+end
@@ -0,0 +1,45 @@
+function events = renderGetInputEvents(maxEvents)
+%renderGetInputEvents Returns the keyboard and mouse events since the last call.
+%
+%   EVENTS = renderGetInputEvents() returns every queued input event as an
+%   Nx6 double matrix, oldest first, one row per event:
+%       [time type code x y frameIndex]
+%   time       - seconds since renderInit when the engine saw the change
+%   type       - 0 key down, 1 key up, 2 mouse button down, 3 mouse button
+%                up, 4 mouse move, 5 mouse wheel
+%   code       - raylib key code (double('W') for letters and digits) or
+%                mouse button (0 left, 1 right, 2 middle); 0 otherwise
+%   x, y       - mouse position for buttons and moves, wheel movement for
+%                the wheel; 0 for keys
+%   frameIndex - last frame presented before the change was seen
+%
+%   The engine checks input every time a frame is presented and, with
+%   renderSetFramePacing, every millisecond or so in between, so presses
+%   shorter than a frame are kept. Up to 1024 events are queued; after
+%   that the oldest are dropped. Unlike renderGetInputState, one array is
+%   created per call however many events there are. Only the window
+%   backends produce events.
+%
+%   EVENTS = renderGetInputEvents(MAXEVENTS) returns at most MAXEVENTS
+%   events and leaves the rest queued.
+%
+%   Returns zeros(0, 6) if the call fails.
+%
+%   Example: ev = renderGetInputEvents();
+%            jumped = any(ev(:, 2) == 0 & ev(:, 3) == double(' '));
+%
+%   See also renderGetInputState, renderSetFramePacing, renderGetFramePacingStats.
+
+    arguments
+        maxEvents (1,1) {mustBeNumeric, mustBeNonnegative} = 1024
+    end
+
+    events = zeros(0, 6);
+    try
+        % Call the MEX function with the 'getInputEvents' command
+        events = renderMex('getInputEvents', double(maxEvents));
+    catch ME
+        warning('renderGetInputEvents:FailedToCallMEX', ...
+                'Failed to call renderMex function for "getInputEvents": %s', ME.message);
+    end
+end
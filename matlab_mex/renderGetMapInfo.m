@@ -0,0 +1,21 @@
+function info = renderGetMapInfo()
+%renderGetMapInfo Describes the map loaded by renderLoadMap.
+%
+%   INFO = renderGetMapInfo() returns the struct documented in
+%   renderLoadMap, or [] if no map is loaded or the call fails. The
+%   version field changes whenever the map changes.
+%
+%   Example: info = renderGetMapInfo();
+%            fprintf('%d of %d tiles stored\n', info.storedTiles, info.tileCount);
+%
+%   See also renderLoadMap, renderSetMapCells.
+
+    info = [];
+    try
+        % Call the MEX function with the 'getMapInfo' command
+        info = renderMex('getMapInfo');
+    catch ME
+        warning('renderGetMapInfo:FailedToCallMEX', ...
+                'Failed to call renderMex function for "getMapInfo": %s', ME.message);
+    end
+end
@@ -0,0 +1,33 @@
+function status = renderGetRenderScale()
+%renderGetRenderScale Reports the render scale and how well the budget is met.
+%
+%   STATUS = renderGetRenderScale() returns a struct with the fields
+%       scale          - render scale the next frame will use
+%       viewWidth      - raycast view size at that scale
+%       viewHeight
+%       frameBudgetMs  - budget set by renderSetFrameBudget, 0 if none
+%       minScale       - bounds the scale is kept within
+%       maxScale
+%       smoothedMs     - moving average of the measured render times
+%       withinBudget   - fraction of the last measured frames (up to 120)
+%                        that were at or under the budget
+%       measuredFrames - frames that fraction is taken over
+%
+%   Returns [] if the call fails. The scale of each past frame is in
+%   renderGetStats (renderScale, viewWidth, viewHeight).
+%
+%   Example: s = renderGetRenderScale();
+%            fprintf('%dx%d, %.0f%% of frames within budget\n', ...
+%                    s.viewWidth, s.viewHeight, 100 * s.withinBudget);
+%
+%   See also renderSetFrameBudget, renderSetRenderScale, renderGetStats.
+
+    status = [];
+    try
+        % Call the MEX function with the 'getRenderScale' command
+        status = renderMex('getRenderScale');
+    catch ME
+        warning('renderGetRenderScale:FailedToCallMEX', ...
+                'Failed to call renderMex function for "getRenderScale": %s', ME.message);
+    end
+end
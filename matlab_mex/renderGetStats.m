@@ -0,0 +1,76 @@
+function stats = renderGetStats(numFrames)
+%renderGetStats Returns timers and counters of completed frames.
+%
+%   STATS = renderGetStats() returns a struct for the frame closed by the
+%   most recent renderEndFrame, with the fields
+%       frameIndex     - frame number since renderInit, starting at 1
+%       frameMs        - renderBeginFrame start to renderEndFrame end
+%       beginMs        - renderBeginFrame (clearing the frame)
+%       lightingMs     - renderRaycast: relighting the parts of the
+%                        lightmap whose lights or cells changed
+%       floorMs        - renderRaycast: textured floor and ceiling rows
+%       raycastMs      - renderRaycast: DDA for every screen column
+%       wallMs         - renderRaycast: drawing flat halves and walls
+%       spritesMs      - renderDrawSprites
+%       textMs         - renderDrawText
+%       commandsMs     - renderSubmitFrame
+%       upscaleMs      - stretching a reduced-resolution raycast view to
+%                        the screen (renderSetRenderScale)
+%       presentMs      - renderEndFrame (flushing batches and presenting,
+%                        including any wait for vsync)
+%       waitMs         - FramesInFlight > 0: time MATLAB blocked before
+%                        recording the frame, because the render thread
+%                        was too far behind
+%       drawCalls      - draw calls handed to the GPU (0 for headless
+%                        software frames)
+%       textureBinds   - times consecutive draw calls switched texture
+%       texturedSlices - textured wall slices drawn (renderSubmitFrame
+%                        opcode 4)
+%       batchedQuads   - atlas quads the textured slices and sprites were
+%                        merged into
+%       spritesDrawn   - renderDrawSprites sprites with at least one
+%                        column in front of the walls
+%       ddaSteps       - map cells stepped through by renderRaycast
+%       raysCast       - renderRaycast columns traced through the map
+%       raysReused     - renderRaycast columns taken from the previous
+%                        frame instead (unchanged or only rotated camera)
+%       textureLookups - texels sampled on the CPU
+%       renderScale    - render scale of the raycast view
+%       viewWidth      - columns and rows the raycast view was rendered at
+%       viewHeight
+%       lightChunksRelit - 16x16-cell lightmap chunks relit by
+%                        renderRaycast (renderSetLights)
+%
+%   Timers are in milliseconds, measured inside the engine, so they
+%   exclude MATLAB's own overhead between calls. With FramesInFlight > 0
+%   they time the render thread, and the latest frame lags the one MATLAB
+%   is recording by up to FramesInFlight frames.
+%
+%   STATS = renderGetStats(NUMFRAMES) returns a 1xK struct array of the
+%   last K <= NUMFRAMES frames (the engine keeps 256), oldest first.
+%
+%   Returns [] if the call fails.
+%
+%   Example: s = renderGetStats(120);
+%            fprintf('raycast %.2f ms, walls %.2f ms\n', ...
+%                    mean([s.raycastMs]), mean([s.wallMs]));
+%
+%   See also renderEndFrame, renderWriteTrace.
+
+    arguments
+        numFrames (1,1) {mustBeNumeric, mustBeInteger, mustBePositive} = 1
+    end
+
+    stats = [];
+    try
+        % Call the MEX function with the 'getStats' command
+        if nargin == 0
+            stats = renderMex('getStats');
+        else
+            stats = renderMex('getStats', double(numFrames));
+        end
+    catch ME
+        warning('renderGetStats:FailedToCallMEX', ...
+                'Failed to call renderMex function for "getStats": %s', ME.message);
+    end
+end
@@ -0,0 +1,28 @@
+function status = renderGetTextureStatus(textureIDs)
+%renderGetTextureStatus Reports how far textures have loaded.
+%
+%   STATUS = renderGetTextureStatus(TEXTUREIDS) returns, for each ID in
+%   TEXTUREIDS, one of:
+%       0 - invalid: unknown or unloaded ID, or not an ID at all
+%       1 - pending: queued, decoding, or waiting for renderBeginFrame
+%       2 - ready
+%       3 - failed: the file could not be read or decoded
+%   STATUS has the shape of TEXTUREIDS. Returns [] if the call fails.
+%
+%   Example: ready = all(renderGetTextureStatus(ids) == 2);
+%
+%   See also renderLoadTextures, renderWaitTextures.
+
+    arguments
+        textureIDs {mustBeNumeric, mustBeReal}
+    end
+
+    status = [];
+    try
+        % Call the MEX function with the 'getTextureStatus' command
+        status = renderMex('getTextureStatus', double(textureIDs));
+    catch ME
+        warning('renderGetTextureStatus:FailedToCallMEX', ...
+                'Failed to call renderMex function for "getTextureStatus": %s', ME.message);
+    end
+end
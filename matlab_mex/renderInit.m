@@ -1,26 +1,76 @@
-function success = renderInit(width, height)
+function success = renderInit(width, height, options)
 %renderInit Initializes the custom rendering engine window.
 %
 %   SUCCESS = renderInit(WIDTH, HEIGHT) initializes the renderer with the
 %   specified screen dimensions. Returns true on success, false otherwise.
 %
+%   SUCCESS = renderInit(WIDTH, HEIGHT, Backend=BACKEND) selects where
+%   frames are rendered:
+%       "window"         - GPU rendering into a window (default)
+%       "software"       - CPU framebuffer only, no window or GPU needed.
+%                          Read frames back with renderGetFramebuffer.
+%       "softwareWindow" - CPU framebuffer, shown in a window
+%
+%   SUCCESS = renderInit(..., Threads=N) sets the number of worker threads
+%   used by renderRaycast. 0 (default) uses one per CPU core, 1 keeps all
+%   raycasting on the calling thread. At most 4 per CPU core.
+%
+%   SUCCESS = renderInit(..., FramesInFlight=N) pipelines rendering: with
+%   N > 0 (at most 3) the drawing functions only record the frame, and
+%   renderEndFrame hands it to a render thread that draws it while MATLAB
+%   carries on with the next one, up to N frames ahead. The window is then
+%   owned by the render thread. 0 (default) draws on MATLAB's thread.
+%
+%   SUCCESS = renderInit(..., TextureThreads=N) sets the number of threads
+%   decoding the files queued by renderLoadTextures. 0 (default) uses one
+%   per CPU core. At most 4 per CPU core.
+%
+%   SUCCESS = renderInit(..., FrameReuse=false) makes renderRaycast cast
+%   every column of every frame. By default, a frame drawn from the same
+%   position as the previous one reuses its columns: all of them if the
+%   camera did not move, most of them if it only turned.
+%
+%   SUCCESS = renderInit(..., RenderScale=S) renders the renderRaycast
+%   view at S times the screen size (0.25 to 1, default 1) and stretches
+%   it to the screen; see renderSetRenderScale.
+%
+%   SUCCESS = renderInit(..., FrameBudget=MS, MinRenderScale=LO) starts
+%   with the scale adjusted every frame to keep render times under MS
+%   milliseconds, between LO (default 0.5) and RenderScale; see
+%   renderSetFrameBudget. 0 (default) keeps the scale fixed.
+%
 %   The window title is currently hardcoded as "MATLAB Renderer" in the
 %   MEX file.
 %
-%   See also renderShutdown, renderDrawRect.
+%   See also renderShutdown, renderDrawRect, renderGetFramebuffer.
 
     arguments
         width  (1,1) {mustBeNumeric, mustBeInteger, mustBePositive}
         height (1,1) {mustBeNumeric, mustBeInteger, mustBePositive}
+        options.Backend (1,1) string {mustBeMember(options.Backend, ["window", "software", "softwareWindow"])} = "window"
+        options.Threads (1,1) {mustBeNumeric, mustBeInteger, mustBeNonnegative} = 0
+        options.FramesInFlight (1,1) {mustBeNumeric, mustBeInteger, mustBeInRange(options.FramesInFlight, 0, 3)} = 0
+        options.TextureThreads (1,1) {mustBeNumeric, mustBeInteger, mustBeNonnegative} = 0
+        options.FrameReuse (1,1) logical = true
+        options.RenderScale (1,1) {mustBeNumeric, mustBeInRange(options.RenderScale, 0.25, 1)} = 1
+        options.FrameBudget (1,1) {mustBeNumeric, mustBeNonnegative} = 0
+        options.MinRenderScale (1,1) {mustBeNumeric, mustBeInRange(options.MinRenderScale, 0.25, 1)} = 0.5
     end
 
     try
         % Call the MEX function with the 'init' command
         % Pass arguments as int32, as C int is typically 32-bit
-        success = renderMex('init', int32(width), int32(height));
+        initOptions = struct('backend', char(options.Backend), 'threads', double(options.Threads), ...
+                             'framesInFlight', double(options.FramesInFlight), ...
+                             'textureThreads', double(options.TextureThreads), ...
+                             'frameReuse', options.FrameReuse, ...
+                             'renderScale', double(options.RenderScale), ...
+                             'frameBudget', double(options.FrameBudget), ...
+                             'minRenderScale', double(options.MinRenderScale));
+        success = renderMex('init', int32(width), int32(height), initOptions);
     catch ME
         warning('renderInit:FailedToCallMEX', ...
                 'Failed to call renderMex function for "init": %s', ME.message);
         success = false;
     end
-end
\ No newline at end of file
+end
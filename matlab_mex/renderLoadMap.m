@@ -0,0 +1,52 @@
+function info = renderLoadMap(source)
+%renderLoadMap Loads a map into the engine for renderRaycast([], ...).
+%
+%   INFO = renderLoadMap(FILEPATH) memory-maps a map file written by
+%   renderSaveMap. Only the tile directory is read up front; the cells of
+%   a tile are read from disk the first time a ray reaches them, so very
+%   large maps open in milliseconds.
+%
+%   INFO = renderLoadMap(MAP) hands the engine a map matrix (uint8,
+%   uint16 or double; double maps with values above 255 are kept as
+%   16-bit cells). Unlike renderRaycast(MAP, ...), the map is converted
+%   once instead of on every frame.
+%
+%   INFO is a struct with the fields
+%       width, height - map size in cells
+%       cellBytes     - 1 (uint8 cells) or 2 (uint16 cells)
+%       tileSize      - cells per side of a storage tile
+%       tileCount     - tiles covering the map
+%       storedTiles   - distinct tiles stored (identical tiles are shared)
+%       emptyTiles    - tiles without any wall
+%       memoryMapped  - true if the cells are read from a mapped file
+%       version       - bumped by every load and effective cell edit
+%
+%   The map stays loaded until the next renderLoadMap, also across
+%   renderShutdown and renderInit. Returns [] if the map could not be
+%   loaded; the previous map is then unloaded.
+%
+%   Example: renderSaveMap('level.rcmap', map);
+%            info = renderLoadMap('level.rcmap');
+%            renderRaycast([], [3.5 3.5 0 pi/3]);
+%
+%   See also renderSaveMap, renderSetMapCells, renderGetMapInfo, renderRaycast.
+
+    arguments
+        source (:,:) % File path (char or string) or map matrix
+    end
+
+    if isstring(source)
+        source = char(source);
+    elseif isnumeric(source) && ~isa(source, 'uint8') && ~isa(source, 'uint16')
+        source = double(source);
+    end
+
+    info = [];
+    try
+        % Call the MEX function with the 'loadMap' command
+        info = renderMex('loadMap', source);
+    catch ME
+        warning('renderLoadMap:FailedToCallMEX', ...
+                'Failed to call renderMex function for "loadMap": %s', ME.message);
+    end
+end
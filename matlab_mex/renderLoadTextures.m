@@ -0,0 +1,33 @@
+function textureIDs = renderLoadTextures(filePaths)
+%renderLoadTextures Starts loading several textures in the background.
+%
+%   TEXTUREIDS = renderLoadTextures(FILEPATHS) queues every file in
+%   FILEPATHS (cell array of character vectors, or string array) and
+%   returns at once. TEXTUREIDS has the shape of FILEPATHS and can be used
+%   right away: the files are decoded on background threads and uploaded
+%   at a later renderBeginFrame. Until then a texture draws as the
+%   placeholder set by renderSetTexturePlaceholder, or not at all.
+%
+%   Files that cannot be read are only detected once decoded: their status
+%   becomes failed (see renderGetTextureStatus). An ID of 0 means no ID
+%   was left for that file. Returns [] if the call fails.
+%
+%   Example: ids = renderLoadTextures({'walls/brick.png', 'walls/wood.png'});
+%            renderWaitTextures();   % optional: block until all are ready
+%
+%   See also renderGetTextureStatus, renderWaitTextures,
+%            renderSetTexturePlaceholder, renderLoadTexture.
+
+    arguments
+        filePaths {mustBeText}
+    end
+
+    textureIDs = [];
+    try
+        % Call the MEX function with the 'loadTextures' command
+        textureIDs = renderMex('loadTextures', cellstr(filePaths));
+    catch ME
+        warning('renderLoadTextures:FailedToCallMEX', ...
+                'Failed to call renderMex function for "loadTextures": %s', ME.message);
+    end
+end
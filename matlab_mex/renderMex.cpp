@@ -3,7 +3,10 @@
 // Include raylib.h if needed for types like Color used internally here
 #include "raylib.h"
 #include <string>
+#include <climits>
 #include <cstring> // For strcmp
+#include <thread>
+#include <vector>
 
 // Helper to get Color from MATLAB input (e.g., expecting 1x4 uint8 array [R G B A])
 Color getColorFromMxArray(const mxArray* arr) {
@@ -14,6 +17,283 @@ Color getColorFromMxArray(const mxArray* arr) {
     return Color{rgba[0], rgba[1], rgba[2], rgba[3]};
 }
 
+// Texture IDs arrive as doubles. As in the engine's draw command decoder, only values from 0 to
+// UINT_MAX can be IDs, and they must be whole numbers.
+bool isTextureIdValue(double value) {
+    return value >= 0.0 && value <= (double)UINT_MAX && value == (double)(TextureID)value;
+}
+
+// Scratch buffers for 'raycast', kept between calls so steady-state frames do not allocate
+static std::vector<uint8_t> g_mapScratch;
+static std::vector<Color> g_wallColorScratch;
+// Scratch for 'drawSprites'
+static std::vector<RaycastSprite> g_spriteScratch;
+// Scratch for 'setLights'
+static std::vector<RaycastLight> g_lightScratch;
+// Scratch for 'batch'
+static std::vector<RaycastCamera> g_cameraScratch;
+// Scratch for 'castRays'
+static std::vector<float> g_rayScratch;
+// Scratch for 'getInputEvents', sized for a full ring on first use
+static std::vector<InputEvent> g_inputEventScratch;
+
+// Converts a MATLAB map matrix (rows = y, columns = x) into the engine's row-major uint8 layout.
+// Accepts uint8 or double matrices; any value > 0 is a wall type (clamped to 255).
+const uint8_t* getMapFromMxArray(const mxArray* arr, int* mapW, int* mapH) {
+    if (mxIsComplex(arr) || !(mxIsUint8(arr) || mxIsDouble(arr)) || mxGetNumberOfDimensions(arr) != 2 || mxIsEmpty(arr)) {
+        mexErrMsgIdAndTxt("Renderer:InvalidMap", "Map must be a non-empty 2-D uint8 or double matrix.");
+    }
+    const size_t rows = mxGetM(arr);
+    const size_t cols = mxGetN(arr);
+    g_mapScratch.resize(rows * cols);
+    uint8_t* dst = g_mapScratch.data();
+
+    // MATLAB is column-major: element (y, x) lives at x * rows + y
+    if (mxIsUint8(arr)) {
+        const uint8_t* src = (const uint8_t*)mxGetData(arr);
+        for (size_t x = 0; x < cols; ++x) {
+            for (size_t y = 0; y < rows; ++y) {
+                dst[y * cols + x] = src[x * rows + y];
+            }
+        }
+    }
+    else {
+        const double* src = mxGetPr(arr);
+        for (size_t x = 0; x < cols; ++x) {
+            for (size_t y = 0; y < rows; ++y) {
+                double v = src[x * rows + y];
+                dst[y * cols + x] = (v > 0.0) ? (uint8_t)(v < 255.0 ? v : 255.0) : 0;
+            }
+        }
+    }
+    *mapW = (int)cols;
+    *mapH = (int)rows;
+    return dst;
+}
+
+// Converts a MATLAB map matrix into a row-major cell array for the loaded-map commands.
+// uint8 and uint16 keep their width; double maps are stored as uint16 only if a value exceeds 255.
+const void* getMapCellsFromMxArray(const mxArray* arr, int* mapW, int* mapH, int* cellBytes) {
+    if (mxIsUint8(arr) || (mxIsDouble(arr) && !mxIsComplex(arr) && !mxIsEmpty(arr) && mxGetNumberOfDimensions(arr) == 2)) {
+        bool wide = false;
+        if (mxIsDouble(arr)) {
+            const double* src = mxGetPr(arr);
+            const size_t count = mxGetNumberOfElements(arr);
+            for (size_t i = 0; i < count && !wide; ++i) wide = src[i] > 255.0;
+        }
+        if (!wide) {
+            *cellBytes = 1;
+            return getMapFromMxArray(arr, mapW, mapH);
+        }
+    }
+    if (!(mxIsUint16(arr) || mxIsDouble(arr)) || mxIsComplex(arr) || mxGetNumberOfDimensions(arr) != 2 || mxIsEmpty(arr)) {
+        mexErrMsgIdAndTxt("Renderer:InvalidMap", "Map must be a non-empty 2-D uint8, uint16 or double matrix.");
+    }
+    const size_t rows = mxGetM(arr);
+    const size_t cols = mxGetN(arr);
+    g_mapScratch.resize(rows * cols * sizeof(uint16_t));
+    uint16_t* dst = (uint16_t*)g_mapScratch.data();
+    for (size_t x = 0; x < cols; ++x) {
+        for (size_t y = 0; y < rows; ++y) {
+            if (mxIsUint16(arr)) {
+                dst[y * cols + x] = ((const uint16_t*)mxGetData(arr))[x * rows + y];
+            }
+            else {
+                const double v = mxGetPr(arr)[x * rows + y];
+                dst[y * cols + x] = (v > 0.0) ? (uint16_t)(v < 65535.0 ? v : 65535.0) : 0;
+            }
+        }
+    }
+    *mapW = (int)cols;
+    *mapH = (int)rows;
+    *cellBytes = 2;
+    return dst;
+}
+
+// Engine cell ID y * mapW + x as MATLAB's linear index of map(y, x), -1 as 0. The engine only
+// reports IDs of maps of at most INT32_MAX cells, and the index of such a map fits as well.
+int32_t matlabCellIndex(int32_t cell, int mapW, int mapH) {
+    return (cell < 0) ? 0 : (int32_t)((int64_t)(cell % mapW) * mapH + cell / mapW + 1);
+}
+
+// Describes the loaded map as a scalar struct, or [] when there is none
+mxArray* createMapInfo() {
+    RaycastMapInfo info;
+    if (!GetRaycastMapInfo(&info)) {
+        return mxCreateDoubleMatrix(0, 0, mxREAL);
+    }
+    const char* fields[] = { "width", "height", "cellBytes", "tileSize", "tileCount", "storedTiles", "emptyTiles",
+        "memoryMapped", "version" };
+    mxArray* result = mxCreateStructMatrix(1, 1, sizeof(fields) / sizeof(fields[0]), fields);
+    mxSetField(result, 0, "width", mxCreateDoubleScalar(info.width));
+    mxSetField(result, 0, "height", mxCreateDoubleScalar(info.height));
+    mxSetField(result, 0, "cellBytes", mxCreateDoubleScalar(info.cellBytes));
+    mxSetField(result, 0, "tileSize", mxCreateDoubleScalar(info.tileSize));
+    mxSetField(result, 0, "tileCount", mxCreateDoubleScalar(info.tileCount));
+    mxSetField(result, 0, "storedTiles", mxCreateDoubleScalar(info.storedTiles));
+    mxSetField(result, 0, "emptyTiles", mxCreateDoubleScalar(info.emptyTiles));
+    mxSetField(result, 0, "memoryMapped", mxCreateLogicalScalar(info.memoryMapped));
+    mxSetField(result, 0, "version", mxCreateDoubleScalar((double)info.version));
+    return result;
+}
+
+// Describes a frame capture's counters as a scalar struct
+mxArray* createCaptureStats(const FrameCaptureStats& stats) {
+    const char* fields[] = { "active", "format", "width", "height", "ringFrames", "queuedFrames", "framesWritten",
+        "framesDropped", "bytesWritten", "writeMs", "writeFailed" };
+    mxArray* result = mxCreateStructMatrix(1, 1, sizeof(fields) / sizeof(fields[0]), fields);
+    mxSetField(result, 0, "active", mxCreateLogicalScalar(stats.active));
+    mxSetField(result, 0, "format", mxCreateString(stats.format == FRAME_CAPTURE_RAW ? "raw" : "y4m"));
+    mxSetField(result, 0, "width", mxCreateDoubleScalar(stats.width));
+    mxSetField(result, 0, "height", mxCreateDoubleScalar(stats.height));
+    mxSetField(result, 0, "ringFrames", mxCreateDoubleScalar(stats.ringFrames));
+    mxSetField(result, 0, "queuedFrames", mxCreateDoubleScalar(stats.queuedFrames));
+    mxSetField(result, 0, "framesWritten", mxCreateDoubleScalar((double)stats.framesWritten));
+    mxSetField(result, 0, "framesDropped", mxCreateDoubleScalar((double)stats.framesDropped));
+    mxSetField(result, 0, "bytesWritten", mxCreateDoubleScalar((double)stats.bytesWritten));
+    mxSetField(result, 0, "writeMs", mxCreateDoubleScalar(stats.writeMs));
+    mxSetField(result, 0, "writeFailed", mxCreateLogicalScalar(stats.writeFailed));
+    return result;
+}
+
+// Describes the frame pacer and the input event ring as a scalar struct
+mxArray* createFramePacingStats(const FramePacingStats& stats) {
+    const char* fields[] = { "targetFps", "pollMs", "framesPresented", "lastPresentTime", "presentIntervalMs",
+        "presentJitterMs", "missedSlots", "predictedWorkMs", "waitMs", "inputLatencyMs", "inputEventsQueued", "inputEventsDropped" };
+    mxArray* result = mxCreateStructMatrix(1, 1, sizeof(fields) / sizeof(fields[0]), fields);
+    mxSetField(result, 0, "targetFps", mxCreateDoubleScalar(stats.targetFps));
+    mxSetField(result, 0, "pollMs", mxCreateDoubleScalar(stats.pollMs));
+    mxSetField(result, 0, "framesPresented", mxCreateDoubleScalar((double)stats.framesPresented));
+    mxSetField(result, 0, "lastPresentTime", mxCreateDoubleScalar(stats.lastPresentTime));
+    mxSetField(result, 0, "presentIntervalMs", mxCreateDoubleScalar(stats.presentIntervalMs));
+    mxSetField(result, 0, "presentJitterMs", mxCreateDoubleScalar(stats.presentJitterMs));
+    mxSetField(result, 0, "missedSlots", mxCreateDoubleScalar((double)stats.missedSlots));
+    mxSetField(result, 0, "predictedWorkMs", mxCreateDoubleScalar(stats.predictedWorkMs));
+    mxSetField(result, 0, "waitMs", mxCreateDoubleScalar(stats.waitMs));
+    mxSetField(result, 0, "inputLatencyMs", mxCreateDoubleScalar(stats.inputLatencyMs));
+    mxSetField(result, 0, "inputEventsQueued", mxCreateDoubleScalar(stats.inputEventsQueued));
+    mxSetField(result, 0, "inputEventsDropped", mxCreateDoubleScalar((double)stats.inputEventsDropped));
+    return result;
+}
+
+// Fills 'palette' from the (wallColors, ceilingColor, floorColor[, ceilingTextureId, floorTextureId])
+// arguments shared by 'raycast' and 'batch'; args holds 3 or 5 of them. Errors are reported as
+// Renderer:<command>:WallColors and Renderer:<command>:Textures.
+void getPaletteFromMxArrays(const mxArray* const* args, int count, const char* command, RaycastPalette& palette) {
+    // wallColors: Nx4 uint8, row i is the color of map value i
+    const mxArray* wallArr = args[0];
+    if (!mxIsUint8(wallArr) || (mxGetN(wallArr) != 4 && !mxIsEmpty(wallArr))) {
+        mexErrMsgIdAndTxt((std::string("Renderer:") + command + ":WallColors").c_str(), "wallColors must be an Nx4 uint8 matrix [R G B A].");
+    }
+    const size_t numColors = mxIsEmpty(wallArr) ? 0 : mxGetM(wallArr);
+    const unsigned char* rgba = (const unsigned char*)mxGetData(wallArr);
+    g_wallColorScratch.resize(numColors);
+    for (size_t i = 0; i < numColors; ++i) {
+        g_wallColorScratch[i] = Color{ rgba[i], rgba[numColors + i], rgba[2 * numColors + i], rgba[3 * numColors + i] };
+    }
+
+    palette.wallColors = g_wallColorScratch.data();
+    palette.wallColorCount = (int)numColors;
+    palette.defaultWallColor = Color{ 50, 50, 50, 255 };
+    palette.ceilingColor = getColorFromMxArray(args[1]);
+    palette.floorColor = getColorFromMxArray(args[2]);
+    palette.sideShade = 0.7f;
+    palette.ceilingTexture = 0;
+    palette.floorTexture = 0;
+    if (count == 5) {
+        if (!mxIsNumeric(args[3]) || !mxIsScalar(args[3]) || !isTextureIdValue(mxGetScalar(args[3])) ||
+            !mxIsNumeric(args[4]) || !mxIsScalar(args[4]) || !isTextureIdValue(mxGetScalar(args[4]))) {
+            mexErrMsgIdAndTxt((std::string("Renderer:") + command + ":Textures").c_str(), "Ceiling and floor textures must be scalar texture IDs, non-negative integers (0 = flat color).");
+        }
+        palette.ceilingTexture = (TextureID)mxGetScalar(args[3]);
+        palette.floorTexture = (TextureID)mxGetScalar(args[4]);
+    }
+}
+
+// Upper bound on the thread counts 'init' accepts: four per hardware thread
+int maxInitThreads() {
+    const unsigned int cores = std::thread::hardware_concurrency(); // 0 if unknown
+    return 4 * (int)(cores == 0 ? 16 : (cores < 1024 ? cores : 1024));
+}
+
+// Reads the optional 'init' options struct. Supported fields:
+//   backend: 'window' (default), 'software' (headless) or 'softwareWindow'
+//   threads: worker threads for raycasting (0 = one per core)
+//   framesInFlight: 0 (default) draws on MATLAB's thread, N > 0 pipelines on a render thread
+//   textureThreads: threads decoding loadTextures files (0 = one per core)
+//   frameReuse: false casts every column of every renderRaycast frame
+//   renderScale: initial scale of the renderRaycast view (0.25 to 1)
+//   frameBudget: milliseconds; > 0 lets the scale vary between minRenderScale and renderScale to meet it
+//   minRenderScale: lower bound for frameBudget
+void applyInitOptions(const mxArray* options, RendererConfig& config) {
+    if (!mxIsStruct(options) || mxGetNumberOfElements(options) != 1) {
+        mexErrMsgIdAndTxt("Renderer:Init:Options", "init options must be a scalar struct.");
+    }
+    const mxArray* backend = mxGetField(options, 0, "backend");
+    if (backend != NULL) {
+        char name[32];
+        if (!mxIsChar(backend) || mxGetString(backend, name, sizeof(name)) != 0) {
+            mexErrMsgIdAndTxt("Renderer:Init:Options", "options.backend must be 'window', 'software' or 'softwareWindow'.");
+        }
+        if (strcmp(name, "window") == 0) config.backend = RENDERER_BACKEND_RAYLIB;
+        else if (strcmp(name, "software") == 0) config.backend = RENDERER_BACKEND_SOFTWARE;
+        else if (strcmp(name, "softwareWindow") == 0) config.backend = RENDERER_BACKEND_SOFTWARE_WINDOWED;
+        else mexErrMsgIdAndTxt("Renderer:Init:Options", "Unknown backend '%s'. Use 'window', 'software' or 'softwareWindow'.", name);
+    }
+    const mxArray* threads = mxGetField(options, 0, "threads");
+    if (threads != NULL) {
+        const double count = mxIsNumeric(threads) && mxGetNumberOfElements(threads) == 1 ? mxGetScalar(threads) : -1.0;
+        if (!(count >= 0 && count <= maxInitThreads()) || count != (double)(int)count) {
+            mexErrMsgIdAndTxt("Renderer:Init:Options", "options.threads must be an integer from 0 to %d (0 = one per core).", maxInitThreads());
+        }
+        config.workerThreads = (int)mxGetScalar(threads);
+    }
+    const mxArray* framesInFlight = mxGetField(options, 0, "framesInFlight");
+    if (framesInFlight != NULL) {
+        if (!mxIsNumeric(framesInFlight) || mxGetNumberOfElements(framesInFlight) != 1 || mxGetScalar(framesInFlight) < 0 ||
+            mxGetScalar(framesInFlight) > RENDERER_MAX_FRAMES_IN_FLIGHT) {
+            mexErrMsgIdAndTxt("Renderer:Init:Options", "options.framesInFlight must be a scalar from 0 to %d.", RENDERER_MAX_FRAMES_IN_FLIGHT);
+        }
+        config.framesInFlight = (int)mxGetScalar(framesInFlight);
+    }
+    const mxArray* textureThreads = mxGetField(options, 0, "textureThreads");
+    if (textureThreads != NULL) {
+        const double count = mxIsNumeric(textureThreads) && mxGetNumberOfElements(textureThreads) == 1 ? mxGetScalar(textureThreads) : -1.0;
+        if (!(count >= 0 && count <= maxInitThreads()) || count != (double)(int)count) {
+            mexErrMsgIdAndTxt("Renderer:Init:Options", "options.textureThreads must be an integer from 0 to %d (0 = one per core).", maxInitThreads());
+        }
+        config.textureLoadThreads = (int)mxGetScalar(textureThreads);
+    }
+    const mxArray* frameReuse = mxGetField(options, 0, "frameReuse");
+    if (frameReuse != NULL) {
+        if ((!mxIsLogical(frameReuse) && !mxIsNumeric(frameReuse)) || mxGetNumberOfElements(frameReuse) != 1) {
+            mexErrMsgIdAndTxt("Renderer:Init:Options", "options.frameReuse must be a logical scalar.");
+        }
+        config.frameReuse = mxGetScalar(frameReuse) != 0.0;
+    }
+    const mxArray* renderScale = mxGetField(options, 0, "renderScale");
+    if (renderScale != NULL) {
+        if (!mxIsNumeric(renderScale) || mxGetNumberOfElements(renderScale) != 1 || !(mxGetScalar(renderScale) > 0.0)) {
+            mexErrMsgIdAndTxt("Renderer:Init:Options", "options.renderScale must be a positive scalar (at most 1).");
+        }
+        config.renderScale = (float)mxGetScalar(renderScale);
+    }
+    const mxArray* frameBudget = mxGetField(options, 0, "frameBudget");
+    if (frameBudget != NULL) {
+        if (!mxIsNumeric(frameBudget) || mxGetNumberOfElements(frameBudget) != 1 || mxGetScalar(frameBudget) < 0) {
+            mexErrMsgIdAndTxt("Renderer:Init:Options", "options.frameBudget must be a non-negative scalar in milliseconds (0 = fixed scale).");
+        }
+        config.frameBudgetMs = (float)mxGetScalar(frameBudget);
+    }
+    const mxArray* minRenderScale = mxGetField(options, 0, "minRenderScale");
+    if (minRenderScale != NULL) {
+        if (!mxIsNumeric(minRenderScale) || mxGetNumberOfElements(minRenderScale) != 1 || !(mxGetScalar(minRenderScale) > 0.0)) {
+            mexErrMsgIdAndTxt("Renderer:Init:Options", "options.minRenderScale must be a positive scalar (at most 1).");
+        }
+        config.minRenderScale = (float)mxGetScalar(minRenderScale);
+    }
+}
+
 
 // The gateway function
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
@@ -22,20 +302,56 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
     if (nrhs < 1 || !mxIsChar(prhs[0])) {
         mexErrMsgIdAndTxt("Renderer:InvalidInput", "First argument must be a command string.");
     }
-    char* command = mxArrayToString(prhs[0]);
+    // Copy into a stack buffer: every draw call goes through here, so avoid mxArrayToString's heap allocation
+    char command[64];
+    if (mxGetString(prhs[0], command, sizeof(command)) != 0) {
+        mexErrMsgIdAndTxt("Renderer:UnknownCommand", "Command string is too long.");
+    }
     std::string cmd(command);
-    mxFree(command); // Free memory allocated by mxArrayToString
 
     // --- Dispatch based on command ---
 
+    // Per-frame hot path first
+    if (cmd == "submitFrame") {
+        // Expect: submitFrame(commands), commands is an N x K double or single matrix,
+        // one row per primitive: [opcode, params..., R, G, B, A]
+        if (nrhs != 2 || !(mxIsDouble(prhs[1]) || mxIsSingle(prhs[1])) || mxIsComplex(prhs[1]) || mxGetNumberOfDimensions(prhs[1]) != 2) {
+            mexErrMsgIdAndTxt("Renderer:SubmitFrame:Args", "Usage: submitFrame(commands). commands must be an N x K real double or single matrix.");
+        }
+        const size_t rows = mxGetM(prhs[1]);
+        const size_t cols = mxGetN(prhs[1]);
+        if (rows > 0 && (cols < DRAW_CMD_MIN_FIELDS || cols > DRAW_CMD_MAX_FIELDS)) {
+            mexErrMsgIdAndTxt("Renderer:SubmitFrame:Args", "commands must have %d to %d columns: [opcode, params..., R, G, B, A].",
+                DRAW_CMD_MIN_FIELDS, DRAW_CMD_MAX_FIELDS);
+        }
+
+        // Decoded in place: MATLAB is column-major, so consecutive commands are adjacent and fields are 'rows' apart
+        int drawn = 0;
+        if (mxIsDouble(prhs[1])) {
+            drawn = SubmitDrawCommands((const double*)mxGetData(prhs[1]), (int)rows, (int)cols, 1, rows);
+        }
+        else {
+            drawn = SubmitDrawCommands((const float*)mxGetData(prhs[1]), (int)rows, (int)cols, 1, rows);
+        }
+        if (nlhs > 0) {
+            plhs[0] = mxCreateDoubleScalar((double)drawn);
+        }
+        return;
+    }
+
     if (cmd == "init") {
-        if (nrhs != 3 || !mxIsScalar(prhs[1]) || !mxIsScalar(prhs[2])) {
-             mexErrMsgIdAndTxt("Renderer:Init", "Usage: init(width, height)");
+        if ((nrhs != 3 && nrhs != 4) || !mxIsScalar(prhs[1]) || !mxIsScalar(prhs[2])) {
+             mexErrMsgIdAndTxt("Renderer:Init", "Usage: init(width, height) or init(width, height, options)");
         }
-        int width = (int)mxGetScalar(prhs[1]);
-        int height = (int)mxGetScalar(prhs[2]);
+        RendererConfig config;
+        config.screenWidth = (int)mxGetScalar(prhs[1]);
+        config.screenHeight = (int)mxGetScalar(prhs[2]);
         // Assuming title is fixed or passed differently for simplicity here
-        bool success = InitRenderer(width, height, "MATLAB Renderer");
+        config.windowTitle = "MATLAB Renderer";
+        if (nrhs == 4) {
+            applyInitOptions(prhs[3], config);
+        }
+        bool success = InitRenderer(config);
         if (!success) {
             mexErrMsgIdAndTxt("Renderer:Init", "InitRenderer failed.");
         }
@@ -126,16 +442,77 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
 
      if (cmd == "unloadTexture") {
         // Expect: unloadTexture(textureID)
-        if (nrhs != 2 || !mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1])) {
-             mexErrMsgIdAndTxt("Renderer:UnloadTexture:Args", "Usage: unloadTexture(textureID). textureID must be a numeric scalar.");
+        if (nrhs != 2 || !mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1]) || !isTextureIdValue(mxGetScalar(prhs[1]))) {
+             mexErrMsgIdAndTxt("Renderer:UnloadTexture:Args", "Usage: unloadTexture(textureID). textureID must be a non-negative integer scalar.");
         }
 
         TextureID texID = (TextureID)mxGetScalar(prhs[1]); // Cast from double
-        // Add check for validity? (e.g., texID > 0) depends on C++ function
         UnloadTextureByID(texID); // Make sure UnloadTextureByID exists and is linked
         return; // Done
     }
 
+    if (cmd == "loadTextures") {
+        // Expect: textureIDs = loadTextures(filePaths) -> IDs shaped like the cell array, decoded in the background
+        if (nrhs != 2 || !mxIsCell(prhs[1])) {
+            mexErrMsgIdAndTxt("Renderer:LoadTextures:Args", "Usage: textureIDs = loadTextures({'a.png', 'b.png', ...}). Paths must be a cell array of strings.");
+        }
+        if (nlhs > 1) mexErrMsgIdAndTxt("Renderer:LoadTextures:Outputs", "Too many output arguments for loadTextures.");
+
+        const size_t count = mxGetNumberOfElements(prhs[1]);
+        std::vector<char*> paths(count, nullptr);
+        for (size_t i = 0; i < count; ++i) {
+            const mxArray* path = mxGetCell(prhs[1], i);
+            if (path == NULL || !mxIsChar(path)) {
+                for (char* converted : paths) mxFree(converted);
+                mexErrMsgIdAndTxt("Renderer:LoadTextures:Args", "loadTextures: element %d of the cell array is not a string.", (int)i + 1);
+            }
+            paths[i] = mxArrayToString(path);
+        }
+
+        std::vector<TextureID> ids(count, 0);
+        LoadTexturesAsync(paths.data(), (int)count, ids.data());
+        for (char* path : paths) mxFree(path);
+
+        plhs[0] = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[1]), mxGetDimensions(prhs[1]), mxDOUBLE_CLASS, mxREAL);
+        double* out = mxGetPr(plhs[0]);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = (double)ids[i];
+        }
+        return;
+    }
+
+    if (cmd == "getTextureStatus") {
+        // Expect: status = getTextureStatus(textureIDs) -> 0 invalid, 1 pending, 2 ready, 3 failed, per ID
+        if (nrhs != 2 || !mxIsDouble(prhs[1]) || mxIsComplex(prhs[1])) {
+            mexErrMsgIdAndTxt("Renderer:GetTextureStatus:Args", "Usage: status = getTextureStatus(textureIDs). textureIDs must be a double array.");
+        }
+        const size_t count = mxGetNumberOfElements(prhs[1]);
+        const double* ids = mxGetPr(prhs[1]);
+        plhs[0] = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[1]), mxGetDimensions(prhs[1]), mxDOUBLE_CLASS, mxREAL);
+        double* out = mxGetPr(plhs[0]);
+        for (size_t i = 0; i < count; ++i) {
+            // Values that cannot be IDs are reported as invalid, like unknown IDs
+            out[i] = isTextureIdValue(ids[i]) ? (double)GetTextureLoadStatus((TextureID)ids[i]) : (double)TEXTURE_STATUS_INVALID;
+        }
+        return;
+    }
+
+    if (cmd == "waitTextures") {
+        // Expect: waitTextures() -> blocks until every loadTextures file is decoded and uploaded
+        if (nrhs != 1) mexErrMsgIdAndTxt("Renderer:WaitTextures:Args", "Usage: waitTextures()");
+        WaitForTextureLoads();
+        return;
+    }
+
+    if (cmd == "setTexturePlaceholder") {
+        // Expect: setTexturePlaceholder(textureID) -> drawn in place of pending textures, 0 for none
+        if (nrhs != 2 || !mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1]) || !isTextureIdValue(mxGetScalar(prhs[1]))) {
+            mexErrMsgIdAndTxt("Renderer:SetTexturePlaceholder:Args", "Usage: setTexturePlaceholder(textureID). textureID must be a non-negative integer scalar (0 for none).");
+        }
+        SetTexturePlaceholder((TextureID)mxGetScalar(prhs[1]));
+        return;
+    }
+
      if (cmd == "drawLine") {
         // Expect: drawLine(x1, y1, x2, y2, color)
          if (nrhs != 6 || !mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1]) || !mxIsNumeric(prhs[2]) || !mxIsScalar(prhs[2]) || !mxIsNumeric(prhs[3]) || !mxIsScalar(prhs[3]) || !mxIsNumeric(prhs[4]) || !mxIsScalar(prhs[4])) {
@@ -151,6 +528,523 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
         return; // Done
     }
 
+    if (cmd == "raycast") {
+        // Expect: raycast(map, [x y angle fov]) or raycast(map, pose, wallColors, ceilingColor, floorColor)
+        //         or raycast(map, pose, wallColors, ceilingColor, floorColor, ceilingTextureId, floorTextureId)
+        // map = [] draws the map held by the engine (loadMap)
+        if ((nrhs != 3 && nrhs != 6 && nrhs != 8) || !mxIsDouble(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 4) {
+            mexErrMsgIdAndTxt("Renderer:Raycast:Args", "Usage: raycast(map, [x y angle fov]) or raycast(map, [x y angle fov], wallColors, [R G B A], [R G B A][, ceilingTextureId, floorTextureId])");
+        }
+        const bool useLoadedMap = mxIsEmpty(prhs[1]);
+        int mapW = 0, mapH = 0;
+        const uint8_t* map = useLoadedMap ? NULL : getMapFromMxArray(prhs[1], &mapW, &mapH);
+
+        // Pose uses MATLAB's 1-based cell coordinates (cell map(y, x) spans [x, x+1) x [y, y+1))
+        const double* pose = mxGetPr(prhs[2]);
+        RaycastCamera camera;
+        camera.posX = (float)(pose[0] - 1.0);
+        camera.posY = (float)(pose[1] - 1.0);
+        camera.angle = (float)pose[2];
+        camera.fov = (float)pose[3];
+
+        if (nrhs == 3) {
+            if (useLoadedMap) RenderRaycastFrame(camera, NULL);
+            else RenderRaycastFrame(map, mapW, mapH, camera, NULL);
+            return;
+        }
+
+        RaycastPalette palette;
+        getPaletteFromMxArrays(prhs + 3, nrhs - 3, "Raycast", palette);
+        if (useLoadedMap) RenderRaycastFrame(camera, &palette);
+        else RenderRaycastFrame(map, mapW, mapH, camera, &palette);
+        return;
+    }
+
+    if (cmd == "batch") {
+        // Expect: [rgba, depth, cellIds, info] = batch(map, poses, width, height)
+        //         or batch(map, poses, width, height, wallColors, ceilingColor, floorColor[, ceilingTextureId, floorTextureId])
+        // poses is an N x 4 double matrix of [x y angle fov] rows; map = [] renders the loaded map.
+        // Only the outputs asked for are computed.
+        if ((nrhs != 5 && nrhs != 8 && nrhs != 10) || !mxIsDouble(prhs[2]) || mxIsComplex(prhs[2]) || mxGetN(prhs[2]) != 4 ||
+            !mxIsNumeric(prhs[3]) || !mxIsScalar(prhs[3]) || !(mxGetScalar(prhs[3]) >= 1 && mxGetScalar(prhs[3]) <= INT_MAX) ||
+            !mxIsNumeric(prhs[4]) || !mxIsScalar(prhs[4]) || !(mxGetScalar(prhs[4]) >= 1 && mxGetScalar(prhs[4]) <= INT_MAX)) {
+            mexErrMsgIdAndTxt("Renderer:Batch:Args", "Usage: [rgba, depth, cellIds, info] = batch(map, poses, width, height[, wallColors, [R G B A], [R G B A][, ceilingTextureId, floorTextureId]]). poses must be an N x 4 real double matrix [x y angle fov].");
+        }
+        const bool useLoadedMap = mxIsEmpty(prhs[1]);
+        int mapW = 0, mapH = 0;
+        const uint8_t* map = NULL;
+        if (useLoadedMap) {
+            RaycastMapInfo info;
+            if (!GetRaycastMapInfo(&info)) mexErrMsgIdAndTxt("Renderer:Batch:NoMap", "map = [] requires a map loaded with loadMap or setMap.");
+            mapW = info.width;
+            mapH = info.height;
+        }
+        else {
+            map = getMapFromMxArray(prhs[1], &mapW, &mapH);
+        }
+        if (nlhs > 2 && (int64_t)mapW * mapH > INT32_MAX) {
+            mexErrMsgIdAndTxt("Renderer:Batch:MapTooLarge", "cellIds needs a map of at most %d cells; request fewer outputs.", INT32_MAX);
+        }
+        RaycastPalette palette;
+        if (nrhs > 5) getPaletteFromMxArrays(prhs + 5, nrhs - 5, "Batch", palette);
+
+        // Poses use MATLAB's 1-based cell coordinates, like 'raycast'
+        const size_t viewCount = mxGetM(prhs[2]);
+        if (viewCount > (size_t)INT_MAX) mexErrMsgIdAndTxt("Renderer:Batch:Args", "Too many poses: at most %d per batch.", INT_MAX);
+        const double* poses = mxGetPr(prhs[2]);
+        g_cameraScratch.resize(viewCount);
+        for (size_t i = 0; i < viewCount; ++i) {
+            RaycastCamera& camera = g_cameraScratch[i];
+            camera.posX = (float)(poses[i] - 1.0);
+            camera.posY = (float)(poses[viewCount + i] - 1.0);
+            camera.angle = (float)poses[2 * viewCount + i];
+            camera.fov = (float)poses[3 * viewCount + i];
+        }
+
+        // The engine writes every view straight into the uninitialised MATLAB arrays, in their layout
+        RaycastBatchOutput output = {};
+        output.width = (int)mxGetScalar(prhs[3]);
+        output.height = (int)mxGetScalar(prhs[4]);
+        output.layout = RAYCAST_BATCH_COLUMN_MAJOR;
+        mwSize imageDims[4] = { (mwSize)output.height, (mwSize)output.width, 4, (mwSize)viewCount };
+        mwSize planeDims[3] = { (mwSize)output.height, (mwSize)output.width, (mwSize)viewCount };
+        plhs[0] = mxCreateUninitNumericArray(4, imageDims, mxUINT8_CLASS, mxREAL);
+        output.rgba = (uint8_t*)mxGetData(plhs[0]);
+        if (nlhs > 1) {
+            plhs[1] = mxCreateUninitNumericArray(3, planeDims, mxSINGLE_CLASS, mxREAL);
+            output.depth = (float*)mxGetData(plhs[1]);
+        }
+        if (nlhs > 2) {
+            plhs[2] = mxCreateUninitNumericArray(3, planeDims, mxINT32_CLASS, mxREAL);
+            output.cells = (int32_t*)mxGetData(plhs[2]);
+        }
+        const RaycastPalette* palettePtr = (nrhs > 5) ? &palette : NULL;
+        const int rendered = (viewCount == 0) ? 0 : useLoadedMap ?
+            RenderRaycastBatch(g_cameraScratch.data(), (int)viewCount, palettePtr, &output) :
+            RenderRaycastBatch(map, mapW, mapH, g_cameraScratch.data(), (int)viewCount, palettePtr, &output);
+        if (rendered != (int)viewCount) {
+            mexErrMsgIdAndTxt("Renderer:Batch:Failed", "batch failed: every pose must be finite.");
+        }
+
+        // Cell y * mapW + x becomes MATLAB's linear index of map(y, x), and -1 becomes 0
+        if (output.cells != NULL) {
+            const size_t count = (size_t)output.width * output.height * viewCount;
+            for (size_t i = 0; i < count; ++i) {
+                output.cells[i] = matlabCellIndex(output.cells[i], mapW, mapH);
+            }
+        }
+        if (nlhs > 3) {
+            const RaycastBatchStats stats = GetRaycastBatchStats();
+            const char* fields[] = { "viewCount", "width", "height", "batchMs", "viewsPerSecond", "ddaSteps" };
+            plhs[3] = mxCreateStructMatrix(1, 1, sizeof(fields) / sizeof(fields[0]), fields);
+            mxSetField(plhs[3], 0, "viewCount", mxCreateDoubleScalar(stats.viewCount));
+            mxSetField(plhs[3], 0, "width", mxCreateDoubleScalar(stats.width));
+            mxSetField(plhs[3], 0, "height", mxCreateDoubleScalar(stats.height));
+            mxSetField(plhs[3], 0, "batchMs", mxCreateDoubleScalar(stats.batchMs));
+            mxSetField(plhs[3], 0, "viewsPerSecond", mxCreateDoubleScalar(stats.viewsPerSecond));
+            mxSetField(plhs[3], 0, "ddaSteps", mxCreateDoubleScalar((double)stats.ddaSteps));
+        }
+        return;
+    }
+
+    if (cmd == "castRays") {
+        // Expect: [distances, cellIds, sides, texCoords] = castRays(map, rays)
+        // rays is an N x 3 double matrix of [x y angle] rows or N x 4 of [x y dirX dirY] rows;
+        // map = [] casts against the loaded map. Only the outputs asked for are computed.
+        if (nrhs != 3 || !mxIsDouble(prhs[2]) || mxIsComplex(prhs[2]) || mxGetNumberOfDimensions(prhs[2]) != 2 ||
+            (mxGetN(prhs[2]) != 3 && mxGetN(prhs[2]) != 4 && !mxIsEmpty(prhs[2]))) {
+            mexErrMsgIdAndTxt("Renderer:CastRays:Args", "Usage: [distances, cellIds, sides, texCoords] = castRays(map, rays). rays must be an N x 3 [x y angle] or N x 4 [x y dirX dirY] real double matrix.");
+        }
+        const bool useLoadedMap = mxIsEmpty(prhs[1]);
+        int mapW = 0, mapH = 0;
+        const uint8_t* map = NULL;
+        if (useLoadedMap) {
+            RaycastMapInfo info;
+            if (!GetRaycastMapInfo(&info)) mexErrMsgIdAndTxt("Renderer:CastRays:NoMap", "map = [] requires a map loaded with loadMap or setMap.");
+            mapW = info.width;
+            mapH = info.height;
+        }
+        else {
+            map = getMapFromMxArray(prhs[1], &mapW, &mapH);
+        }
+
+        // Origins use MATLAB's 1-based cell coordinates, like the raycast pose. The copy keeps the
+        // column-major layout, which the engine reads with a field stride of N.
+        const size_t rayCount = mxIsEmpty(prhs[2]) ? 0 : mxGetM(prhs[2]);
+        if (rayCount > (size_t)INT_MAX) mexErrMsgIdAndTxt("Renderer:CastRays:Args", "Too many rays: at most %d per call.", INT_MAX);
+        if (nlhs > 1 && (int64_t)mapW * mapH > INT32_MAX) {
+            mexErrMsgIdAndTxt("Renderer:CastRays:MapTooLarge", "cellIds needs a map of at most %d cells; request fewer outputs.", INT32_MAX);
+        }
+        const int fieldCount = (rayCount == 0) ? 3 : (int)mxGetN(prhs[2]);
+        const double* rays = mxGetPr(prhs[2]);
+        g_rayScratch.resize(rayCount * fieldCount);
+        for (int f = 0; f < fieldCount; ++f) {
+            const double offset = (f < 2) ? 1.0 : 0.0;
+            for (size_t i = 0; i < rayCount; ++i) {
+                g_rayScratch[f * rayCount + i] = (float)(rays[f * rayCount + i] - offset);
+            }
+        }
+
+        RaycastRayOutput output = {};
+        plhs[0] = mxCreateUninitNumericMatrix(rayCount, 1, mxSINGLE_CLASS, mxREAL);
+        output.distances = (float*)mxGetData(plhs[0]);
+        if (nlhs > 1) {
+            plhs[1] = mxCreateUninitNumericMatrix(rayCount, 1, mxINT32_CLASS, mxREAL);
+            output.cells = (int32_t*)mxGetData(plhs[1]);
+        }
+        if (nlhs > 2) {
+            plhs[2] = mxCreateUninitNumericMatrix(rayCount, 1, mxINT8_CLASS, mxREAL);
+            output.sides = (int8_t*)mxGetData(plhs[2]);
+        }
+        if (nlhs > 3) {
+            plhs[3] = mxCreateUninitNumericMatrix(rayCount, 1, mxSINGLE_CLASS, mxREAL);
+            output.texCoords = (float*)mxGetData(plhs[3]);
+        }
+        const int hitCount = useLoadedMap ?
+            CastRaycastRays(g_rayScratch.data(), (int)rayCount, fieldCount, 1, rayCount, &output) :
+            CastRaycastRays(map, mapW, mapH, g_rayScratch.data(), (int)rayCount, fieldCount, 1, rayCount, &output);
+        if (hitCount < 0) {
+            mexErrMsgIdAndTxt("Renderer:CastRays:Failed", "castRays failed, see the renderer log.");
+        }
+
+        // Cell y * mapW + x becomes MATLAB's linear index of map(y, x), and -1 becomes 0
+        if (output.cells != NULL) {
+            for (size_t i = 0; i < rayCount; ++i) {
+                output.cells[i] = matlabCellIndex(output.cells[i], mapW, mapH);
+            }
+        }
+        return;
+    }
+
+    if (cmd == "setMapCells") {
+        // Expect: numSet = setMapCells(cells), cells is an N x 3 double matrix of [x y value] rows
+        // in 1-based map coordinates
+        if (nrhs != 2 || !mxIsDouble(prhs[1]) || mxIsComplex(prhs[1]) || (mxGetN(prhs[1]) != 3 && !mxIsEmpty(prhs[1]))) {
+            mexErrMsgIdAndTxt("Renderer:SetMapCells:Args", "Usage: numSet = setMapCells(cells). cells must be an N x 3 real double matrix [x y value].");
+        }
+        const size_t rows = mxIsEmpty(prhs[1]) ? 0 : mxGetM(prhs[1]);
+        const double* src = mxGetPr(prhs[1]);
+        // Entries that are not whole numbers from 'lowest' to INT_MAX skip the row, like cells outside the map
+        auto isIntFrom = [](double value, double lowest) { return value >= lowest && value <= INT_MAX && value == (double)(int)value; };
+        int numSet = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            const double x = src[i], y = src[rows + i], value = src[2 * rows + i];
+            if (isIntFrom(x, 1.0) && isIntFrom(y, 1.0) && isIntFrom(value, 0.0)) {
+                numSet += SetRaycastMapCell((int)x - 1, (int)y - 1, (int)value) ? 1 : 0;
+            }
+        }
+        if (nlhs > 0) {
+            plhs[0] = mxCreateDoubleScalar((double)numSet);
+        }
+        return;
+    }
+
+    if (cmd == "drawSprites") {
+        // Expect: numDrawn = drawSprites(sprites), sprites is an N x K double matrix (3 <= K <= 9),
+        // one row per sprite: [x, y, textureId, scale, verticalOffset, R, G, B, A]
+        if (nrhs != 2 || !mxIsDouble(prhs[1]) || mxIsComplex(prhs[1]) || mxGetNumberOfDimensions(prhs[1]) != 2) {
+            mexErrMsgIdAndTxt("Renderer:DrawSprites:Args", "Usage: numDrawn = drawSprites(sprites). sprites must be an N x K real double matrix.");
+        }
+        const size_t rows = mxGetM(prhs[1]);
+        const size_t cols = mxGetN(prhs[1]);
+        if (rows > 0 && (cols < 3 || cols > 9)) {
+            mexErrMsgIdAndTxt("Renderer:DrawSprites:Args", "sprites must have 3 to 9 columns: [x, y, textureId, scale, verticalOffset, R, G, B, A].");
+        }
+
+        // Columns not present default to scale 1, no offset and a white tint
+        const double* src = mxGetPr(prhs[1]);
+        auto field = [&](size_t row, size_t col, double fallback) { return (col < cols) ? src[col * rows + row] : fallback; };
+        auto channel = [](double value) { return (unsigned char)(value <= 0.0 ? 0 : (value >= 255.0 ? 255 : value + 0.5)); };
+        g_spriteScratch.resize(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            RaycastSprite& sprite = g_spriteScratch[i];
+            // Positions use MATLAB's 1-based cell coordinates, like the raycast pose
+            sprite.x = (float)(field(i, 0, 0.0) - 1.0);
+            sprite.y = (float)(field(i, 1, 0.0) - 1.0);
+            const double textureId = field(i, 2, 0.0);
+            if (!isTextureIdValue(textureId)) {
+                mexErrMsgIdAndTxt("Renderer:DrawSprites:Args", "Sprite %d: textureId must be a non-negative integer.", (int)i + 1);
+            }
+            sprite.textureId = (TextureID)textureId;
+            sprite.scale = (float)field(i, 3, 1.0);
+            sprite.verticalOffset = (float)field(i, 4, 0.0);
+            sprite.tint = Color{ channel(field(i, 5, 255.0)), channel(field(i, 6, 255.0)), channel(field(i, 7, 255.0)), channel(field(i, 8, 255.0)) };
+        }
+        const int drawn = DrawRaycastSprites(g_spriteScratch.data(), (int)rows);
+        if (nlhs > 0) {
+            plhs[0] = mxCreateDoubleScalar((double)drawn);
+        }
+        return;
+    }
+
+    if (cmd == "setLighting") {
+        // Expect: setLighting(enabled, ambient), ambient is a 1x4 uint8 color [R G B A] (A is ignored)
+        if (nrhs != 3 || !(mxIsNumeric(prhs[1]) || mxIsLogical(prhs[1])) || !mxIsScalar(prhs[1])) {
+            mexErrMsgIdAndTxt("Renderer:SetLighting:Args", "Usage: setLighting(enabled, ambient). enabled must be a scalar, ambient a 1x4 uint8 color.");
+        }
+        const Color ambient = getColorFromMxArray(prhs[2]);
+        SetRaycastLighting(mxGetScalar(prhs[1]) != 0.0, ambient);
+        return;
+    }
+
+    if (cmd == "setLights") {
+        // Expect: setLights(lights), lights is an N x 7 double matrix, one row per light:
+        // [x, y, radius, intensity, R, G, B] with positions in 1-based cell coordinates
+        if (nrhs != 2 || !mxIsDouble(prhs[1]) || mxIsComplex(prhs[1]) || (mxGetN(prhs[1]) != 7 && !mxIsEmpty(prhs[1]))) {
+            mexErrMsgIdAndTxt("Renderer:SetLights:Args", "Usage: setLights(lights). lights must be an N x 7 real double matrix [x y radius intensity R G B].");
+        }
+        const size_t rows = mxIsEmpty(prhs[1]) ? 0 : mxGetM(prhs[1]);
+        const double* src = mxGetPr(prhs[1]);
+        auto channel = [](double value) { return (unsigned char)(value <= 0.0 ? 0 : (value >= 255.0 ? 255 : value + 0.5)); };
+        g_lightScratch.resize(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            RaycastLight& light = g_lightScratch[i];
+            light.x = (float)(src[i] - 1.0);
+            light.y = (float)(src[rows + i] - 1.0);
+            light.radius = (float)src[2 * rows + i];
+            light.intensity = (float)src[3 * rows + i];
+            light.color = Color{ channel(src[4 * rows + i]), channel(src[5 * rows + i]), channel(src[6 * rows + i]), 255 };
+        }
+        SetRaycastLights(g_lightScratch.data(), (int)rows);
+        return;
+    }
+
+    if (cmd == "getFramebuffer") {
+        // Expect: frame = getFramebuffer() -> H x W x 4 uint8 (software backends only)
+        if (nrhs != 1) mexErrMsgIdAndTxt("Renderer:GetFramebuffer:Args", "Usage: frame = getFramebuffer()");
+        int width = 0, height = 0;
+        if (GetFramebuffer(&width, &height) == NULL) {
+            mexErrMsgIdAndTxt("Renderer:GetFramebuffer:Backend", "getFramebuffer requires the 'software' or 'softwareWindow' backend.");
+        }
+        // The engine writes straight into the uninitialised MATLAB array, transposing as it goes,
+        // so this is the only copy of the frame
+        mwSize dims[3] = { (mwSize)height, (mwSize)width, 4 };
+        plhs[0] = mxCreateUninitNumericArray(3, dims, mxUINT8_CLASS, mxREAL);
+        ReadFramebufferPlanar((uint8_t*)mxGetData(plhs[0]));
+        return;
+    }
+
+    if (cmd == "getStats") {
+        // Expect: stats = getStats() -> struct of counters for the last completed frame
+        //         stats = getStats(n) -> 1 x K struct array of the last K <= n frames, oldest first
+        if ((nrhs != 1 && nrhs != 2) || (nrhs == 2 && (!mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1]) || mxGetScalar(prhs[1]) < 1))) {
+            mexErrMsgIdAndTxt("Renderer:GetStats:Args", "Usage: stats = getStats() or stats = getStats(numFrames)");
+        }
+        RendererStats history[RENDERER_STATS_HISTORY];
+        int frames = 1;
+        if (nrhs == 2) {
+            const double requested = mxGetScalar(prhs[1]);
+            frames = GetRendererStatsHistory(history, requested < RENDERER_STATS_HISTORY ? (int)requested : RENDERER_STATS_HISTORY);
+        }
+        else {
+            history[0] = GetRendererStats();
+        }
+
+        const char* fields[] = { "frameIndex", "frameMs", "beginMs", "lightingMs", "floorMs", "raycastMs", "wallMs", "spritesMs", "textMs",
+            "commandsMs", "upscaleMs", "presentMs", "waitMs", "drawCalls", "textureBinds", "texturedSlices", "batchedQuads", "spritesDrawn",
+            "ddaSteps", "raysCast", "raysReused", "textureLookups", "renderScale", "viewWidth", "viewHeight", "lightChunksRelit" };
+        plhs[0] = mxCreateStructMatrix(1, frames, sizeof(fields) / sizeof(fields[0]), fields);
+        for (int i = 0; i < frames; ++i) {
+            const RendererStats& stats = history[i];
+            mxSetField(plhs[0], i, "frameIndex", mxCreateDoubleScalar((double)stats.frameIndex));
+            mxSetField(plhs[0], i, "frameMs", mxCreateDoubleScalar(stats.frameMs));
+            mxSetField(plhs[0], i, "beginMs", mxCreateDoubleScalar(stats.beginMs));
+            mxSetField(plhs[0], i, "lightingMs", mxCreateDoubleScalar(stats.lightingMs));
+            mxSetField(plhs[0], i, "floorMs", mxCreateDoubleScalar(stats.floorMs));
+            mxSetField(plhs[0], i, "raycastMs", mxCreateDoubleScalar(stats.raycastMs));
+            mxSetField(plhs[0], i, "wallMs", mxCreateDoubleScalar(stats.wallMs));
+            mxSetField(plhs[0], i, "spritesMs", mxCreateDoubleScalar(stats.spritesMs));
+            mxSetField(plhs[0], i, "textMs", mxCreateDoubleScalar(stats.textMs));
+            mxSetField(plhs[0], i, "commandsMs", mxCreateDoubleScalar(stats.commandsMs));
+            mxSetField(plhs[0], i, "upscaleMs", mxCreateDoubleScalar(stats.upscaleMs));
+            mxSetField(plhs[0], i, "presentMs", mxCreateDoubleScalar(stats.presentMs));
+            mxSetField(plhs[0], i, "waitMs", mxCreateDoubleScalar(stats.waitMs));
+            mxSetField(plhs[0], i, "drawCalls", mxCreateDoubleScalar(stats.drawCalls));
+            mxSetField(plhs[0], i, "textureBinds", mxCreateDoubleScalar(stats.textureBinds));
+            mxSetField(plhs[0], i, "texturedSlices", mxCreateDoubleScalar(stats.texturedSlices));
+            mxSetField(plhs[0], i, "batchedQuads", mxCreateDoubleScalar(stats.batchedQuads));
+            mxSetField(plhs[0], i, "spritesDrawn", mxCreateDoubleScalar(stats.spritesDrawn));
+            mxSetField(plhs[0], i, "ddaSteps", mxCreateDoubleScalar((double)stats.ddaSteps));
+            mxSetField(plhs[0], i, "raysCast", mxCreateDoubleScalar(stats.raysCast));
+            mxSetField(plhs[0], i, "raysReused", mxCreateDoubleScalar(stats.raysReused));
+            mxSetField(plhs[0], i, "textureLookups", mxCreateDoubleScalar((double)stats.textureLookups));
+            mxSetField(plhs[0], i, "renderScale", mxCreateDoubleScalar(stats.renderScale));
+            mxSetField(plhs[0], i, "viewWidth", mxCreateDoubleScalar(stats.viewWidth));
+            mxSetField(plhs[0], i, "viewHeight", mxCreateDoubleScalar(stats.viewHeight));
+            mxSetField(plhs[0], i, "lightChunksRelit", mxCreateDoubleScalar(stats.lightChunksRelit));
+        }
+        return;
+    }
+
+    if (cmd == "setRenderScale") {
+        // Expect: setRenderScale(scale) -> fixed scale of the renderRaycast view, stops the frame budget
+        if (nrhs != 2 || !mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1]) || !(mxGetScalar(prhs[1]) > 0.0)) {
+            mexErrMsgIdAndTxt("Renderer:SetRenderScale:Args", "Usage: setRenderScale(scale). scale must be a positive scalar (at most 1).");
+        }
+        SetRenderScale((float)mxGetScalar(prhs[1]));
+        return;
+    }
+
+    if (cmd == "setFrameBudget") {
+        // Expect: setFrameBudget(budgetMs, minScale, maxScale) -> budgetMs = 0 keeps the current scale fixed
+        if (nrhs != 4 || !mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1]) || mxGetScalar(prhs[1]) < 0 ||
+            !mxIsNumeric(prhs[2]) || !mxIsScalar(prhs[2]) || !mxIsNumeric(prhs[3]) || !mxIsScalar(prhs[3])) {
+            mexErrMsgIdAndTxt("Renderer:SetFrameBudget:Args", "Usage: setFrameBudget(budgetMs, minScale, maxScale). All must be numeric scalars, budgetMs >= 0.");
+        }
+        SetRenderScaleBudget((float)mxGetScalar(prhs[1]), (float)mxGetScalar(prhs[2]), (float)mxGetScalar(prhs[3]));
+        return;
+    }
+
+    if (cmd == "getRenderScale") {
+        // Expect: status = getRenderScale() -> struct with the scale of the next frame and budget adherence
+        if (nrhs != 1) mexErrMsgIdAndTxt("Renderer:GetRenderScale:Args", "Usage: status = getRenderScale()");
+        const RenderScaleStatus status = GetRenderScaleStatus();
+        const char* fields[] = { "scale", "viewWidth", "viewHeight", "frameBudgetMs", "minScale", "maxScale", "smoothedMs",
+            "withinBudget", "measuredFrames" };
+        plhs[0] = mxCreateStructMatrix(1, 1, sizeof(fields) / sizeof(fields[0]), fields);
+        mxSetField(plhs[0], 0, "scale", mxCreateDoubleScalar(status.scale));
+        mxSetField(plhs[0], 0, "viewWidth", mxCreateDoubleScalar(status.viewWidth));
+        mxSetField(plhs[0], 0, "viewHeight", mxCreateDoubleScalar(status.viewHeight));
+        mxSetField(plhs[0], 0, "frameBudgetMs", mxCreateDoubleScalar(status.frameBudgetMs));
+        mxSetField(plhs[0], 0, "minScale", mxCreateDoubleScalar(status.minScale));
+        mxSetField(plhs[0], 0, "maxScale", mxCreateDoubleScalar(status.maxScale));
+        mxSetField(plhs[0], 0, "smoothedMs", mxCreateDoubleScalar(status.smoothedMs));
+        mxSetField(plhs[0], 0, "withinBudget", mxCreateDoubleScalar(status.withinBudget));
+        mxSetField(plhs[0], 0, "measuredFrames", mxCreateDoubleScalar(status.measuredFrames));
+        return;
+    }
+
+    if (cmd == "writeTrace") {
+        // Expect: success = writeTrace(filePath)
+        if (nrhs != 2 || !mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt("Renderer:WriteTrace:Args", "Usage: success = writeTrace(filePath)");
+        }
+        char* filePath = mxArrayToString(prhs[1]);
+        const bool success = WriteRendererTrace(filePath);
+        mxFree(filePath);
+        plhs[0] = mxCreateLogicalScalar(success);
+        return;
+    }
+
+    if (cmd == "startCapture") {
+        // Expect: success = startCapture(filePath, format, ringFrames, fps) -> format 'y4m' or 'raw'
+        char format[8] = {};
+        if (nrhs != 5 || !mxIsChar(prhs[1]) || !mxIsChar(prhs[2]) || mxGetString(prhs[2], format, sizeof(format)) != 0 ||
+            (strcmp(format, "y4m") != 0 && strcmp(format, "raw") != 0) ||
+            !mxIsNumeric(prhs[3]) || !mxIsScalar(prhs[3]) || !mxIsNumeric(prhs[4]) || !mxIsScalar(prhs[4])) {
+            mexErrMsgIdAndTxt("Renderer:StartCapture:Args", "Usage: success = startCapture(filePath, format, ringFrames, fps). format must be 'y4m' or 'raw'.");
+        }
+        const double ringFrames = mxGetScalar(prhs[3]);
+        const double fps = mxGetScalar(prhs[4]);
+        if (!(ringFrames >= 1 && ringFrames <= RENDERER_CAPTURE_MAX_FRAMES) || !(fps >= 1 && fps <= INT_MAX)) {
+            mexErrMsgIdAndTxt("Renderer:StartCapture:Args", "ringFrames must be from 1 to %d and fps a positive scalar.", RENDERER_CAPTURE_MAX_FRAMES);
+        }
+        char* filePath = mxArrayToString(prhs[1]);
+        const FrameCaptureFormat captureFormat = (strcmp(format, "raw") == 0) ? FRAME_CAPTURE_RAW : FRAME_CAPTURE_Y4M;
+        const bool success = StartFrameCapture(filePath, captureFormat, (int)ringFrames, (int)fps);
+        mxFree(filePath);
+        plhs[0] = mxCreateLogicalScalar(success);
+        return;
+    }
+
+    if (cmd == "stopCapture") {
+        // Expect: stats = stopCapture() -> final counters once every queued frame is written
+        if (nrhs != 1) mexErrMsgIdAndTxt("Renderer:StopCapture:Args", "Usage: stats = stopCapture()");
+        plhs[0] = createCaptureStats(StopFrameCapture());
+        return;
+    }
+
+    if (cmd == "getCaptureStats") {
+        // Expect: stats = getCaptureStats() -> counters of the running or last capture
+        if (nrhs != 1) mexErrMsgIdAndTxt("Renderer:GetCaptureStats:Args", "Usage: stats = getCaptureStats()");
+        plhs[0] = createCaptureStats(GetFrameCaptureStats());
+        return;
+    }
+
+    if (cmd == "getInputEvents") {
+        // Expect: events = getInputEvents() or getInputEvents(maxEvents) -> Nx6 double, one row per
+        // event, oldest first: [time type code x y frameIndex]. One array per call, however many events.
+        if (nrhs > 2 || (nrhs == 2 && (!mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1]) || mxGetScalar(prhs[1]) < 0))) {
+            mexErrMsgIdAndTxt("Renderer:GetInputEvents:Args", "Usage: events = getInputEvents() or getInputEvents(maxEvents). maxEvents must be a non-negative scalar.");
+        }
+        int maxEvents = RENDERER_INPUT_EVENT_CAPACITY;
+        if (nrhs == 2 && mxGetScalar(prhs[1]) < maxEvents) maxEvents = (int)mxGetScalar(prhs[1]);
+        g_inputEventScratch.resize(RENDERER_INPUT_EVENT_CAPACITY);
+        const int count = ReadInputEvents(g_inputEventScratch.data(), maxEvents);
+        plhs[0] = mxCreateUninitNumericMatrix(count, 6, mxDOUBLE_CLASS, mxREAL);
+        double* out = mxGetPr(plhs[0]);
+        for (int i = 0; i < count; ++i) {
+            const InputEvent& event = g_inputEventScratch[i];
+            out[i] = event.time;
+            out[count + i] = (double)event.type;
+            out[2 * count + i] = (double)event.code;
+            out[3 * count + i] = (double)event.x;
+            out[4 * count + i] = (double)event.y;
+            out[5 * count + i] = (double)event.frameIndex;
+        }
+        return;
+    }
+
+    if (cmd == "setFramePacing") {
+        // Expect: setFramePacing(targetFps, pollMs) -> targetFps = 0 turns pacing off
+        if (nrhs != 3 || !mxIsNumeric(prhs[1]) || !mxIsScalar(prhs[1]) || mxGetScalar(prhs[1]) < 0 ||
+            !mxIsNumeric(prhs[2]) || !mxIsScalar(prhs[2]) || mxGetScalar(prhs[2]) < 0) {
+            mexErrMsgIdAndTxt("Renderer:SetFramePacing:Args", "Usage: setFramePacing(targetFps, pollMs). Both must be non-negative scalars.");
+        }
+        SetFramePacing((float)mxGetScalar(prhs[1]), (float)mxGetScalar(prhs[2]));
+        return;
+    }
+
+    if (cmd == "getFramePacingStats") {
+        // Expect: stats = getFramePacingStats() -> present timing, input latency and event ring counters
+        if (nrhs != 1) mexErrMsgIdAndTxt("Renderer:GetFramePacingStats:Args", "Usage: stats = getFramePacingStats()");
+        plhs[0] = createFramePacingStats(GetFramePacingStats());
+        return;
+    }
+
+    if (cmd == "loadMap") {
+        // Expect: info = loadMap(filePath) to memory-map a .rcmap file, or info = loadMap(map) to
+        // hand the engine a map matrix. info is [] if the map could not be loaded.
+        if (nrhs != 2) {
+            mexErrMsgIdAndTxt("Renderer:LoadMap:Args", "Usage: info = loadMap(filePath) or info = loadMap(map)");
+        }
+        if (mxIsChar(prhs[1])) {
+            char* filePath = mxArrayToString(prhs[1]);
+            LoadRaycastMap(filePath);
+            mxFree(filePath);
+        }
+        else {
+            int mapW = 0, mapH = 0, cellBytes = 1;
+            const void* cells = getMapCellsFromMxArray(prhs[1], &mapW, &mapH, &cellBytes);
+            if (!SetRaycastMap(cells, mapW, mapH, cellBytes)) {
+                UnloadRaycastMap();
+            }
+        }
+        plhs[0] = createMapInfo();
+        return;
+    }
+
+    if (cmd == "saveMap") {
+        // Expect: success = saveMap(filePath, map)
+        if (nrhs != 3 || !mxIsChar(prhs[1])) {
+            mexErrMsgIdAndTxt("Renderer:SaveMap:Args", "Usage: success = saveMap(filePath, map)");
+        }
+        int mapW = 0, mapH = 0, cellBytes = 1;
+        const void* cells = getMapCellsFromMxArray(prhs[2], &mapW, &mapH, &cellBytes);
+        char* filePath = mxArrayToString(prhs[1]);
+        const bool success = SaveRaycastMap(filePath, cells, mapW, mapH, cellBytes);
+        mxFree(filePath);
+        plhs[0] = mxCreateLogicalScalar(success);
+        return;
+    }
+
+    if (cmd == "getMapInfo") {
+        // Expect: info = getMapInfo() -> struct describing the loaded map, [] if none
+        if (nrhs != 1) mexErrMsgIdAndTxt("Renderer:GetMapInfo:Args", "Usage: info = getMapInfo()");
+        plhs[0] = createMapInfo();
+        return;
+    }
+
      if (cmd == "getScreenSize") {
         // Expect: [width, height] = getScreenSize()
          if (nrhs != 1) mexErrMsgIdAndTxt("Renderer:GetScreenSize:Args", "Usage: [width, height] = getScreenSize()");
@@ -191,24 +1085,24 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
         mexErrMsgIdAndTxt("Renderer:GetInput:Memory", "Could not create output struct.");
     }
 
-    // --- Poll Raylib Input Functions ---
+    // --- Poll Input (as of the last presented frame, also when pipelined) ---
 
     // Keyboard Movement/Rotation (WASD + Arrows)
-    bool moveFwd = IsKeyDown(KEY_W) || IsKeyDown(KEY_UP);
-    bool moveBwd = IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN);
-    bool rotL = IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT);
-    bool rotR = IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT);
+    bool moveFwd = IsRendererKeyDown(KEY_W) || IsRendererKeyDown(KEY_UP);
+    bool moveBwd = IsRendererKeyDown(KEY_S) || IsRendererKeyDown(KEY_DOWN);
+    bool rotL = IsRendererKeyDown(KEY_A) || IsRendererKeyDown(KEY_LEFT);
+    bool rotR = IsRendererKeyDown(KEY_D) || IsRendererKeyDown(KEY_RIGHT);
     // Add strafe keys if desired (e.g., Q/E)
-    bool strafeL = IsKeyDown(KEY_Q);
-    bool strafeR = IsKeyDown(KEY_E);
+    bool strafeL = IsRendererKeyDown(KEY_Q);
+    bool strafeR = IsRendererKeyDown(KEY_E);
     // Exit Key
-    bool exitReq = IsKeyDown(KEY_ESCAPE);
+    bool exitReq = IsRendererKeyDown(KEY_ESCAPE);
 
     // Mouse
-    Vector2 mousePos = GetMousePosition();
-    bool mouseL = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
-    bool mouseR = IsMouseButtonDown(MOUSE_BUTTON_RIGHT);
-    bool mouseM = IsMouseButtonDown(MOUSE_BUTTON_MIDDLE);
+    Vector2 mousePos = GetRendererMousePosition();
+    bool mouseL = IsRendererMouseButtonDown(MOUSE_BUTTON_LEFT);
+    bool mouseR = IsRendererMouseButtonDown(MOUSE_BUTTON_RIGHT);
+    bool mouseM = IsRendererMouseButtonDown(MOUSE_BUTTON_MIDDLE);
 
     // --- Populate the MATLAB struct ---
     // Use mxSetFieldByNumber for simplicity, field order must match fieldNames
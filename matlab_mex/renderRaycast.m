@@ -0,0 +1,50 @@
+function renderRaycast(map, pose, wallColors, ceilingColor, floorColor)
+%renderRaycast Raycasts and draws a full 3D view of a grid map in one call.
+%
+%   renderRaycast(MAP, POSE) draws ceiling, floor and wall slices for the
+%   whole screen using the engine's built-in colors. MAP is a numeric
+%   matrix where MAP(y, x) == 0 is empty and any positive value is a wall
+%   type. POSE is [x y angle fov] using the same 1-based cell coordinates
+%   as MAP (cell MAP(y, x) covers [x, x+1) x [y, y+1)).
+%
+%   renderRaycast(MAP, POSE, WALLCOLORS, CEILINGCOLOR, FLOORCOLOR) uses
+%   WALLCOLORS (Nx4 uint8, row i is the color of wall type i) and 1x4 uint8
+%   ceiling and floor colors. N/S faces are drawn at 70% brightness.
+%
+%   renderRaycast([], POSE, ...) draws the map held by the engine (see
+%   renderLoadMap) instead of passing one with every call.
+%
+%   renderRaycast(..., CeilingTexture=ID, FloorTexture=ID) textures the
+%   ceiling and/or floor with textures from renderLoadTexture, repeated
+%   once per map cell. 0 (default) keeps the flat color.
+%
+%   Call between renderBeginFrame and renderEndFrame.
+%
+%   Example: renderRaycast(map, [3.5 3.5 pi/4 pi/3], uint8([200 0 0 255]), ...
+%                          uint8([120 120 120 255]), uint8([80 80 80 255]));
+%
+%   See also renderBeginFrame, renderDrawRect, renderLoadTexture, renderLoadMap.
+
+    arguments
+        map          (:,:) {mustBeNumeric, mustBeReal}
+        pose         (1,4) {mustBeNumeric, mustBeReal}
+        wallColors   (:,4) {mustBeA(wallColors,'uint8')} = uint8([200 0 0 255; 0 200 0 255; 0 0 200 255; 200 200 200 255])
+        ceilingColor (1,4) {mustBeA(ceilingColor,'uint8')} = uint8([120 120 120 255])
+        floorColor   (1,4) {mustBeA(floorColor,'uint8')} = uint8([80 80 80 255])
+        options.CeilingTexture (1,1) {mustBeNumeric, mustBeNonnegative} = 0
+        options.FloorTexture   (1,1) {mustBeNumeric, mustBeNonnegative} = 0
+    end
+
+    if ~isa(map, 'uint8')
+        map = double(map);
+    end
+
+    try
+        % Call the MEX function with the 'raycast' command
+        renderMex('raycast', map, double(pose), wallColors, ceilingColor, floorColor, ...
+                  double(options.CeilingTexture), double(options.FloorTexture));
+    catch ME
+        warning('renderRaycast:FailedToCallMEX', ...
+                'Failed to call renderMex function for "raycast": %s', ME.message);
+    end
+end
@@ -0,0 +1,34 @@
+function success = renderSaveMap(filePath, map)
+%renderSaveMap Writes a map matrix to a tiled map file.
+%
+%   SUCCESS = renderSaveMap(FILEPATH, MAP) stores MAP (uint8, uint16 or
+%   double, MAP(y, x) == 0 is empty) in the format read by renderLoadMap.
+%   The map is split into square tiles and identical tiles, such as open
+%   space, are stored once. The file also records which 8x8 cell blocks
+%   are empty so that rays can cross open space in large steps.
+%
+%   Returns true on success, false otherwise. Does not require renderInit.
+%
+%   Example: map = zeros(4096, 'uint8'); map([1 end], :) = 1; map(:, [1 end]) = 1;
+%            renderSaveMap('big.rcmap', map);
+%
+%   See also renderLoadMap.
+
+    arguments
+        filePath (1,:) {mustBeTextScalar} % Path of the map file to write
+        map      (:,:) {mustBeNumeric, mustBeReal}
+    end
+
+    if ~isa(map, 'uint8') && ~isa(map, 'uint16')
+        map = double(map);
+    end
+
+    success = false;
+    try
+        % Call the MEX function with the 'saveMap' command
+        success = renderMex('saveMap', char(filePath), map);
+    catch ME
+        warning('renderSaveMap:FailedToCallMEX', ...
+                'Failed to call renderMex function for "saveMap": %s', ME.message);
+    end
+end
@@ -0,0 +1,34 @@
+function renderSetFrameBudget(budgetMs, options)
+%renderSetFrameBudget Adjusts the render scale to meet a frame time budget.
+%
+%   renderSetFrameBudget(BUDGETMS) picks the render scale of every frame
+%   (see renderSetRenderScale) from the render times of the frames before,
+%   aiming to keep them under BUDGETMS milliseconds. The scale drops at
+%   once when frames are over budget and climbs back a few percent per
+%   frame once there is headroom. Render time is the engine's own work, so
+%   vsync and MATLAB code between draw calls do not count.
+%
+%   renderSetFrameBudget(BUDGETMS, MinScale=LO, MaxScale=HI) keeps the
+%   scale within [LO, HI] (defaults 0.5 and 1).
+%
+%   renderSetFrameBudget(0) stops adjusting and keeps the current scale.
+%
+%   Example: renderSetFrameBudget(8, MinScale=0.4);
+%            s = renderGetRenderScale();
+%
+%   See also renderSetRenderScale, renderGetRenderScale, renderGetStats.
+
+    arguments
+        budgetMs (1,1) {mustBeNumeric, mustBeNonnegative}
+        options.MinScale (1,1) {mustBeNumeric, mustBeInRange(options.MinScale, 0.25, 1)} = 0.5
+        options.MaxScale (1,1) {mustBeNumeric, mustBeInRange(options.MaxScale, 0.25, 1)} = 1
+    end
+
+    try
+        % Call the MEX function with the 'setFrameBudget' command
+        renderMex('setFrameBudget', double(budgetMs), double(options.MinScale), double(options.MaxScale));
+    catch ME
+        warning('renderSetFrameBudget:FailedToCallMEX', ...
+                'Failed to call renderMex function for "setFrameBudget": %s', ME.message);
+    end
+end
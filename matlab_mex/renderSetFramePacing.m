@@ -0,0 +1,34 @@
+function renderSetFramePacing(targetFps, options)
+%renderSetFramePacing Paces presents and reads input as late as possible.
+%
+%   renderSetFramePacing(TARGETFPS) presents at most TARGETFPS frames a
+%   second. Rather than sleeping before each present, renderEndFrame waits
+%   after it until the next frame's work, predicted from the frames before,
+%   is due to finish on the next present slot. Input read after
+%   renderEndFrame returns is then as fresh as possible when the frame
+%   shows. While waiting, input is checked every millisecond and queued
+%   for renderGetInputEvents.
+%
+%   renderSetFramePacing(TARGETFPS, PollMs=MS) checks input every MS
+%   milliseconds while waiting (default 1); 0 checks only at presents.
+%
+%   renderSetFramePacing(0) turns pacing off. renderInit also turns it off.
+%
+%   Example: renderSetFramePacing(60);
+%            s = renderGetFramePacingStats();
+%
+%   See also renderGetFramePacingStats, renderGetInputEvents.
+
+    arguments
+        targetFps (1,1) {mustBeNumeric, mustBeNonnegative}
+        options.PollMs (1,1) {mustBeNumeric, mustBeNonnegative} = 1
+    end
+
+    try
+        % Call the MEX function with the 'setFramePacing' command
+        renderMex('setFramePacing', double(targetFps), double(options.PollMs));
+    catch ME
+        warning('renderSetFramePacing:FailedToCallMEX', ...
+                'Failed to call renderMex function for "setFramePacing": %s', ME.message);
+    end
+end
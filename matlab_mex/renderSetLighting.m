@@ -0,0 +1,30 @@
+function renderSetLighting(enabled, ambient)
+%renderSetLighting Turns lighting of the raycast view on or off.
+%
+%   renderSetLighting(true, AMBIENT) lights walls, floor, ceiling and
+%   sprites drawn by renderRaycast and renderDrawSprites with the lights
+%   set by renderSetLights. Places no light reaches show AMBIENT, a 1x4
+%   uint8 color [R G B A] (A is ignored); uint8([255 255 255 255]) leaves
+%   colors unchanged. Changing AMBIENT relights every stored part of the
+%   lightmap once.
+%
+%   renderSetLighting(false) turns lighting off again (the default).
+%
+%   Example: renderSetLighting(true, uint8([40 40 50 255]));
+%            renderSetLights([5.5 4.5 6 1.2 255 200 120]);
+%
+%   See also renderSetLights, renderRaycast, renderGetStats.
+
+    arguments
+        enabled (1,1) logical
+        ambient (1,4) {mustBeA(ambient,'uint8')} = uint8([255 255 255 255])
+    end
+
+    try
+        % Call the MEX function with the 'setLighting' command
+        renderMex('setLighting', enabled, ambient);
+    catch ME
+        warning('renderSetLighting:FailedToCallMEX', ...
+                'Failed to call renderMex function for "setLighting": %s', ME.message);
+    end
+end
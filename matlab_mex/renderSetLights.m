@@ -0,0 +1,37 @@
+function renderSetLights(lights)
+%renderSetLights Replaces the point lights of the raycast view.
+%
+%   renderSetLights(LIGHTS) sets one light per row of LIGHTS, an N x 7
+%   double matrix:
+%
+%       [x, y, radius, intensity, R, G, B]
+%
+%   x and y use the same 1-based cell coordinates as the raycast pose.
+%   radius is in cells (at most 64); the light fades out at that distance.
+%   intensity 1 gives a wall facing the light at point-blank range the
+%   full color R, G, B (0..255). Walls cast shadows. Lighting must be on,
+%   see renderSetLighting.
+%
+%   Light is cached in a lightmap, so rendering costs the same however many
+%   lights there are. Only lights that differ from the row at the same
+%   index in the previous call are relit, so keep static lights in fixed
+%   rows and move the others. renderSetLights([]) removes every light.
+%
+%   Example: lights = [5.5 4.5 6 1.2 255 200 120;
+%                      20.5 9.5 8 1.0 100 100 255];
+%            renderSetLights(lights);
+%
+%   See also renderSetLighting, renderRaycast, renderGetStats.
+
+    arguments
+        lights (:,:) {mustBeA(lights,'double'), mustBeReal}
+    end
+
+    try
+        % Call the MEX function with the 'setLights' command
+        renderMex('setLights', lights);
+    catch ME
+        warning('renderSetLights:FailedToCallMEX', ...
+                'Failed to call renderMex function for "setLights": %s', ME.message);
+    end
+end
@@ -0,0 +1,28 @@
+function numSet = renderSetMapCells(cells)
+%renderSetMapCells Edits cells of the map loaded by renderLoadMap.
+%
+%   NUMSET = renderSetMapCells(CELLS) sets MAP(y, x) = value for each row
+%   [x y value] of the Nx3 matrix CELLS, in 1-based map coordinates.
+%   Rows outside the map, with entries that are not whole numbers, or
+%   with values that do not fit the map's cell type are skipped. Mapped files are never written: an edited tile is
+%   copied into memory first.
+%
+%   NUMSET is the number of rows applied; returns 0 if the call fails.
+%
+%   Example: renderSetMapCells([10 12 0; 11 12 0]);   % open a door
+%
+%   See also renderLoadMap, renderGetMapInfo.
+
+    arguments
+        cells (:,3) {mustBeNumeric, mustBeReal}
+    end
+
+    numSet = 0;
+    try
+        % Call the MEX function with the 'setMapCells' command
+        numSet = renderMex('setMapCells', double(cells));
+    catch ME
+        warning('renderSetMapCells:FailedToCallMEX', ...
+                'Failed to call renderMex function for "setMapCells": %s', ME.message);
+    end
+end
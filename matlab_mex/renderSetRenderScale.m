@@ -0,0 +1,27 @@
+function renderSetRenderScale(scale)
+%renderSetRenderScale Renders the raycast view at a fraction of the screen size.
+%
+%   renderSetRenderScale(SCALE) draws renderRaycast and renderDrawSprites
+%   at SCALE times the screen width and height (0.25 to 1) and stretches
+%   the result to the full screen before the next other draw or
+%   renderEndFrame. Shapes, text, wall slices and renderSubmitFrame
+%   commands stay at full resolution. Also stops a frame budget set by
+%   renderSetFrameBudget. Call renderDrawSprites right after renderRaycast
+%   while SCALE is below 1.
+%
+%   Example: renderSetRenderScale(0.5); % a quarter of the pixels
+%
+%   See also renderSetFrameBudget, renderGetRenderScale.
+
+    arguments
+        scale (1,1) {mustBeNumeric, mustBePositive, mustBeLessThanOrEqual(scale, 1)}
+    end
+
+    try
+        % Call the MEX function with the 'setRenderScale' command
+        renderMex('setRenderScale', double(scale));
+    catch ME
+        warning('renderSetRenderScale:FailedToCallMEX', ...
+                'Failed to call renderMex function for "setRenderScale": %s', ME.message);
+    end
+end
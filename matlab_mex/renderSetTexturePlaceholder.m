@@ -0,0 +1,24 @@
+function renderSetTexturePlaceholder(textureID)
+%renderSetTexturePlaceholder Sets the texture drawn while others load.
+%
+%   renderSetTexturePlaceholder(TEXTUREID) draws the loaded texture
+%   TEXTUREID wherever a texture from renderLoadTextures is still pending,
+%   in walls, floors, ceilings and sprites alike. 0 (default) draws
+%   pending textures like invalid IDs.
+%
+%   Example: renderSetTexturePlaceholder(renderLoadTexture('loading.png'));
+%
+%   See also renderLoadTextures, renderLoadTexture.
+
+    arguments
+        textureID (1,1) {mustBeNumeric, mustBeInteger, mustBeNonnegative}
+    end
+
+    try
+        % Call the MEX function with the 'setTexturePlaceholder' command
+        renderMex('setTexturePlaceholder', double(textureID));
+    catch ME
+        warning('renderSetTexturePlaceholder:FailedToCallMEX', ...
+                'Failed to call renderMex function for "setTexturePlaceholder": %s', ME.message);
+    end
+end
@@ -0,0 +1,49 @@
+function success = renderStartCapture(filePath, options)
+%renderStartCapture Records every presented frame to a video file.
+%
+%   SUCCESS = renderStartCapture(FILEPATH) writes each frame shown by
+%   renderEndFrame to FILEPATH as YUV4MPEG2 (.y4m) video, which ffmpeg,
+%   VLC and mpv read directly, until renderStopCapture. Frames are copied
+%   into a small ring of buffers and written by a background thread, so
+%   recording does not hold up the render loop. If the disk falls behind
+%   and every buffer is still waiting, new frames are dropped instead;
+%   renderGetCaptureStats counts them. Any capture already running is
+%   stopped first.
+%
+%   SUCCESS = renderStartCapture(..., Format="raw") writes headerless RGBA
+%   frames instead, width x height x 4 bytes each, top row first and
+%   interleaved, readable with fread.
+%
+%   SUCCESS = renderStartCapture(..., RingFrames=N) keeps N frames of
+%   buffer (default 8, at most 256): more absorbs longer disk stalls at the
+%   cost of width x height x 4 bytes each. The ring never exceeds 1 GiB.
+%
+%   SUCCESS = renderStartCapture(..., Fps=F) sets the frame rate written
+%   to the .y4m header (default 30). It does not pace rendering.
+%
+%   Works with every backend, including "software". Returns false if the
+%   renderer is not initialized or the file cannot be created.
+%
+%   Example: renderStartCapture(fullfile(tempdir, 'session.y4m'), Fps=60);
+%            % ... render loop ...
+%            stats = renderStopCapture();
+%
+%   See also renderStopCapture, renderGetCaptureStats, renderGetFramebuffer.
+
+    arguments
+        filePath (1,:) char
+        options.Format (1,1) string {mustBeMember(options.Format, ["y4m", "raw"])} = "y4m"
+        options.RingFrames (1,1) {mustBeNumeric, mustBeInteger, mustBeInRange(options.RingFrames, 1, 256)} = 8
+        options.Fps (1,1) {mustBeNumeric, mustBeInteger, mustBePositive} = 30
+    end
+
+    success = false;
+    try
+        % Call the MEX function with the 'startCapture' command
+        success = renderMex('startCapture', filePath, char(options.Format), ...
+                            double(options.RingFrames), double(options.Fps));
+    catch ME
+        warning('renderStartCapture:FailedToCallMEX', ...
+                'Failed to call renderMex function for "startCapture": %s', ME.message);
+    end
+end
@@ -0,0 +1,25 @@
+function stats = renderStopCapture()
+%renderStopCapture Finishes the recording started by renderStartCapture.
+%
+%   STATS = renderStopCapture() writes the frames still buffered, closes
+%   the file and returns the final counters, as renderGetCaptureStats.
+%   Frames in flight (FramesInFlight > 0) are presented first. Does
+%   nothing if no capture is running. renderShutdown also stops it.
+%
+%   Returns [] if the call fails.
+%
+%   Example: stats = renderStopCapture();
+%            fprintf('%d frames written, %d dropped\n', ...
+%                    stats.framesWritten, stats.framesDropped);
+%
+%   See also renderStartCapture, renderGetCaptureStats.
+
+    stats = [];
+    try
+        % Call the MEX function with the 'stopCapture' command
+        stats = renderMex('stopCapture');
+    catch ME
+        warning('renderStopCapture:FailedToCallMEX', ...
+                'Failed to call renderMex function for "stopCapture": %s', ME.message);
+    end
+end
@@ -0,0 +1,39 @@
+function numDrawn = renderSubmitFrame(commands)
+%renderSubmitFrame Draws a whole frame's primitives from one command table.
+%
+%   NUMDRAWN = renderSubmitFrame(COMMANDS) executes every row of COMMANDS
+%   with a single MEX call. COMMANDS is an N x K double or single matrix
+%   (9 <= K <= 11) with one primitive per row:
+%
+%       [opcode, p1, ..., pN, R, G, B, A]
+%
+%   The last four columns are always the color (0-255). Parameters not
+%   present in the table read as 0. Opcodes:
+%       0  no-op
+%       1  rectangle       x, y, width, height
+%       2  line            x1, y1, x2, y2
+%       3  wall slice      screenX, drawStartY, drawEndY
+%       4  textured slice  screenX, drawStartY, drawEndY, drawWidth, textureID, texCoordX
+%                          (needs K = 11, color is the tint)
+%
+%   Returns the number of primitives drawn.
+%
+%   Example: cmds = [1, 0, 0, 800, 300, 120 120 120 255;   % ceiling
+%                    1, 0, 300, 800, 300, 80 80 80 255];   % floor
+%            renderSubmitFrame(cmds);
+%
+%   See also renderDrawRect, renderDrawLine, renderRaycast.
+
+    arguments
+        commands (:,:) {mustBeFloat, mustBeReal}
+    end
+
+    numDrawn = 0;
+    try
+        % Call the MEX function with the 'submitFrame' command
+        numDrawn = renderMex('submitFrame', commands);
+    catch ME
+        warning('renderSubmitFrame:FailedToCallMEX', ...
+                'Failed to call renderMex function for "submitFrame": %s', ME.message);
+    end
+end
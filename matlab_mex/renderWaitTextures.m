@@ -0,0 +1,17 @@
+function renderWaitTextures()
+%renderWaitTextures Blocks until background texture loads finish.
+%
+%   renderWaitTextures() waits until every file queued by
+%   renderLoadTextures is decoded, then uploads them all, so their status
+%   is ready (or failed) without waiting for the next renderBeginFrame.
+%
+%   See also renderLoadTextures, renderGetTextureStatus.
+
+    try
+        % Call the MEX function with the 'waitTextures' command
+        renderMex('waitTextures');
+    catch ME
+        warning('renderWaitTextures:FailedToCallMEX', ...
+                'Failed to call renderMex function for "waitTextures": %s', ME.message);
+    end
+end
@@ -0,0 +1,28 @@
+function success = renderWriteTrace(filePath)
+%renderWriteTrace Saves the recent frames' stage timings as a Chrome trace.
+%
+%   SUCCESS = renderWriteTrace(FILEPATH) writes the last 256 completed
+%   frames to FILEPATH as Chrome trace JSON: one span per frame and per
+%   stage (begin, floor, raycast, walls, sprites, text, commands, present)
+%   plus per-frame draw and work counters. Open the file in
+%   chrome://tracing or https://ui.perfetto.dev.
+%
+%   Returns true on success, false if the file cannot be written.
+%
+%   Example: renderWriteTrace(fullfile(tempdir, 'frames.json'));
+%
+%   See also renderGetStats.
+
+    arguments
+        filePath (1,:) char
+    end
+
+    success = false;
+    try
+        % Call the MEX function with the 'writeTrace' command
+        success = renderMex('writeTrace', filePath);
+    catch ME
+        warning('renderWriteTrace:FailedToCallMEX', ...
+                'Failed to call renderMex function for "writeTrace": %s', ME.message);
+    end
+end
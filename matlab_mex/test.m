@@ -40,10 +40,7 @@ function runRaycasterDemo()
     colorWall2 = uint8([0, 200, 0, 255]);   % Green
     colorWall3 = uint8([0, 0, 200, 255]);   % Blue
     colorWall4 = uint8([200, 200, 200, 255]); % Gray
-    colorWallNS1 = uint8([140, 0, 0, 255]); % Darker Red (N/S Walls)
-    colorWallNS2 = uint8([0, 140, 0, 255]); % Darker Green
-    colorWallNS3 = uint8([0, 0, 140, 255]); % Darker Blue
-    colorWallNS4 = uint8([140, 140, 140, 255]);% Darker Gray
+    wallColors = [colorWall1; colorWall2; colorWall3; colorWall4]; % Row i = wall type i (N/S sides shaded by the engine)
     colorFloor = uint8([80, 80, 80, 255]);    % Dark Gray
     colorCeiling = uint8([120, 120, 120, 255]);% Lighter Gray
     colorText = uint8([0, 255, 0, 255]);    % Green
@@ -129,70 +126,8 @@ function runRaycasterDemo()
         % -- Rendering --
         renderBeginFrame();
 
-        % Floor and Ceiling
-        renderDrawRect(0, 0, screenWidth, screenHeight/2, colorCeiling);
-        renderDrawRect(0, screenHeight/2, screenWidth, screenHeight/2, colorFloor);
-
-        % Raycasting Loop (Full DDA logic included for completeness)
-        for x = 1:screenWidth
-            % Calculate ray properties
-            cameraX = 2 * (x-1) / (screenWidth - 1) - 1;
-            rayDirX = cos(playerA) - sin(playerA) * cameraX * tan(fov/2);
-            rayDirY = sin(playerA) + cos(playerA) * cameraX * tan(fov/2);
-
-            % Map position and deltas
-            mapX = floor(playerX); mapY = floor(playerY);
-            deltaDistX = abs(1 / rayDirX) + 1e-10; deltaDistY = abs(1 / rayDirY) + 1e-10;
-
-            % Step and initial side distances
-            hit = false; side = 0; perpWallDist = 0;
-            if (rayDirX < 0), stepX = -1; sideDistX = (playerX - mapX) * deltaDistX; else stepX = 1; sideDistX = (mapX + 1.0 - playerX) * deltaDistX; end
-            if (rayDirY < 0), stepY = -1; sideDistY = (playerY - mapY) * deltaDistY; else stepY = 1; sideDistY = (mapY + 1.0 - playerY) * deltaDistY; end
-
-            % Digital Differential Analyzer (DDA)
-            while (~hit)
-                if (sideDistX < sideDistY)
-                    sideDistX = sideDistX + deltaDistX; mapX = mapX + stepX; side = 0;
-                else
-                    sideDistY = sideDistY + deltaDistY; mapY = mapY + stepY; side = 1;
-                end
-                % Check bounds or wall hit
-                if mapX < 1 || mapX > mapWidth || mapY < 1 || mapY > mapHeight
-                    hit = true; perpWallDist = 1e6; % Hit boundary, treat as far
-                elseif map(mapY, mapX) > 0 % Check map data for wall
-                    hit = true;
-                end
-            end % End DDA
-
-            % Calculate distance (correcting fisheye if wall hit)
-            if (hit && perpWallDist < 1e5)
-                if (side == 0)
-                    perpWallDist = (mapX - playerX + (1 - stepX) / 2.0) / rayDirX;
-                else
-                    perpWallDist = (mapY - playerY + (1 - stepY) / 2.0) / rayDirY;
-                end
-            end
-            if perpWallDist <= 0.1, perpWallDist = 0.1; end % Clamp distance
-
-            % Calculate wall slice properties
-            lineHeight = floor(screenHeight / perpWallDist);
-            drawStart = max(0, -lineHeight / 2 + screenHeight / 2);
-            drawEnd = min(screenHeight - 1, lineHeight / 2 + screenHeight / 2);
-
-            % Determine wall color and shading
-            wallType = 0;
-            if mapX >= 1 && mapX <= mapWidth && mapY >= 1 && mapY <= mapHeight
-                 wallType = map(mapY, mapX);
-            end
-            wallColor = Mux(wallType == 1, Mux(side==1, colorWallNS1, colorWall1), ...
-                        Mux(wallType == 2, Mux(side==1, colorWallNS2, colorWall2), ...
-                        Mux(wallType == 3, Mux(side==1, colorWallNS3, colorWall3), ...
-                        Mux(wallType == 4, Mux(side==1, colorWallNS4, colorWall4), uint8([50 50 50 255]))))); % Default dark grey
-
-            % Draw the wall slice using renderDrawRect
-            renderDrawRect(x-1, floor(drawStart), 1, floor(drawEnd) - floor(drawStart) + 1, wallColor);
-
-        end % end raycasting loop (for x)
+        % Floor, ceiling and walls are raycast natively in one MEX call
+        renderRaycast(map, [playerX, playerY, playerA, fov], wallColors, colorCeiling, colorFloor);
 
         % Draw FPS/Info/Mouse Text
         if deltaTime > 0, fps = 1.0 / deltaTime; fpsString = sprintf('FPS: %.1f', fps); end
@@ -212,15 +147,6 @@ function runRaycasterDemo()
     renderShutdown();
     disp('Raycaster Demo finished.');
 
-% --- Helper function Mux ---
-    function result = Mux(condition, value_if_true, value_if_false)
-        if condition
-            result = value_if_true;
-        else
-            result = value_if_false;
-        end
-    end
-
 end % function runRaycasterDemo
 
 runRaycasterDemo()
\ No newline at end of file